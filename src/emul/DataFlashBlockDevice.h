@@ -1,5 +1,11 @@
+#pragma once
 #include <cstddef>
 #include <iterator>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #define FLASH_BLOCK_SIZE 1024
 #define FLASH_TOTAL_SIZE 8192
@@ -8,27 +14,46 @@
 class DataFlashBlockDevice {
 public:
 
+    ///access statistics (emulator only)
+    struct Stats {
+        unsigned long reads = 0;
+        unsigned long read_bytes = 0;
+        unsigned long programs = 0;
+        unsigned long program_bytes = 0;
+        unsigned long erases = 0;
+    };
+
     DataFlashBlockDevice() {
-        std::fill(std::begin(_data), std::end(_data), '\xFF');
+        std::fill(std::begin(_ram), std::end(_ram), '\xFF');
+    }
+
+    ~DataFlashBlockDevice() {
+        close_image();
     }
 
+    DataFlashBlockDevice(const DataFlashBlockDevice &) = delete;
+    DataFlashBlockDevice &operator=(const DataFlashBlockDevice &) = delete;
+
     static constexpr std::size_t get_erase_size() {return 1024;}
 
     int program(const void *buffer, std::size_t addr, std::size_t size) {
+        ++_stats.programs;
+        _stats.program_bytes += size;
         std::copy(reinterpret_cast<const char *>(buffer),
                 reinterpret_cast<const char *>(buffer)+size,
-                reinterpret_cast<char *>(_data)+addr);
+                _data+addr);
         return 0;
     }
     int read(void *buffer, std::size_t addr, std::size_t size) {
+        ++_stats.reads;
+        _stats.read_bytes += size;
         std::copy(_data+addr, _data+addr+size, reinterpret_cast<char *>(buffer));
         return 0;
     }
 
     int erase(std::size_t addr, std::size_t size) {
-        std::fill(reinterpret_cast<char *>(_data+addr),
-                reinterpret_cast<char *>(_data+addr)+size,
-                '\xFF');
+        ++_stats.erases;
+        std::fill(_data+addr, _data+addr+size, '\xFF');
 
         return 0;
     }
@@ -38,6 +63,93 @@ public:
         return inst;
     }
 
-    char _data[8192];
-};
+    const Stats &get_stats() const {return _stats;}
+
+    ///Back the flash by an image file (emulator only)
+    /**
+     * The file is mapped to memory, so every program and erase goes
+     * directly to the image and the content survives the end of the emulator.
+     *
+     * @param path path to the image. If the file doesn't exist (persistent
+     * mode only), it is created in erased state. A shorter file is extended
+     * by erased bytes
+     * @param copy_on_write the image is mapped privately. The emulator starts
+     * from the content of the image, but changes are never written back, so
+     * the same image can be used by many runs
+     * @retval true success
+     * @retval false failed to open or map the file. The device keeps
+     * its current content
+     *
+     * @note must be called before the storage is mounted
+     */
+    bool open_image(const char *path, bool copy_on_write) {
+        int fd = ::open(path, copy_on_write?O_RDONLY|O_CLOEXEC:O_RDWR|O_CREAT|O_CLOEXEC, 0666);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) < 0) {
+            ::close(fd);
+            return false;
+        }
+        auto cur_size = static_cast<std::size_t>(st.st_size);
+        if (copy_on_write && cur_size < FLASH_TOTAL_SIZE) {
+            //short snapshot can't be mapped privately (access past end of file),
+            //load it to RAM instead
+            char buff[FLASH_TOTAL_SIZE];
+            std::fill(std::begin(buff), std::end(buff), '\xFF');
+            auto r = ::read(fd, buff, cur_size);
+            ::close(fd);
+            if (r != static_cast<ssize_t>(cur_size)) return false;
+            close_image();
+            std::copy(std::begin(buff), std::end(buff), _ram);
+            return true;
+        }
+        if (cur_size < FLASH_TOTAL_SIZE && ::ftruncate(fd, FLASH_TOTAL_SIZE) < 0) {
+            ::close(fd);
+            return false;
+        }
+        void *p = ::mmap(nullptr, FLASH_TOTAL_SIZE, PROT_READ|PROT_WRITE,
+                copy_on_write?MAP_PRIVATE:MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        close_image();
+        _data = static_cast<char *>(p);
+        _mapped = true;
+        //extended part of the file is zero - erase it
+        if (cur_size < FLASH_TOTAL_SIZE) std::fill(_data+cur_size, _data+FLASH_TOTAL_SIZE, '\xFF');
+        return true;
+    }
+
+    ///Save current content of the flash to a file (emulator only)
+    /**
+     * @param path target file. The file can be used later by open_image()
+     * @retval true saved
+     * @retval false failed to write
+     */
+    bool save_image(const char *path) const {
+        int fd = ::open(path, O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, 0666);
+        if (fd < 0) return false;
+        std::size_t done = 0;
+        while (done < FLASH_TOTAL_SIZE) {
+            auto r = ::write(fd, _data+done, FLASH_TOTAL_SIZE-done);
+            if (r <= 0) break;
+            done += r;
+        }
+        return ::close(fd) == 0 && done == FLASH_TOTAL_SIZE;
+    }
 
+    ///Detach image file, the current content stays in RAM
+    void close_image() {
+        if (!_mapped) return;
+        std::copy(_data, _data+FLASH_TOTAL_SIZE, _ram);
+        ::msync(_data, FLASH_TOTAL_SIZE, MS_SYNC);
+        ::munmap(_data, FLASH_TOTAL_SIZE);
+        _data = _ram;
+        _mapped = false;
+    }
+
+protected:
+    char _ram[FLASH_TOTAL_SIZE];
+    char *_data = _ram;
+    bool _mapped = false;
+    Stats _stats = {};
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+//AT commands of the modem (same names as in WiFiS3 library), used by
+//the ESP32 stand-in (esp32_sim.cpp)
+
+#define _AT                       "AT"
+#define _ENDL                     "\r\n"
+#define _GETSTATUS                "+GETSTATUS"
+#define _GETRSSI                  "+GETRSSI"
+#define _IPSTA                    "+IPSTA"
+#define _GETDNS                   "+GETDNS"
+#define _UDPBEGIN                 "+UDPBEGIN"
+#define _UDPBEGINPACKETIP         "+UDPBEGINPACKETIP"
+#define _UDPBEGINPACKETNAME       "+UDPBEGINPACKETNAME"
+#define _UDPWRITE                 "+UDPWRITE"
+#define _UDPENDPACKET             "+UDPENDPACKET"
+#define _UDPPARSE                 "+UDPPARSE"
+#define _UDPREAD                  "+UDPREAD"
+#define _UDPSTOP                  "+UDPSTOP"
+
+#define CMD(x)                    _AT x _ENDL
+#define CMD_WRITE(x)              _AT x "="
+#define CMD_READ(x)               _AT x "?" _ENDL
+#define PROMPT(x)                 x ":"
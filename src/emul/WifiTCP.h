@@ -2,9 +2,12 @@
 #include "wifi/TCPClient.h"
 #include "wifi/TCPServer.h"
 #include "WiFiS3.h"
+#include "esp32_sim.h"
 
 #include <vector>
 
+///UART connected to the modem (used by asynchronous driver)
+using ModemUart = Esp32Sim;
 
 struct WiFiUtils {
 
@@ -0,0 +1,195 @@
+//Benchmark of HttpServer receive path
+//
+//Runs the server on the loopback (emulated WiFi) and measures requests per
+//second and CPU time of the server thread per request. Clients send
+//requests back to back (pipelined), so the result is bound by the server
+//
+//usage: bench_http [requests]
+
+#include <Arduino.h>
+#include "../kotel/http_server.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+
+static const auto start_time = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_time).count());
+}
+
+using BenchServer = kotel::HttpServer<4096,32,3>;
+
+static constexpr int bench_port = 8090;
+
+static double thread_cpu_time() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int connect_server() {
+    int s = ::socket(AF_INET, SOCK_STREAM|SOCK_CLOEXEC, IPPROTO_TCP);
+    sockaddr_in sin = {};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(bench_port);
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    while (::connect(s, reinterpret_cast<const sockaddr *>(&sin), sizeof(sin)) < 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    int opt = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    return s;
+}
+
+static void send_all(int s, std::string_view data) {
+    while (!data.empty()) {
+        auto r = ::send(s, data.data(), data.size(), 0);
+        if (r <= 0) return;
+        data = data.substr(r);
+    }
+}
+
+///read response of known size
+static bool recv_exact(int s, std::size_t size) {
+    char buff[4096];
+    while (size) {
+        auto r = ::recv(s, buff, std::min(size, sizeof(buff)), 0);
+        if (r <= 0) return false;
+        size -= r;
+    }
+    return true;
+}
+
+static std::string http_request(std::size_t body_size) {
+    std::string body(body_size, 'x');
+    std::string req = body_size?"POST /api/bench HTTP/1.1\r\n":"GET /api/bench HTTP/1.1\r\n";
+    req.append("Host: 192.168.1.10\r\n"
+               "Connection: keep-alive\r\n"
+               "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/126.0.0.0 Safari/537.36\r\n"
+               "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+               "Accept-Encoding: gzip, deflate\r\n"
+               "Accept-Language: cs-CZ,cs;q=0.9,en;q=0.8\r\n"
+               "Cache-Control: no-cache\r\n");
+    if (body_size) {
+        req.append("Content-Type: application/octet-stream\r\n");
+        req.append("Content-Length: ").append(std::to_string(body_size)).append("\r\n");
+    }
+    req.append("\r\n").append(body);
+    return req;
+}
+
+static std::string ws_frame(std::size_t payload_size) {
+    std::string frame;
+    frame.push_back(static_cast<char>(0x82));
+    if (payload_size < 126) {
+        frame.push_back(static_cast<char>(0x80 | payload_size));
+    } else {
+        frame.push_back(static_cast<char>(0x80 | 126));
+        frame.push_back(static_cast<char>(payload_size >> 8));
+        frame.push_back(static_cast<char>(payload_size & 0xFF));
+    }
+    const char mask[4] = {0x12, 0x34, 0x56, 0x78};
+    frame.append(mask, 4);
+    for (std::size_t i = 0; i < payload_size; ++i) {
+        frame.push_back(static_cast<char>('a' + i % 26) ^ mask[i & 3]);
+    }
+    return frame;
+}
+
+//fixed response of the server, client reads it by size
+static constexpr std::string_view http_response_body = "OK";
+static constexpr std::size_t ws_response_size = 2 + 2;  //header + "ok"
+
+static std::size_t http_response_size() {
+    return std::strlen("HTTP/1.1 200 OK\r\n"
+                       "Content-Type: text/plain;charset=utf-8\r\n"
+                       "Content-Length: 2\r\n\r\n") + http_response_body.size();
+}
+
+struct BenchResult {
+    unsigned long requests = 0;
+    double wall = 0;
+    double cpu = 0;
+};
+
+static BenchResult run_case(BenchServer &server, const std::string &request, std::size_t response_size,
+        unsigned int clients, unsigned long count) {
+    std::atomic<unsigned int> finished = 0;
+    std::vector<std::thread> thr;
+    for (unsigned int i = 0; i < clients; ++i) {
+        thr.emplace_back([&, per_client = count / clients]{
+            int s = connect_server();
+            //requests are sent back to back, so the server is never waiting
+            //for the network round trip
+            std::thread wr([&]{
+                for (unsigned long j = 0; j < per_client; ++j) send_all(s, request);
+            });
+            recv_exact(s, per_client * response_size);
+            wr.join();
+            ::close(s);
+            ++finished;
+        });
+    }
+    BenchResult res;
+    auto t1 = std::chrono::steady_clock::now();
+    double c1 = thread_cpu_time();
+    while (finished != clients) {
+        auto req = server.get_request();
+        if (!req.client) continue;
+        ++res.requests;
+        if (req.request_line.method == kotel::HttpMethod::WS) {
+            server.send_ws_message(req, ws::Message{"ok", ws::Type::binary});
+        } else {
+            server.send_file(req, kotel::HttpServerBase::ContentType::text, http_response_body);
+        }
+    }
+    res.cpu = thread_cpu_time() - c1;
+    res.wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+    for (auto &t: thr) t.join();
+    return res;
+}
+
+int main(int argc, char **argv) {
+    unsigned long count = argc > 1?std::strtoul(argv[1], nullptr, 10):20000;
+    BenchServer server(bench_port);
+    server.begin();
+
+    struct Case {
+        const char *name;
+        std::string request;
+        std::size_t response_size;
+    };
+    Case cases[] = {
+            {"GET (browser headers)", http_request(0), http_response_size()},
+            {"POST 512B body", http_request(512), http_response_size()},
+            {"WS 100B message", ws_frame(100), ws_response_size},
+            {"WS 1KB message", ws_frame(1024), ws_response_size},
+    };
+    for (const auto &c: cases) {
+        for (unsigned int clients: {1U, 3U}) {
+            auto r = run_case(server, c.request, c.response_size, clients, count);
+            std::cout << std::left << std::setw(24) << c.name
+                      << " clients=" << clients
+                      << " requests=" << r.requests
+                      << std::fixed << std::setprecision(0)
+                      << " req/s=" << r.requests / r.wall
+                      << std::setprecision(2)
+                      << " cpu/req=" << r.cpu * 1e6 / std::max(r.requests, 1UL) << "us"
+                      << std::endl;
+        }
+    }
+    server.end();
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include "simul_matrix.h"
 #include "temp_sim.h"
 #include "serial_emul.h"
+#include "DataFlashBlockDevice.h"
 
 #include "pipe_reader.h"
 #include <filesystem>
@@ -84,6 +85,9 @@ struct Command {
         clear_error,
         keyboard,
         extkeyboard,
+        onewire,
+        flashstats,
+        flashsave,
         unknown
     };
     unsigned long timestamp = 0;
@@ -102,6 +106,9 @@ constexpr std::pair<Command::Type, std::string_view> command_str_map[] = {
         {Command::reset,"reset"},
         {Command::keyboard,"keyboard"},
         {Command::extkeyboard,"extkeyboard"},
+        {Command::onewire,"onewire"},
+        {Command::flashstats,"flashstats"},
+        {Command::flashsave,"flashsave"},
         {Command::clear_error, "clear_error"},
         {Command::motor_high_temp_on,"motor_high_temp"},
         {Command::motor_high_temp_off,"motor_norm_temp"},
@@ -196,15 +203,39 @@ void process_command(const Command &cmd) {
         case Command::serial:
             uart_input(cmd.arg);
             break;
+        case Command::onewire:
+            if (!onewire_config(cmd.arg)) {
+                std::cerr << "ERROR: Failed update onewire: " << cmd.arg << std::endl;
+            }
+            break;
+        case Command::flashstats: {
+            const auto &st = DataFlashBlockDevice::getInstance().get_stats();
+            log_line("Flash: reads=", st.reads, " read_bytes=", st.read_bytes,
+                    " programs=", st.programs, " program_bytes=", st.program_bytes,
+                    " erases=", st.erases);
+        }break;
+        case Command::flashsave:
+            if (DataFlashBlockDevice::getInstance().save_image(cmd.arg.c_str())) {
+                log_line("Flash: saved to ", cmd.arg);
+            } else {
+                std::cerr << "ERROR: Failed to save flash image: " << cmd.arg << std::endl;
+            }
+            break;
         case Command::wifi:
             if (cmd.arg == "0") simul_wifi_set_state(false);
             else simul_wifi_set_state(true);
             break;
-        case Command::reset:
+        case Command::reset: {
             std::destroy_at(&kotel::controller);
             new(&kotel::controller) kotel::Controller;
+            auto st = DataFlashBlockDevice::getInstance().get_stats();
             kotel::controller.begin();
-            break;
+            const auto &st2 = DataFlashBlockDevice::getInstance().get_stats();
+            log_line("Flash: mount reads=", st2.reads - st.reads,
+                    " read_bytes=", st2.read_bytes - st.read_bytes,
+                    " programs=", st2.programs - st.programs,
+                    " erases=", st2.erases - st.erases);
+        }break;
         default:break;
     }
 }
@@ -233,19 +264,40 @@ int main(int argc, char **argv) {
     www_path = bin_dir.parent_path().parent_path()/"www";
 
 
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <script file> <simspeed>" << std::endl;
+    //options
+    const char *flash_image = nullptr;
+    bool flash_cow = false;
+    int arg = 1;
+    while (arg + 1 < argc && argv[arg][0] == '-') {
+        std::string_view opt(argv[arg]);
+        if (opt == "--flash") flash_cow = false;
+        else if (opt == "--flash-snapshot") flash_cow = true;
+        else break;
+        flash_image = argv[arg+1];
+        arg += 2;
+    }
+
+    if (arg >= argc) {
+        std::cerr << "Usage: " << argv[0] << " [--flash <image>|--flash-snapshot <image>] <script file> <simspeed>" << std::endl
+                  << std::endl
+                  << "--flash <image>          flash is stored in the image file (created when missing)" << std::endl
+                  << "--flash-snapshot <image> flash starts from the image, changes are not written back" << std::endl;
         return 1;
     }
 
-    std::ifstream f(argv[1]);
+    std::ifstream f(argv[arg]);
     if (!f) {
-        std::cerr << "Failed to open: " << argv[1] << std::endl;
+        std::cerr << "Failed to open: " << argv[arg] << std::endl;
+        return 2;
+    }
+
+    if (flash_image && !DataFlashBlockDevice::getInstance().open_image(flash_image, flash_cow)) {
+        std::cerr << "Failed to open flash image: " << flash_image << std::endl;
         return 2;
     }
 
-    if (argc > 2) {
-        simspeed = std::strtod(argv[2],nullptr);
+    if (arg + 1 < argc) {
+        simspeed = std::strtod(argv[arg+1],nullptr);
         if (simspeed <= 0) {
             std::cerr << "Invalid speed: " << simspeed;
         }
@@ -278,6 +330,10 @@ int main(int argc, char **argv) {
         if (!str.empty()) {
             log_line("Serial: ", str);
         }
+        auto owr = onewire_report();
+        if (!owr.empty()) {
+            log_line("OneWire: ", owr);
+        }
         std::this_thread::sleep_until(now+std::chrono::milliseconds(1));
     }
 }
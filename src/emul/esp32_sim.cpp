@@ -0,0 +1,234 @@
+#include "esp32_sim.h"
+#include "WiFiCommands.h"
+#include "WiFiS3.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+unsigned long millis();
+
+namespace {
+
+struct SimSocket {
+    UDPClientBase client;
+    bool used = false;
+    IPAddress ip;
+    std::string host;
+    uint16_t port = 0;
+    std::string packet;
+    std::string rx;
+    std::size_t rx_pos = 0;
+};
+
+std::vector<SimSocket> sockets(4);
+
+SimSocket *get_socket(int s) {
+    if (s < 0 || s >= static_cast<int>(sockets.size()) || !sockets[s].used) return nullptr;
+    return &sockets[s];
+}
+
+///split arguments separated by comma
+std::vector<std::string_view> split_args(std::string_view args) {
+    std::vector<std::string_view> out;
+    while (true) {
+        auto pos = args.find(',');
+        out.push_back(args.substr(0, pos));
+        if (pos == args.npos) break;
+        args = args.substr(pos+1);
+    }
+    return out;
+}
+
+int to_int(std::string_view v) {
+    return std::atoi(std::string(v).c_str());
+}
+
+std::string ip_to_string(IPAddress ip) {
+    char buff[20];
+    std::snprintf(buff, sizeof(buff), "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
+    return buff;
+}
+
+IPAddress ip_from_string(std::string_view txt) {
+    int p[4] = {};
+    std::sscanf(std::string(txt).c_str(), "%d.%d.%d.%d", p, p+1, p+2, p+3);
+    return IPAddress(p[0], p[1], p[2], p[3]);
+}
+
+}
+
+Esp32Sim &modem_uart() {
+    static Esp32Sim sim;
+    return sim;
+}
+
+int Esp32Sim::available() {
+    if (_replies.empty() || _replies.front().ready_at > millis()) return 0;
+    return static_cast<int>(_replies.front().data.size() - _reply_pos);
+}
+
+int Esp32Sim::read() {
+    if (!available()) return -1;
+    auto &r = _replies.front();
+    int c = static_cast<unsigned char>(r.data[_reply_pos++]);
+    if (_reply_pos >= r.data.size()) {
+        _replies.pop_front();
+        _reply_pos = 0;
+    }
+    return c;
+}
+
+std::size_t Esp32Sim::write(const uint8_t *data, std::size_t size) {
+    for (std::size_t i = 0; i < size; ++i) {
+        char c = static_cast<char>(data[i]);
+        if (_raw_remain) {
+            auto s = get_socket(_raw_sock);
+            if (s) s->packet.push_back(c);
+            if (--_raw_remain == 0) reply_ok();
+            continue;
+        }
+        _line.push_back(c);
+        if (c == '\n') {
+            execute(_line);
+            _line.clear();
+        }
+    }
+    return size;
+}
+
+void Esp32Sim::push(std::string data) {
+    unsigned long ready = millis() + _latency;
+    //replies are ordered
+    if (!_replies.empty() && _replies.back().ready_at > ready) ready = _replies.back().ready_at;
+    _replies.push_back({ready, std::move(data)});
+}
+
+void Esp32Sim::reply(std::string_view prompt, std::string_view value) {
+    std::string r(prompt);
+    r.append(value);
+    r.append("\r\nOK\r\n");
+    push(std::move(r));
+}
+
+void Esp32Sim::reply_binary(std::string_view prompt, std::string_view data) {
+    std::string r(prompt);
+    r.append(std::to_string(data.size()));
+    r.push_back('|');
+    r.append(data);
+    r.append("\r\nOK\r\n");
+    push(std::move(r));
+}
+
+void Esp32Sim::reply_ok() {
+    push("OK\r\n");
+}
+
+void Esp32Sim::reply_error() {
+    push("ERROR\r\n");
+}
+
+void Esp32Sim::execute(std::string_view line) {
+    ++_commands;
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) line = line.substr(0, line.size()-1);
+    if (line.substr(0,2) != _AT) {
+        reply_error();
+        return;
+    }
+    line = line.substr(2);
+    auto sep = line.find_first_of("=?");
+    std::string_view cmd = line.substr(0, sep);
+    std::string_view args = sep == line.npos?std::string_view():line.substr(sep+1);
+    auto a = split_args(args);
+
+    if (cmd == _GETSTATUS) {
+        reply(PROMPT(_GETSTATUS), std::to_string(WiFi.status()));
+    } else if (cmd == _GETRSSI) {
+        reply(PROMPT(_GETRSSI), std::to_string(WiFi.RSSI()));
+    } else if (cmd == _IPSTA) {
+        reply(PROMPT(_IPSTA), ip_to_string(WiFi.localIP()));
+    } else if (cmd == _GETDNS) {
+        reply(PROMPT(_GETDNS), ip_to_string(WiFi.dnsIP(to_int(a[0]))));
+    } else if (cmd == _UDPBEGIN) {
+        for (std::size_t i = 0; i < sockets.size(); ++i) {
+            auto &s = sockets[i];
+            if (!s.used) {
+                if (s.client.open(static_cast<uint16_t>(to_int(a[0]))) != 0) break;
+                s.used = true;
+                s.packet.clear();
+                s.rx.clear();
+                s.rx_pos = 0;
+                reply(PROMPT(_UDPBEGIN), std::to_string(i));
+                return;
+            }
+        }
+        reply_error();
+    } else if (cmd == _UDPBEGINPACKETIP || cmd == _UDPBEGINPACKETNAME) {
+        auto s = a.size() == 3?get_socket(to_int(a[0])):nullptr;
+        if (!s) {
+            reply_error();
+            return;
+        }
+        s->port = static_cast<uint16_t>(to_int(a[1]));
+        if (cmd == _UDPBEGINPACKETIP) {
+            s->ip = ip_from_string(a[2]);
+            s->host.clear();
+        } else {
+            s->host = a[2];
+        }
+        s->packet.clear();
+        reply_ok();
+    } else if (cmd == _UDPWRITE) {
+        auto s = a.size() == 2?get_socket(to_int(a[0])):nullptr;
+        int sz = a.size() == 2?to_int(a[1]):0;
+        if (!s || sz <= 0) {
+            reply_error();
+            return;
+        }
+        _raw_sock = to_int(a[0]);
+        _raw_remain = sz;
+    } else if (cmd == _UDPENDPACKET) {
+        auto s = get_socket(to_int(a[0]));
+        if (!s) {
+            reply_error();
+            return;
+        }
+        int r = s->host.empty()?s->client.send(s->ip, s->port, s->packet)
+                               :s->client.send(s->host.c_str(), s->port, s->packet);
+        s->packet.clear();
+        if (r < 0) reply_error();
+        else reply_ok();
+    } else if (cmd == _UDPPARSE) {
+        auto s = get_socket(to_int(a[0]));
+        if (!s) {
+            reply_error();
+            return;
+        }
+        char buff[1500];
+        auto r = s->client.receive(buff, sizeof(buff));
+        if (r == static_cast<std::size_t>(-1)) r = 0;
+        s->rx.assign(buff, r);
+        s->rx_pos = 0;
+        reply(PROMPT(_UDPPARSE), std::to_string(r));
+    } else if (cmd == _UDPREAD) {
+        auto s = a.size() == 2?get_socket(to_int(a[0])):nullptr;
+        if (!s) {
+            reply_error();
+            return;
+        }
+        std::size_t sz = std::min<std::size_t>(to_int(a[1]), s->rx.size() - s->rx_pos);
+        reply_binary(PROMPT(_UDPREAD), std::string_view(s->rx).substr(s->rx_pos, sz));
+        s->rx_pos += sz;
+    } else if (cmd == _UDPSTOP) {
+        auto s = get_socket(to_int(a[0]));
+        if (!s) {
+            reply_error();
+            return;
+        }
+        s->client.close();
+        s->used = false;
+        reply_ok();
+    } else {
+        reply_error();
+    }
+}
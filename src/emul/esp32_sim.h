@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+
+///Stand-in for the ESP32 modem of the UNO R4 WiFi
+/**
+ * Behaves as the UART connected to the modem. It executes AT commands
+ * used by the asynchronous modem driver - Wi-Fi status and UDP sockets
+ * (over sockets of the host). Replies are delayed to simulate latency
+ * of the modem
+ */
+class Esp32Sim {
+public:
+
+    int available();
+    int read();
+    std::size_t write(const uint8_t *data, std::size_t size);
+    std::size_t write(uint8_t c) {return write(&c, 1);}
+
+    ///set latency of replies in milliseconds
+    void set_latency(unsigned int ms) {_latency = ms;}
+    ///count of executed commands
+    unsigned long get_command_count() const {return _commands;}
+
+protected:
+
+    struct Reply {
+        unsigned long ready_at;
+        std::string data;
+    };
+
+    std::string _line;
+    std::deque<Reply> _replies;
+    std::size_t _reply_pos = 0;
+    ///remaining raw data of UDPWRITE
+    std::size_t _raw_remain = 0;
+    int _raw_sock = -1;
+    unsigned int _latency = 5;
+    unsigned long _commands = 0;
+
+    void execute(std::string_view line);
+    void reply(std::string_view prompt, std::string_view value);
+    void reply_binary(std::string_view prompt, std::string_view data);
+    void reply_ok();
+    void reply_error();
+    void push(std::string data);
+};
+
+///UART of the modem
+Esp32Sim &modem_uart();
@@ -0,0 +1,253 @@
+#include "onewire_sim.h"
+
+#include <algorithm>
+#include <cmath>
+
+DS18B20Sim::DS18B20Sim(const Address &rom)
+    :_rom(rom)
+    ,_scratchpad{0x50, 0x05, 0, 0, 0, 0xFF, 0x0C, 0x10, 0}
+    ,_rnd(rom[1] | (rom[2] << 8)) {
+    std::copy(_eeprom.begin(), _eeprom.end(), _scratchpad.begin()+2);
+    update_scratchpad_crc();
+}
+
+uint8_t DS18B20Sim::crc8(const uint8_t *data, unsigned int len) {
+    uint8_t crc = 0;
+    while (len--) {
+        uint8_t inbyte = *data++;
+        for (uint8_t i = 8; i; i--) {
+            uint8_t mix = (crc ^ inbyte) & 0x01;
+            crc >>= 1;
+            if (mix) crc ^= 0x8C;
+            inbyte >>= 1;
+        }
+    }
+    return crc;
+}
+
+DS18B20Sim::Address DS18B20Sim::make_rom(std::array<uint8_t, 6> serial) {
+    Address a = {0x28};
+    std::copy(serial.begin(), serial.end(), a.begin()+1);
+    a[7] = crc8(a.data(), 7);
+    return a;
+}
+
+void DS18B20Sim::update_scratchpad_crc() {
+    _scratchpad[8] = crc8(_scratchpad.data(), 8);
+}
+
+void DS18B20Sim::reset() {
+    start_receive(Phase::rom_command, 8);
+}
+
+void DS18B20Sim::update_conversion() {
+    if (!_converting || static_cast<long>(_now_ms - _conversion_end) < 0) return;
+    _converting = false;
+    unsigned int drop_bits = 3 - ((_scratchpad[4] >> 5) & 0x3);
+    float t = std::clamp(_temp, -55.0f, 125.0f);
+    int16_t raw = static_cast<int16_t>(std::lround(t * 16.0f));
+    raw &= ~((1 << drop_bits) - 1);
+    _scratchpad[0] = static_cast<uint8_t>(raw & 0xFF);
+    _scratchpad[1] = static_cast<uint8_t>((raw >> 8) & 0xFF);
+    update_scratchpad_crc();
+}
+
+bool DS18B20Sim::has_alarm() const {
+    int16_t raw = static_cast<int16_t>(_scratchpad[0] | (_scratchpad[1] << 8));
+    int t = raw >> 4;
+    return t >= static_cast<int8_t>(_scratchpad[2]) || t <= static_cast<int8_t>(_scratchpad[3]);
+}
+
+void DS18B20Sim::start_transmit(const uint8_t *data, unsigned int bytes) {
+    std::copy(data, data+bytes, _buffer.begin());
+    _phase = Phase::transmit;
+    _bit_pos = 0;
+    _bit_count = bytes * 8;
+}
+
+void DS18B20Sim::start_receive(Phase phase, unsigned int bits) {
+    _buffer = {};
+    _phase = phase;
+    _bit_pos = 0;
+    _bit_count = bits;
+}
+
+bool DS18B20Sim::get_tx_bit() const {
+    switch (_phase) {
+        case Phase::search_bit: return get_rom_bit(_bit_pos);
+        case Phase::search_cmp: return !get_rom_bit(_bit_pos);
+        case Phase::convert: return !_converting;
+        case Phase::transmit:
+            if (_bit_pos >= _bit_count) return true;
+            return (_buffer[_bit_pos >> 3] >> (_bit_pos & 7)) & 1;
+        default: return true;
+    }
+}
+
+void DS18B20Sim::on_master_low(unsigned long now, unsigned long now_ms) {
+    _now_ms = now_ms;
+    _fall_time = now;
+    if (faults.not_present) return;
+    update_conversion();
+    switch (_phase) {
+        case Phase::search_bit:
+        case Phase::search_cmp:
+        case Phase::transmit:
+        case Phase::convert: {
+            bool bit = get_tx_bit();
+            if (faults.bit_error_rate > 0
+                    && std::uniform_real_distribution<double>(0.0, 1.0)(_rnd) < faults.bit_error_rate) {
+                bit = !bit;
+            }
+            if (!bit) {
+                _low_from = now;
+                _low_until = now + timing.tx_zero_len;
+            }
+        } break;
+        default:
+            break;
+    }
+}
+
+void DS18B20Sim::on_master_release(unsigned long now, unsigned long now_ms) {
+    _now_ms = now_ms;
+    if (faults.not_present) return;
+    unsigned long len = now - _fall_time;
+    if (len >= timing.reset_threshold) {
+        reset();
+        _low_from = now + timing.presence_wait;
+        _low_until = _low_from + timing.presence_len;
+        return;
+    }
+    switch (_phase) {
+        case Phase::idle:
+        case Phase::convert:
+            break;
+        case Phase::search_bit:
+            _phase = Phase::search_cmp;
+            break;
+        case Phase::search_cmp:
+            _phase = Phase::search_dir;
+            break;
+        case Phase::transmit:
+            if (_bit_pos < _bit_count) ++_bit_pos;
+            break;
+        default:
+            on_bit_received(len < timing.sample_threshold);
+            break;
+    }
+}
+
+void DS18B20Sim::on_bit_received(bool bit) {
+    if (_phase == Phase::search_dir) {
+        if (bit != get_rom_bit(_bit_pos)) {
+            _phase = Phase::idle;      //lost arbitration
+        } else if (++_bit_pos == 64) {
+            _phase = Phase::idle;      //search done, wait for reset
+        } else {
+            _phase = Phase::search_bit;
+        }
+        return;
+    }
+    if (bit) _buffer[_bit_pos >> 3] |= 1 << (_bit_pos & 7);
+    if (++_bit_pos == _bit_count) process_received();
+}
+
+void DS18B20Sim::process_received() {
+    switch (_phase) {
+        case Phase::rom_command:
+            switch (_buffer[0]) {
+                case 0x33: start_transmit(_rom.data(), 8); break;
+                case 0x55: start_receive(Phase::match_rom, 64); break;
+                case 0xCC: start_receive(Phase::function_command, 8); break;
+                case 0xEC:
+                case 0xF0:
+                    if (_buffer[0] == 0xEC && !has_alarm()) {
+                        _phase = Phase::idle;
+                    } else {
+                        _phase = Phase::search_bit;
+                        _bit_pos = 0;
+                    }
+                    break;
+                default: _phase = Phase::idle; break;
+            }
+            break;
+        case Phase::match_rom:
+            if (std::equal(_rom.begin(), _rom.end(), _buffer.begin())) {
+                start_receive(Phase::function_command, 8);
+            } else {
+                _phase = Phase::idle;
+            }
+            break;
+        case Phase::function_command:
+            switch (_buffer[0]) {
+                case 0x44: {
+                    unsigned int drop_bits = 3 - ((_scratchpad[4] >> 5) & 0x3);
+                    _converting = true;
+                    ++_conversion_count;
+                    _conversion_end = _now_ms + (timing.conversion_time_ms >> drop_bits);
+                    _phase = Phase::convert;
+                } break;
+                case 0xBE: {
+                    auto sp = _scratchpad;
+                    if (faults.crc_error) sp[8] ^= 0x5A;
+                    start_transmit(sp.data(), sp.size());
+                } break;
+                case 0x4E: start_receive(Phase::write_scratchpad, 24); break;
+                case 0x48:
+                    std::copy(_scratchpad.begin()+2, _scratchpad.begin()+5, _eeprom.begin());
+                    _phase = Phase::idle;
+                    break;
+                case 0xB8:
+                    std::copy(_eeprom.begin(), _eeprom.end(), _scratchpad.begin()+2);
+                    update_scratchpad_crc();
+                    start_transmit(nullptr, 0);     //recall done, read slots return 1
+                    break;
+                case 0xB4:
+                    start_transmit(nullptr, 0);     //external power, read slots return 1
+                    break;
+                default: _phase = Phase::idle; break;
+            }
+            break;
+        case Phase::write_scratchpad:
+            _scratchpad[2] = _buffer[0];
+            _scratchpad[3] = _buffer[1];
+            _scratchpad[4] = (_buffer[2] & 0x60) | 0x1F;
+            update_scratchpad_crc();
+            _phase = Phase::idle;
+            break;
+        default:
+            _phase = Phase::idle;
+            break;
+    }
+}
+
+void OneWireBusSim::master_pin(bool level, unsigned long now_ms) {
+    if (level == _master_level) return;
+    _master_level = level;
+    auto n = now();
+    if (!level) {
+        _fall_time = n;
+        for (auto d: _devices) d->on_master_low(n, now_ms);
+    } else {
+        if (n - _fall_time >= 480) ++_stats.resets;
+        else ++_stats.slots;
+        for (auto d: _devices) d->on_master_release(n, now_ms);
+    }
+}
+
+bool OneWireBusSim::read_pin() const {
+    if (_shorted || !_master_level) return false;
+    auto n = now();
+    return std::none_of(_devices.begin(), _devices.end(), [&](const DS18B20Sim *d){
+        return d->is_pulling(n);
+    });
+}
+
+OneWireBusSim::Stats OneWireBusSim::take_stats() {
+    Stats s = _stats;
+    s.bus_time = now() - _stats_start;
+    _stats_start = now();
+    _stats = {};
+    return s;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+///Bit level model of DS18B20 connected to simulated OneWire bus
+/**
+ * The device watches edges generated by the master. Length of the low
+ * pulse decides meaning of the slot (reset, write 0, write 1 / read slot).
+ * The device answers by pulling the bus low for a configured interval
+ * (presence pulse, transmitted zero). All times are in microseconds of
+ * the bus clock
+ */
+class DS18B20Sim {
+public:
+
+    using Address = std::array<uint8_t, 8>;
+
+    ///configurable latency of the device
+    struct Timing {
+        ///delay between end of reset and begin of presence pulse
+        unsigned long presence_wait = 30;
+        ///length of presence pulse
+        unsigned long presence_len = 120;
+        ///how long the device holds the bus low to transmit zero
+        unsigned long tx_zero_len = 30;
+        ///low pulses shorter than this are read as one
+        unsigned long sample_threshold = 15;
+        ///low pulses longer than this reset the device
+        unsigned long reset_threshold = 480;
+        ///conversion time at 12-bit resolution in milliseconds
+        unsigned long conversion_time_ms = 750;
+    };
+
+    ///injected faults
+    struct Faults {
+        ///device doesn't respond at all
+        bool not_present = false;
+        ///transmitted scratchpad has invalid CRC
+        bool crc_error = false;
+        ///probability that transmitted bit is flipped
+        double bit_error_rate = 0;
+    };
+
+    DS18B20Sim(const Address &rom);
+
+    const Address &get_rom() const {return _rom;}
+
+    void set_temp(float temp) {_temp = temp;}
+    float get_temp() const {return _temp;}
+    ///count of received convert commands
+    unsigned int get_conversion_count() const {return _conversion_count;}
+
+    Timing timing = {};
+    Faults faults = {};
+
+    ///master pulled the bus low
+    /**
+     * @param now current bus time
+     * @param now_ms current time in milliseconds (for conversion)
+     */
+    void on_master_low(unsigned long now, unsigned long now_ms);
+    ///master released the bus
+    void on_master_release(unsigned long now, unsigned long now_ms);
+    ///returns true, when device holds the bus low at given time
+    bool is_pulling(unsigned long now) const {
+        return now >= _low_from && now < _low_until;
+    }
+
+    ///calculate ROM CRC for the first 7 bytes
+    static uint8_t crc8(const uint8_t *data, unsigned int len);
+    ///create valid DS18B20 ROM (family 0x28) from 6-byte serial number
+    static Address make_rom(std::array<uint8_t, 6> serial);
+
+protected:
+
+    enum class Phase {
+        ///not selected, waiting for reset
+        idle,
+        ///receiving ROM command
+        rom_command,
+        ///receiving address for match ROM
+        match_rom,
+        ///search ROM, transmitting bit
+        search_bit,
+        ///search ROM, transmitting complement
+        search_cmp,
+        ///search ROM, receiving direction
+        search_dir,
+        ///receiving function command
+        function_command,
+        ///receiving data for write scratchpad
+        write_scratchpad,
+        ///transmitting buffer (scratchpad, rom, power status)
+        transmit,
+        ///read slots report conversion status
+        convert
+    };
+
+    Address _rom;
+    float _temp = 85.0f;
+    std::array<uint8_t, 9> _scratchpad;
+    std::array<uint8_t, 3> _eeprom = {0x4B, 0x46, 0x7F};
+
+    Phase _phase = Phase::idle;
+    unsigned long _fall_time = 0;
+    unsigned long _low_from = 0;
+    unsigned long _low_until = 0;
+    unsigned long _now_ms = 0;
+    unsigned long _conversion_end = 0;
+    bool _converting = false;
+    unsigned int _conversion_count = 0;
+
+    unsigned int _bit_pos = 0;
+    unsigned int _bit_count = 0;
+    std::array<uint8_t, 9> _buffer = {};
+
+    std::minstd_rand _rnd;
+
+    void reset();
+    void update_conversion();
+    bool has_alarm() const;
+    void start_transmit(const uint8_t *data, unsigned int bytes);
+    void start_receive(Phase phase, unsigned int bits);
+    bool get_tx_bit() const;
+    bool get_rom_bit(unsigned int pos) const {
+        return (_rom[pos >> 3] >> (pos & 7)) & 1;
+    }
+    void on_bit_received(bool bit);
+    void process_received();
+    void update_scratchpad_crc();
+};
+
+///Simulated OneWire bus
+/**
+ * Bus has wired-AND logic. The bus clock advances by 1/16 us on each
+ * reading of current time (the same way as OneWireTest does), so the bus time
+ * is proportional to work done by the master
+ */
+class OneWireBusSim {
+public:
+
+    ///statistics of bus usage
+    struct Stats {
+        unsigned long bus_time = 0;
+        unsigned long resets = 0;
+        unsigned long slots = 0;
+    };
+
+    ///advance clock and return current bus time in microseconds
+    unsigned long tick() {return (++_ticks) >> 4;}
+    ///return current bus time without advancing clock
+    unsigned long now() const {return _ticks >> 4;}
+
+    void attach(DS18B20Sim *dev) {_devices.push_back(dev);}
+
+    ///master sets its output
+    /**
+     * @param level false - master pulls bus low, true - master releases bus
+     * @param now_ms current time in milliseconds
+     */
+    void master_pin(bool level, unsigned long now_ms);
+    ///read level of the bus
+    bool read_pin() const;
+
+    ///simulate bus shorted to ground
+    void set_short(bool s) {_shorted = s;}
+
+    ///retrieve stats collected since last call and reset them
+    Stats take_stats();
+
+protected:
+    std::vector<DS18B20Sim *> _devices;
+    unsigned long _ticks = 0;
+    unsigned long _stats_start = 0;
+    unsigned long _fall_time = 0;
+    bool _master_level = true;
+    bool _shorted = false;
+    Stats _stats = {};
+};
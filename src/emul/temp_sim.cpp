@@ -1,103 +1,107 @@
-#include "../SimpleDallasTemp/SimpleDallasTemp.h"
-#include "OneWire.h"
+#include "temp_sim.h"
+#include "onewire_sim.h"
+#include "../kotel/http_utils.h"
+
+#include <Arduino.h>
+#include <OneWire.h>
 
-#include <algorithm>
 #include <iterator>
+#include <string>
+
 constexpr int count_devices =2;
 
-constexpr SimpleDallasTemp::Address devices[count_devices] = {
-        {1,253,125,69,56,252,137,64},
-        {2,109,56,217,120,239,0,30}
+static DS18B20Sim devices[count_devices] = {
+        DS18B20Sim::make_rom({253,125,69,56,252,137}),
+        DS18B20Sim::make_rom({109,56,217,120,239,0})
 };
 
-float temps[count_devices] = {85,85};
+static OneWireBusSim &get_bus() {
+    static OneWireBusSim bus = []{
+        OneWireBusSim b;
+        for (auto &d: devices) b.attach(&d);
+        return b;
+    }();
+    return bus;
+}
+
+static unsigned int last_conversion_count = 0;
+static std::string report;
 
 
 void set_temp(int device, float value) {
     if (device >= 0 && device < count_devices)
-        temps[device] = value;
+        devices[device].set_temp(value);
 }
 
-SimpleDallasTemp::SimpleDallasTemp(OneWire &one):_wire(one) {}
-
-bool SimpleDallasTemp::is_valid_address(const Address &a) {
-    return std::find(std::begin(devices), std::end(devices), a) != std::end(devices);
-}
-
-bool SimpleDallasTemp::request_temp(const Address &) {
+bool onewire_config(std::string_view cfg) {
+    auto &bus = get_bus();
+    do {
+        auto value = kotel::split(cfg, "&");
+        auto key = kotel::trim(kotel::split(value, "="));
+        std::string v (kotel::trim(value));
+        double n = std::strtod(v.c_str(), nullptr);
+        auto ul = static_cast<unsigned long>(n);
+        if (key == "short") {
+            bus.set_short(n != 0);
+        } else if (key == "convtime") {
+            for (auto &d: devices) d.timing.conversion_time_ms = ul;
+        } else if (key == "pwait") {
+            for (auto &d: devices) d.timing.presence_wait = ul;
+        } else if (key == "plen") {
+            for (auto &d: devices) d.timing.presence_len = ul;
+        } else if (key == "tx0") {
+            for (auto &d: devices) d.timing.tx_zero_len = ul;
+        } else if (key.size() > 1 && key.back() >= '0' && key.back() < '0' + count_devices) {
+            auto &d = devices[key.back() - '0'];
+            key = key.substr(0, key.size()-1);
+            if (key == "absent") d.faults.not_present = n != 0;
+            else if (key == "crc") d.faults.crc_error = n != 0;
+            else if (key == "ber") d.faults.bit_error_rate = n;
+            else return false;
+        } else {
+            return false;
+        }
+    } while (!cfg.empty());
     return true;
 }
 
-bool SimpleDallasTemp::request_temp() {
-   return true;
-}
-
-void OneWire::begin(uint8_t ) {}
-
-std::optional<float> SimpleDallasTemp::read_temp_celsius(const Address &addr) {
-    auto iter = std::find(std::begin(devices), std::end(devices), addr);
-    if (iter == std::end(devices)) {
-        _last_status = Status::fault_not_present;
-        return {};
+std::string_view onewire_report() {
+    report.clear();
+    unsigned int cnt = 0;
+    for (const auto &d: devices) cnt += d.get_conversion_count();
+    if (cnt != last_conversion_count) {
+        last_conversion_count = cnt;
+        auto st = get_bus().take_stats();
+        report.append("measure cycle: bus time ").append(std::to_string(st.bus_time))
+              .append(" us, resets ").append(std::to_string(st.resets))
+              .append(", slots ").append(std::to_string(st.slots));
     }
-    auto index = std::distance(std::begin(devices), iter);
-    return temps[index];
+    return report;
 }
 
 
-void SimpleDallasTemp::enum_devices_cb(EnumCallback &cb) {
-    for (const auto &x: devices) {
-        if (!cb(x)) return;
-    }
+void OneWire::enable_interrupt() {
 }
 
-
-
-std::optional<float> SimpleDallasTemp::async_read_temp_celsius(AsyncState &st) {
-    if (st.buffer[8] == 1) {
-        return *reinterpret_cast<float *>(st.buffer);
-    } else {
-        return {};
-    }
+void OneWire::disable_interrupt() {
 }
 
-void SimpleDallasTemp::async_request_temp(AsyncState &st, const Address &addr) {
-    st.phase = 0;
-    st.state = AsyncCommand::request_temp_addr;
-    st.st = Status::ok;
-    st.addr = addr;
+void OneWire::init_pin() {
+    get_bus().master_pin(true, millis());
 }
 
-void SimpleDallasTemp::async_request_temp(AsyncState &st) {
-    st.phase = 0;
-    st.state = AsyncCommand::request_temp_global;
-    st.st = Status::ok;
-
+void OneWire::release_pin() {
+    get_bus().master_pin(true, millis());
 }
 
-void SimpleDallasTemp::async_read_temp(AsyncState &st, const Address &addr) {
-    st.phase = 0;
-    st.addr = addr;
-    st.state = AsyncCommand::read_temp;
-    st.st = Status::ok;
+void OneWire::hold_low_pin() {
+    get_bus().master_pin(false, millis());
 }
 
-bool SimpleDallasTemp::async_cycle(AsyncState &st) {
-    if (st.phase < 3) {
-        ++st.phase;
-        return false;
-    }
-    auto x = read_temp_celsius(st.addr);;
-    if (x) {
-        float *z = reinterpret_cast<float *>(st.buffer);
-        *z =  *x;
-        st.buffer[8] = 1;
-    } else {
-        st.buffer[8] = 0;
-        st.st = get_last_error();
-    }
-    return true;
-
+bool OneWire::read_pin() {
+    return get_bus().read_pin();
 }
 
-
+unsigned long OneWire::get_current_time() {
+    return get_bus().tick();
+}
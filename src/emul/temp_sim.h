@@ -1,4 +1,17 @@
 
 
+#include <string_view>
 
 void set_temp(int device, float value);
+///configure simulated OneWire bus (key=value&key=value)
+/**
+ * @param cfg configuration string
+ * @retval true success
+ * @retval false unknown key
+ */
+bool onewire_config(std::string_view cfg);
+///retrieve bus statistics when measure cycle finished
+/**
+ * @return text of report, or empty string if nothing to report
+ */
+std::string_view onewire_report();
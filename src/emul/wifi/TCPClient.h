@@ -25,4 +25,13 @@ public:
         }
         return -1;
     }
+
+    ///read only data already in the buffer, never polls the socket
+    int read_nb(uint8_t *buf, std::size_t size) {
+        if (!this->_ctx) return 0;
+        auto sub = _ctx->_data.substr(0, size);
+        std::copy(sub.begin(), sub.end(), buf);
+        _ctx->_data = _ctx->_data.substr(sub.size());
+        return static_cast<int>(sub.size());
+    }
 };
@@ -34,6 +34,9 @@ WiFiClient WiFiServer::accept() {
     if (s < 0) {
         return WiFiClient();
     }
+    //responses are written in several parts, don't wait for delayed ACK
+    int opt = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
     auto ctx = std::make_shared<WiFiClient::Context>(s);
     _ctx->_active_connections.push_back(ctx);
     return WiFiClient(ctx);
@@ -45,6 +48,8 @@ void WiFiServer::begin(int port) {
 }
 
 void WiFiServer::begin() {
+    //restarting server, close previous listening socket
+    _ctx = nullptr;
     sockaddr_in sin={};
     sin.sin_family = AF_INET;
     sin.sin_port = htons(_port);
@@ -0,0 +1,490 @@
+#pragma once
+#include "task.h"
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+namespace kotel {
+
+///Kind of reply of AT command
+enum class AtReply: uint8_t {
+    ///text after the prompt, terminated by OK
+    text,
+    ///data prefixed by size and '|' (receive commands)
+    binary,
+    ///only OK or ERROR (send commands)
+    status
+};
+
+///State of AT command
+enum class AtStatus: uint8_t {
+    ///waiting in the queue
+    queued,
+    ///sent, waiting for reply
+    sent,
+    ///completed with OK
+    ok,
+    ///completed with ERROR
+    error,
+    ///no reply in time
+    timeout,
+    ///ticket is not valid
+    invalid
+};
+
+///Identifies queued command (generation << 8 | slot index), 0 is not valid
+using AtTicket = uint16_t;
+constexpr AtTicket no_at_ticket = 0;
+
+///Non-blocking driver of AT modem
+/**
+ * Commands are formatted to a queue of fixed slots. The pump() sends
+ * them to the UART in order, up to max_in_flight commands wait for reply
+ * at once. Replies are parsed by a state machine which consumes only
+ * data already received by the UART, so pump() never waits for the modem.
+ *
+ * Owner of the command checks its state by the ticket and releases it
+ * when it reads the result. Released command is still sent (order of
+ * replies must be kept), only its reply is discarded. A task can be
+ * woken up when the command completes.
+ *
+ * If the modem doesn't answer in time, all commands waiting for reply
+ * fail with timeout and the input is discarded until the line is quiet.
+ *
+ * @tparam Uart UART connected to the modem - available(), read(),
+ *      write(const uint8_t *, size_t)
+ * @tparam queue_size count of slots
+ */
+template<typename Uart, unsigned int queue_size = 8>
+class AtModem {
+public:
+
+    ///max length of formatted command
+    static constexpr unsigned int command_size = 64;
+    ///size of internal buffer for result
+    static constexpr unsigned int result_size = 24;
+    ///max count of commands waiting for reply
+    static constexpr unsigned int max_in_flight = 4;
+    ///default timeout in milliseconds
+    static constexpr unsigned int default_timeout = 2000;
+    ///after timeout, input is discarded until there is no data for this time
+    static constexpr unsigned int resync_quiet = 100;
+    ///max bytes processed by one pump()
+    static constexpr unsigned int max_rx_per_pump = 512;
+
+    static_assert(queue_size > 0 && queue_size < 256);
+
+    AtModem(Uart &uart):_uart(uart) {}
+    AtModem(const AtModem &) = delete;
+    AtModem &operator=(const AtModem &) = delete;
+
+    ///queue command
+    /**
+     * @param prompt prompt of the reply (PROMPT(x)), it is removed from the result
+     * @param reply kind of reply
+     * @param fmt format of the command (printf)
+     * @return ticket, no_at_ticket if the queue is full or the command is too long
+     *
+     * @note Options (set_payload, set_output, ...) must be set before
+     * next pump()
+     */
+    AtTicket command(const char *prompt, AtReply reply, const char *fmt, ...);
+
+    ///send data after the command (send commands)
+    /** Data must stay valid until the command is sent */
+    void set_payload(AtTicket t, const void *data, std::size_t size);
+    ///store binary reply to external buffer
+    /** Buffer must stay valid until the command completes */
+    void set_output(AtTicket t, char *buffer, std::size_t size);
+    ///set timeout of the reply
+    void set_timeout(AtTicket t, unsigned int ms);
+    ///wake task up when the command completes
+    void set_notify(AtTicket t, AbstractTask *task);
+
+    ///get state of command
+    AtStatus get_status(AtTicket t) const;
+    ///command completed (with any result)
+    bool is_done(AtTicket t) const {
+        auto st = get_status(t);
+        return st != AtStatus::queued && st != AtStatus::sent;
+    }
+    ///get result of completed command
+    /**
+     * Text result is trimmed and terminated by zero. Binary result
+     * is stored in the output buffer. Valid until the ticket is released
+     */
+    std::string_view get_result(AtTicket t) const;
+    ///get result as number (0 if not completed with OK)
+    int get_int_result(AtTicket t) const;
+    ///release the ticket, sets it to no_at_ticket
+    void release(AtTicket &t);
+
+    ///send queued commands and process received data
+    void pump(TimeStampMs now);
+
+    ///no command is queued or waiting for reply
+    /**
+     * Only when idle, other code can use the UART directly. After a timeout,
+     * the driver is not idle until the line is quiet (late replies are
+     * discarded by pump())
+     */
+    bool is_idle() const {return _pending == 0 && _rx_state != RxState::resync;}
+
+    ///count of free slots
+    unsigned int get_free_slots() const {
+        unsigned int cnt = 0;
+        for (const auto &s: _slots) cnt += s.used?0:1;
+        return cnt;
+    }
+
+protected:
+
+    struct Slot {
+        char cmd[command_size];
+        char result[result_size];
+        const char *prompt = nullptr;
+        const char *payload = nullptr;
+        std::size_t payload_size = 0;
+        char *out = nullptr;
+        std::size_t out_size = 0;
+        std::size_t out_len = 0;
+        AbstractTask *notify = nullptr;
+        TimeStampMs deadline = 0;
+        unsigned int timeout = default_timeout;
+        uint8_t cmd_len = 0;
+        uint8_t generation = 0;
+        AtReply reply = AtReply::text;
+        AtStatus status = AtStatus::queued;
+        bool used = false;
+        bool released = false;
+    };
+
+    enum class RxState: uint8_t {
+        ///text of reply or header of binary reply
+        header,
+        ///binary data
+        data,
+        ///after binary data
+        tail,
+        ///discard input after timeout
+        resync
+    };
+
+    Uart &_uart;
+    Slot _slots[queue_size];
+    ///slots of pending commands in order of sending
+    uint8_t _order[queue_size] = {};
+    ///index of oldest pending command in _order
+    uint8_t _head = 0;
+    ///count of pending commands
+    uint8_t _pending = 0;
+    ///count of pending commands already sent
+    uint8_t _in_flight = 0;
+    uint8_t _generation = 0;
+    RxState _rx_state = RxState::header;
+    ///last received characters (to find end of reply)
+    char _rx_tail[8] = {};
+    ///count of characters of current reply (or its tail)
+    std::size_t _rx_count = 0;
+    ///remaining binary data
+    std::size_t _rx_remain = 0;
+    ///size of binary data (parsed from header)
+    std::size_t _rx_size = 0;
+    bool _rx_size_valid = false;
+    TimeStampMs _last_rx = 0;
+
+    Slot *find(AtTicket t);
+    const Slot *find(AtTicket t) const;
+    void send_commands(TimeStampMs now);
+    void receive(char c, TimeStampMs now);
+    ///check end of reply, returns OK, ERROR or queued (not finished)
+    AtStatus check_end() const;
+    void finish(AtStatus st, TimeStampMs now);
+    void finish_text(Slot &s, std::size_t term_len);
+    void push_tail(char c);
+    void free_slot(Slot &s) {s.used = false;}
+};
+
+template<typename Uart, unsigned int queue_size>
+inline AtTicket AtModem<Uart, queue_size>::command(const char *prompt, AtReply reply, const char *fmt, ...) {
+    if (_pending >= queue_size) return no_at_ticket;
+    Slot *s = nullptr;
+    unsigned int idx = 0;
+    for (unsigned int i = 0; i < queue_size; ++i) {
+        if (!_slots[i].used) {
+            s = _slots + i;
+            idx = i;
+            break;
+        }
+    }
+    if (!s) return no_at_ticket;
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(s->cmd, command_size, fmt, args);
+    va_end(args);
+    if (len < 0 || static_cast<unsigned int>(len) >= command_size) return no_at_ticket;
+    if (++_generation == 0) _generation = 1;
+    s->cmd_len = static_cast<uint8_t>(len);
+    s->result[0] = 0;
+    s->prompt = prompt;
+    s->payload = nullptr;
+    s->payload_size = 0;
+    s->out = s->result;
+    s->out_size = reply == AtReply::status?0:result_size;
+    s->out_len = 0;
+    s->notify = nullptr;
+    s->timeout = default_timeout;
+    s->generation = _generation;
+    s->reply = reply;
+    s->status = AtStatus::queued;
+    s->used = true;
+    s->released = false;
+    _order[(_head + _pending) % queue_size] = static_cast<uint8_t>(idx);
+    ++_pending;
+    return static_cast<AtTicket>((_generation << 8) | idx);
+}
+
+template<typename Uart, unsigned int queue_size>
+inline typename AtModem<Uart, queue_size>::Slot *AtModem<Uart, queue_size>::find(AtTicket t) {
+    unsigned int idx = t & 0xFF;
+    if (t == no_at_ticket || idx >= queue_size) return nullptr;
+    Slot &s = _slots[idx];
+    if (!s.used || s.released || s.generation != (t >> 8)) return nullptr;
+    return &s;
+}
+
+template<typename Uart, unsigned int queue_size>
+inline const typename AtModem<Uart, queue_size>::Slot *AtModem<Uart, queue_size>::find(AtTicket t) const {
+    return const_cast<AtModem *>(this)->find(t);
+}
+
+template<typename Uart, unsigned int queue_size>
+inline void AtModem<Uart, queue_size>::set_payload(AtTicket t, const void *data, std::size_t size) {
+    Slot *s = find(t);
+    if (s && s->status == AtStatus::queued) {
+        s->payload = reinterpret_cast<const char *>(data);
+        s->payload_size = size;
+    }
+}
+
+template<typename Uart, unsigned int queue_size>
+inline void AtModem<Uart, queue_size>::set_output(AtTicket t, char *buffer, std::size_t size) {
+    Slot *s = find(t);
+    if (s && s->status == AtStatus::queued) {
+        s->out = buffer;
+        s->out_size = size;
+    }
+}
+
+template<typename Uart, unsigned int queue_size>
+inline void AtModem<Uart, queue_size>::set_timeout(AtTicket t, unsigned int ms) {
+    Slot *s = find(t);
+    if (s) s->timeout = ms;
+}
+
+template<typename Uart, unsigned int queue_size>
+inline void AtModem<Uart, queue_size>::set_notify(AtTicket t, AbstractTask *task) {
+    Slot *s = find(t);
+    if (s) s->notify = task;
+}
+
+template<typename Uart, unsigned int queue_size>
+inline AtStatus AtModem<Uart, queue_size>::get_status(AtTicket t) const {
+    const Slot *s = find(t);
+    return s?s->status:AtStatus::invalid;
+}
+
+template<typename Uart, unsigned int queue_size>
+inline std::string_view AtModem<Uart, queue_size>::get_result(AtTicket t) const {
+    const Slot *s = find(t);
+    if (!s || (s->status != AtStatus::ok && s->status != AtStatus::error)) return {};
+    return {s->out, s->out_len};
+}
+
+template<typename Uart, unsigned int queue_size>
+inline int AtModem<Uart, queue_size>::get_int_result(AtTicket t) const {
+    const Slot *s = find(t);
+    if (!s || s->status != AtStatus::ok || s->reply != AtReply::text) return 0;
+    return std::atoi(s->result);
+}
+
+template<typename Uart, unsigned int queue_size>
+inline void AtModem<Uart, queue_size>::release(AtTicket &t) {
+    Slot *s = find(t);
+    t = no_at_ticket;
+    if (!s) return;
+    if (s->status == AtStatus::queued || s->status == AtStatus::sent) {
+        //reply is still expected, slot is freed later
+        s->released = true;
+        s->notify = nullptr;
+        //external buffer can't be used anymore
+        s->out = s->result;
+        s->out_size = s->reply == AtReply::status?0:result_size;
+        s->out_len = 0;
+    } else {
+        free_slot(*s);
+    }
+}
+
+template<typename Uart, unsigned int queue_size>
+inline void AtModem<Uart, queue_size>::pump(TimeStampMs now) {
+    unsigned int cnt = 0;
+    while (cnt < max_rx_per_pump && _uart.available() > 0) {
+        int c = _uart.read();
+        if (c < 0) break;
+        ++cnt;
+        _last_rx = now;
+        receive(static_cast<char>(c), now);
+    }
+    if (_rx_state == RxState::resync) {
+        if (now - _last_rx < resync_quiet) return;
+        _rx_state = RxState::header;
+        _rx_count = 0;
+    }
+    if (_in_flight) {
+        Slot &s = _slots[_order[_head]];
+        if (now > s.deadline) {
+            //no reply, fail all waiting commands, their replies
+            //(if they come later) must not be taken for replies of next commands
+            while (_in_flight) finish(AtStatus::timeout, now);
+            _rx_state = RxState::resync;
+            _last_rx = now;
+            return;
+        }
+    }
+    send_commands(now);
+}
+
+template<typename Uart, unsigned int queue_size>
+inline void AtModem<Uart, queue_size>::send_commands(TimeStampMs now) {
+    while (_in_flight < _pending && _in_flight < max_in_flight) {
+        Slot &s = _slots[_order[(_head + _in_flight) % queue_size]];
+        _uart.write(reinterpret_cast<const uint8_t *>(s.cmd), s.cmd_len);
+        if (s.payload_size) {
+            _uart.write(reinterpret_cast<const uint8_t *>(s.payload), s.payload_size);
+        }
+        s.payload = nullptr;
+        s.payload_size = 0;
+        s.status = AtStatus::sent;
+        if (_in_flight == 0) s.deadline = now + s.timeout;
+        ++_in_flight;
+    }
+}
+
+template<typename Uart, unsigned int queue_size>
+inline void AtModem<Uart, queue_size>::push_tail(char c) {
+    constexpr unsigned int sz = sizeof(_rx_tail);
+    for (unsigned int i = 1; i < sz; ++i) _rx_tail[i-1] = _rx_tail[i];
+    _rx_tail[sz-1] = c;
+    ++_rx_count;
+}
+
+template<typename Uart, unsigned int queue_size>
+inline AtStatus AtModem<Uart, queue_size>::check_end() const {
+    constexpr std::size_t sz = sizeof(_rx_tail);
+    std::string_view tail(_rx_tail, sz);
+    //terminator must be at start of line
+    auto ends = [&](std::string_view term) {
+        if (_rx_count < term.size() || tail.substr(sz - term.size()) != term) return false;
+        return _rx_count == term.size() || tail[sz - term.size() - 1] == '\n';
+    };
+    if (ends("OK\r\n")) return AtStatus::ok;
+    if (ends("ERROR\r\n")) return AtStatus::error;
+    return AtStatus::queued;
+}
+
+template<typename Uart, unsigned int queue_size>
+inline void AtModem<Uart, queue_size>::receive(char c, TimeStampMs now) {
+    if (_rx_state == RxState::resync || !_in_flight) return;
+    Slot &s = _slots[_order[_head]];
+    switch (_rx_state) {
+        default:
+        case RxState::header:
+            push_tail(c);
+            if (s.reply == AtReply::binary) {
+                if (c == '|') {
+                    _rx_remain = _rx_size_valid?_rx_size:0;
+                    _rx_count = 0;
+                    _rx_state = _rx_remain?RxState::data:RxState::tail;
+                    break;
+                }
+                if (c >= '0' && c <= '9') {
+                    _rx_size = (_rx_size_valid?_rx_size * 10:0) + (c - '0');
+                    _rx_size_valid = true;
+                } else {
+                    _rx_size_valid = false;
+                }
+            } else if (s.out_len + 1 < s.out_size) {
+                s.out[s.out_len++] = c;
+            }
+            {
+                auto st = check_end();
+                if (st != AtStatus::queued) finish(st, now);
+            }
+            break;
+        case RxState::data:
+            if (s.out_len < s.out_size) s.out[s.out_len++] = c;
+            if (--_rx_remain == 0) {
+                _rx_state = RxState::tail;
+                _rx_count = 0;
+            }
+            break;
+        case RxState::tail:
+            push_tail(c);
+            {
+                auto st = check_end();
+                if (st != AtStatus::queued) finish(st, now);
+            }
+            break;
+    }
+}
+
+template<typename Uart, unsigned int queue_size>
+inline void AtModem<Uart, queue_size>::finish_text(Slot &s, std::size_t term_len) {
+    if (!s.out_size) return;
+    //content without terminator (if it was stored)
+    std::size_t len = s.out_len;
+    if (_rx_count - term_len < len) len = _rx_count - term_len;
+    std::string_view txt(s.out, len);
+    if (s.prompt) {
+        auto pos = txt.find(s.prompt);
+        if (pos != txt.npos) txt = txt.substr(pos + std::string_view(s.prompt).size());
+    }
+    while (!txt.empty() && static_cast<unsigned char>(txt.front()) <= ' ') txt = txt.substr(1);
+    while (!txt.empty() && static_cast<unsigned char>(txt.back()) <= ' ') txt = txt.substr(0, txt.size()-1);
+    for (std::size_t i = 0; i < txt.size(); ++i) s.out[i] = txt[i];
+    s.out_len = txt.size();
+    s.out[s.out_len] = 0;
+}
+
+template<typename Uart, unsigned int queue_size>
+inline void AtModem<Uart, queue_size>::finish(AtStatus st, TimeStampMs now) {
+    Slot &s = _slots[_order[_head]];
+    if (s.reply != AtReply::binary) {
+        if (st == AtStatus::ok) finish_text(s, 4);
+        else if (st == AtStatus::error) finish_text(s, 7);
+        else if (s.out_size) s.out[s.out_len = 0] = 0;
+    }
+    s.status = st;
+    _head = static_cast<uint8_t>((_head + 1) % queue_size);
+    --_pending;
+    --_in_flight;
+    _rx_state = RxState::header;
+    _rx_count = 0;
+    _rx_size_valid = false;
+    if (_in_flight) {
+        //deadline of next reply starts now
+        Slot &n = _slots[_order[_head]];
+        n.deadline = now + n.timeout;
+    }
+    if (s.released) {
+        free_slot(s);
+    } else if (s.notify) {
+        s.notify->resume_at(0);
+    }
+}
+
+}
@@ -0,0 +1,208 @@
+#pragma once
+#include "at_modem.h"
+
+#include <WiFiCommands.h>
+#include <api/IPAddress.h>
+
+#include <algorithm>
+#include <string_view>
+
+namespace kotel {
+
+///UDP socket of the modem, driven by asynchronous modem driver
+/**
+ * Same interface as UDPClient, but no function waits for the modem.
+ * Opening and sending are queued, receive() returns data when they
+ * are available, otherwise an empty view. The socket stays open until
+ * close() is called
+ *
+ * @tparam Modem modem driver (AtModem)
+ * @tparam buffer_size size of buffers of sent datagram
+ * @tparam rx_size size of buffer of received datagram (longer datagram is truncated)
+ */
+template<typename Modem, unsigned int buffer_size, unsigned int rx_size = buffer_size>
+class AtUDPClient {
+public:
+
+    AtUDPClient(Modem &modem):_modem(modem) {}
+    AtUDPClient(const AtUDPClient &) = delete;
+    AtUDPClient &operator=(const AtUDPClient &) = delete;
+    ~AtUDPClient() {close();}
+
+    ///open socket (asynchronously)
+    /**
+     * @retval 0 opening, or already open
+     * @retval -1 modem queue is full
+     */
+    int open(uint16_t port) {
+        if (_state != State::closed) return 0;
+        _open = _modem.command(PROMPT(_UDPBEGIN), AtReply::text, "%s%d\r\n", CMD_WRITE(_UDPBEGIN), port);
+        if (_open == no_at_ticket) return -1;
+        _state = State::opening;
+        return 0;
+    }
+
+    ///send datagram prepared in data()
+    /**
+     * If the socket is still opening, the datagram is sent later
+     * (while poll() or receive() is called).
+     * @retval sz datagram is queued
+     * @retval -1 socket is not open, modem queue is full, or previous
+     * datagram was not yet written
+     */
+    int send(IPAddress ip, uint16_t port, std::size_t sz) {
+        if (_state == State::closed || is_writing()) return -1;
+        std::copy(_tx, _tx + sz, _tx_send);
+        _tx_ip = ip;
+        _tx_port = port;
+        _tx_size = sz;
+        _send_pending = true;
+        poll();
+        return static_cast<int>(sz);
+    }
+
+    ///receive datagram
+    /**
+     * @return received datagram, or empty view if there is nothing yet
+     */
+    std::string_view receive() {
+        poll();
+        if (_state != State::open) return {};
+        if (_read != no_at_ticket) {
+            if (!_modem.is_done(_read)) return {};
+            bool ok = _modem.get_status(_read) == AtStatus::ok;
+            auto res = _modem.get_result(_read);
+            _modem.release(_read);
+            if (ok) return {_rx, res.size()};
+            return {};
+        }
+        if (_parse != no_at_ticket) {
+            if (!_modem.is_done(_parse)) return {};
+            int sz = _modem.get_int_result(_parse);
+            _modem.release(_parse);
+            if (sz > 0) {
+                _read = _modem.command(PROMPT(_UDPREAD), AtReply::binary, "%s%d,%d\r\n",
+                        CMD_WRITE(_UDPREAD), _sock, std::min<int>(sz, rx_size));
+                _modem.set_output(_read, _rx, rx_size);
+            }
+            return {};
+        }
+        _parse = _modem.command(PROMPT(_UDPPARSE), AtReply::text, "%s%d\r\n", CMD_WRITE(_UDPPARSE), _sock);
+        return {};
+    }
+
+    ///stop receiving of current datagram (socket stays open)
+    void cancel() {
+        _modem.release(_parse);
+        _modem.release(_read);
+        _send_pending = false;
+    }
+
+    ///close socket
+    /**
+     * If the socket is still opening, it can't be closed (its number
+     * is not known yet). Call it when the modem is idle
+     */
+    void close() {
+        cancel();
+        _modem.release(_write);
+        if (_state == State::opening) {
+            poll();
+            _modem.release(_open);
+        }
+        if (_state == State::open) {
+            AtTicket t = _modem.command(PROMPT(_UDPSTOP), AtReply::text, "%s%d\r\n", CMD_WRITE(_UDPSTOP), _sock);
+            _modem.release(t);
+        }
+        _state = State::closed;
+    }
+
+    ///finish opening of the socket and queue pending datagram
+    /**
+     * Called by receive(), call it also when no reply is expected,
+     * otherwise the socket can't leave opening state
+     */
+    void poll() {
+        if (_write != no_at_ticket && _modem.get_status(_write) != AtStatus::queued) {
+            _modem.release(_write);
+        }
+        if (_state == State::opening) {
+            if (!_modem.is_done(_open)) return;
+            bool ok = _modem.get_status(_open) == AtStatus::ok;
+            _sock = _modem.get_int_result(_open);
+            _modem.release(_open);
+            if (!ok || _sock < 0) {
+                _state = State::closed;
+                _send_pending = false;
+                return;
+            }
+            _state = State::open;
+        }
+        if (_state == State::open && _send_pending && _write == no_at_ticket
+                && _modem.get_free_slots() >= 3) {
+            //packet is sent in one exchange, results are not needed
+            AtTicket t[3] = {
+                _modem.command(PROMPT(_UDPBEGINPACKETIP), AtReply::text, "%s%d,%d,%d.%d.%d.%d\r\n",
+                        CMD_WRITE(_UDPBEGINPACKETIP), _sock, _tx_port, _tx_ip[0], _tx_ip[1], _tx_ip[2], _tx_ip[3]),
+                _modem.command(PROMPT(_UDPWRITE), AtReply::status, "%s%d,%d\r\n",
+                        CMD_WRITE(_UDPWRITE), _sock, static_cast<int>(_tx_size)),
+                _modem.command(PROMPT(_UDPENDPACKET), AtReply::text, "%s%d\r\n",
+                        CMD_WRITE(_UDPENDPACKET), _sock)
+            };
+            _modem.set_payload(t[1], _tx_send, _tx_size);
+            //payload is kept until the modem writes it
+            _write = t[1];
+            t[1] = no_at_ticket;
+            for (auto &x: t) _modem.release(x);
+            _send_pending = false;
+        }
+    }
+
+    bool is_open() const {return _state == State::open;}
+    ///datagram passed to send() was not yet written to the modem
+    /** data() can be reused for next datagram, but send() would replace this one */
+    bool is_sending() const {
+        return _send_pending || is_writing();
+    }
+
+    static constexpr std::size_t size()  {return buffer_size;}
+    ///buffer for datagram to send
+    char *data() {return _tx;}
+    const char *data() const {return _tx;}
+
+    auto begin() {return data();}
+    const auto begin() const  {return data();}
+    auto end() {return data()+size();}
+    const auto end() const  {return data()+size();}
+
+protected:
+
+    enum class State: uint8_t {
+        closed,
+        opening,
+        open
+    };
+
+    Modem &_modem;
+    State _state = State::closed;
+    int _sock = -1;
+    AtTicket _open = no_at_ticket;
+    AtTicket _parse = no_at_ticket;
+    AtTicket _read = no_at_ticket;
+    ///command which writes the datagram
+    AtTicket _write = no_at_ticket;
+    IPAddress _tx_ip;
+    uint16_t _tx_port = 0;
+    std::size_t _tx_size = 0;
+    bool _send_pending = false;
+    char _tx[buffer_size] = {};
+    ///copy of sent datagram - must stay valid until it is sent
+    char _tx_send[buffer_size] = {};
+    char _rx[rx_size] = {};
+
+    bool is_writing() const {
+        return _write != no_at_ticket && _modem.get_status(_write) == AtStatus::queued;
+    }
+};
+
+}
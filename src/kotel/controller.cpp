@@ -29,10 +29,18 @@ Controller::Controller()
         ,_read_serial(this)
         ,_refresh_wdt(this)
         ,_keyboard_scanner(this)
+        ,_storage_commit(this)
         ,_network(*this)
         ,_scheduler({&_feeder, &_fan, &_temp_sensors,  &_display,
             &_motoruntime, &_auto_drive_cycle, &_network,
-            &_read_serial, &_refresh_wdt, &_keyboard_scanner})
+            &_read_serial, &_refresh_wdt, &_keyboard_scanner,
+            &_storage_commit})
+        ,_sensor_scan(*this)
+        ,_events_producer(*this)
+        ,_config_producer(this)
+        ,_status_producer(this)
+        ,_metrics_producer(this)
+        ,_tasks_producer(this)
 {
 
 }
@@ -57,8 +65,11 @@ void Controller::begin() {
     }
     print(Serial, "Keyboard: ", _keyboard_connected?"connected":"not detected","\r\n");
     _storage.cntr1.restart_count++;
+    log_event(EventType::restart);
     if (_storage.pair_secret_need_init) {
         generate_pair_secret();
+    } else {
+        update_token_key();
     }
 #if ENABLE_VDT
     Serial.print("Init WDT: ");
@@ -78,6 +89,7 @@ void Controller::run() {
     control_pump();
     if (_sensors.tray_open) {
         _storage.tray.tray_open_time = _storage.tray.feeder_time;
+        if (!_was_tray_open) log_event(EventType::tray_open);
         _was_tray_open = true;
         _feeder.stop();
         _fan.stop();
@@ -85,13 +97,14 @@ void Controller::run() {
         if (_was_tray_open) {
             _was_tray_open = false;
             _storage.cntr1.tray_open_count++;
+            log_event(EventType::tray_close);
             if (_cur_tray_change._full) {
                 _storage.tray.set_max_fill(_storage.tray.feeder_time, _storage.config.tray_kg);
             } else if (_cur_tray_change._change) {
                 _storage.tray.update_tray_fill(_storage.tray.feeder_time, _cur_tray_change._change*_storage.config.bag_kg);
             }
             _cur_tray_change = {};
-            _storage.save();
+            _storage.save(_storage.tray, _storage.cntr1);
         }
         if (_sensors.feeder_overheat || is_overheat()) {
             run_stop_mode();
@@ -121,13 +134,9 @@ void Controller::run() {
         _feeder.stop();
         _fan.stop();
     }
-    if (_list_temp_async && !_temp_sensors.is_reading() && is_safe_for_blocking()) {
-        list_onewire_sensors(*_list_temp_async);
-        _list_temp_async->stop();
-        _list_temp_async.reset();
-    }
     _scheduler.run();
-    _storage.commit();
+    _network.pump_modem(get_current_timestamp());
+    commit_deferred_events();
 
 }
 
@@ -308,17 +317,40 @@ void print_table_format(Stream &s, Table &t) {
 
 }
 
+///print one row of table
+/**
+ * @param item index of row. If the table is shorter, the index is
+ * decreased by the size of table, so it can be used for next table
+ * @retval true printed
+ * @retval false the index is beyond the table
+ */
+template<typename Table, typename Object>
+bool print_table_item(Stream &s, const Table &table, const Object &object, unsigned int &item, std::string_view prefix = {}) {
+    auto cnt = std::size(table);
+    if (item >= cnt) {
+        item -= cnt;
+        return false;
+    }
+    const auto &[k,ptr] = table[item];
+    if (!prefix.empty()) s.write(prefix.data(), prefix.size());
+    print_data_line(s, k, object.*ptr);
+    return true;
+}
+
 void Controller::config_out(Stream &s) {
+    for (unsigned int i = 0; config_out(s, i); ++i);
+}
 
-    print_table(s, config_table, _storage.config);
-    print_table(s, config_table_2, _storage.config);
-    print_table(s, profile_table, _storage.config.full_power, "full.");
-    print_table(s, profile_table, _storage.config.low_power, "low.");
-    print_table(s, tempsensor_table_1, _storage.temp);
-    print_table(s, wifi_ssid_table, _storage.wifi_ssid);
-    print_table(s, wifi_password_table, _storage.wifi_password);
-    print_table(s, wifi_netcfg_table, _storage.wifi_config);
-    print_table(s, tray_table_2, _storage.tray);
+bool Controller::config_out(Stream &s, unsigned int item) {
+    return print_table_item(s, config_table, _storage.config, item)
+        || print_table_item(s, config_table_2, _storage.config, item)
+        || print_table_item(s, profile_table, _storage.config.full_power, item, "full.")
+        || print_table_item(s, profile_table, _storage.config.low_power, item, "low.")
+        || print_table_item(s, tempsensor_table_1, _storage.temp, item)
+        || print_table_item(s, wifi_ssid_table, _storage.wifi_ssid, item)
+        || print_table_item(s, wifi_password_table, _storage.wifi_password, item)
+        || print_table_item(s, wifi_netcfg_table, _storage.wifi_config, item)
+        || print_table_item(s, tray_table_2, _storage.tray, item);
 }
 
 
@@ -443,25 +475,31 @@ bool Controller::config_update(std::string_view body, std::string_view &&failed_
         auto value = split(body, "&");
         auto key = trim(split(value, "="));
         value = trim(value);
-        bool ok = update_settings(config_table, _storage.config, key, value)
-                || update_settings(config_table_2, _storage.config, key, value)
-                || update_settings(profile_table, _storage.config.full_power, key, value, "full.")
-                || update_settings(profile_table, _storage.config.low_power, key, value, "low.")
-                || update_settings(tempsensor_table_1, _storage.temp, key, value)
-                || update_settings(wifi_ssid_table, _storage.wifi_ssid, key, value)
-                || update_settings(wifi_password_table, _storage.wifi_password, key, value)
-                || update_settings(wifi_netcfg_table, _storage.wifi_config, key, value)
-                || update_settings(pair_sectet_table, _storage.pair_secret, key, value)
-                || update_settings(tray_control_table, _storage, key, value)
-                || update_settings(tray_control_table_2, _storage.tray, key, value);
+        auto upd = [&](const auto &table, auto &object, const auto &file, std::string_view prefix = {}) {
+            if (!update_settings(table, object, key, value, prefix)) return false;
+            _storage.save(file);
+            return true;
+        };
+        bool ok = upd(config_table, _storage.config, _storage.config)
+                || upd(config_table_2, _storage.config, _storage.config)
+                || upd(profile_table, _storage.config.full_power, _storage.config, "full.")
+                || upd(profile_table, _storage.config.low_power, _storage.config, "low.")
+                || upd(tempsensor_table_1, _storage.temp, _storage.temp)
+                || upd(wifi_ssid_table, _storage.wifi_ssid, _storage.wifi_ssid)
+                || upd(wifi_password_table, _storage.wifi_password, _storage.wifi_password)
+                || upd(wifi_netcfg_table, _storage.wifi_config, _storage.wifi_config)
+                || upd(pair_sectet_table, _storage.pair_secret, _storage.pair_secret)
+                || upd(tray_control_table, _storage, _storage.tray)
+                || upd(tray_control_table_2, _storage.tray, _storage.tray);
         if (!ok) {
             failed_field = key;
             return false;
         }
 
     } while (!body.empty());
-    _storage.save();
     _display.begin();
+    //pair secret could be changed
+    update_token_key();
     return true;
 
 }
@@ -481,25 +519,215 @@ void Controller::list_onewire_sensors(Stream &s) {
 }
 
 void Controller::status_out(Stream &s) {
-    print_data_line(s,"mode", static_cast<int>(_cur_mode));
-    print_data_line(s,"auto_mode", static_cast<int>(_auto_mode));
-    print_data_line(s,"temp.output.value", _temp_sensors.get_output_temp());
-    print_data_line(s,"temp.output.status", static_cast<int>(_temp_sensors.get_output_status()));
-    print_data_line(s,"temp.output.ampl", _temp_sensors.get_output_ampl());
-    print_data_line(s,"temp.input.value", _temp_sensors.get_input_temp());
-    print_data_line(s,"temp.input.status", static_cast<int>(_temp_sensors.get_input_status()));
-    print_data_line(s,"temp.input.ampl", _temp_sensors.get_input_ampl());
-    print_data_line(s,"temp.sim", _temp_sensors.is_simulated()?1:0);
-    print_data_line(s,"tray_open", _sensors.tray_open);
-    print_data_line(s,"motor_temp_ok", !_sensors.feeder_overheat);
-    print_data_line(s,"pump", _pump.is_active());
-    print_data_line(s,"feeder", _feeder.is_active());
-    print_data_line(s,"fan", _fan.get_current_speed());
-    print_data_line(s,"network.ip", WiFi.localIP());
-    print_data_line(s,"network.ssid", WiFi.SSID());
-    print_data_line(s,"network.signal",WiFi.RSSI());
+    for (unsigned int i = 0; status_out(s, i); ++i);
+}
+
+bool Controller::status_out(Stream &s, unsigned int item) {
+    switch (item) {
+        case 0: print_data_line(s,"mode", static_cast<int>(_cur_mode));break;
+        case 1: print_data_line(s,"auto_mode", static_cast<int>(_auto_mode));break;
+        case 2: print_data_line(s,"temp.output.value", _temp_sensors.get_output_temp());break;
+        case 3: print_data_line(s,"temp.output.status", static_cast<int>(_temp_sensors.get_output_status()));break;
+        case 4: print_data_line(s,"temp.output.ampl", _temp_sensors.get_output_ampl());break;
+        case 5: print_data_line(s,"temp.input.value", _temp_sensors.get_input_temp());break;
+        case 6: print_data_line(s,"temp.input.status", static_cast<int>(_temp_sensors.get_input_status()));break;
+        case 7: print_data_line(s,"temp.input.ampl", _temp_sensors.get_input_ampl());break;
+        case 8: print_data_line(s,"temp.sim", _temp_sensors.is_simulated()?1:0);break;
+        case 9: print_data_line(s,"storage.pending", _storage.is_commit_pending());break;
+        case 10: print_data_line(s,"tray_open", _sensors.tray_open);break;
+        case 11: print_data_line(s,"motor_temp_ok", !_sensors.feeder_overheat);break;
+        case 12: print_data_line(s,"pump", _pump.is_active());break;
+        case 13: print_data_line(s,"feeder", _feeder.is_active());break;
+        case 14: print_data_line(s,"fan", _fan.get_current_speed());break;
+        case 15: print_data_line(s,"network.ip", WiFi.localIP());break;
+        case 16: print_data_line(s,"network.ssid", WiFi.SSID());break;
+        case 17: print_data_line(s,"network.signal",WiFi.RSSI());break;
+        default: return false;
+    }
+    return true;
+}
 
+int Controller::SensorScanProducer::produce(char *buffer, std::size_t size) {
+    if (_done) return end_of_content;
+    if (_owner._temp_sensors.is_reading() || !_owner.is_safe_for_blocking()) return 0;
+    _done = true;
+    StringStreamExt s(buffer, size);
+    _owner.list_onewire_sensors(s);
+    auto sz = s.get_text().size();
+    return sz?static_cast<int>(sz):end_of_content;
+}
+
+int Controller::EventsProducer::produce(char *buffer, std::size_t size) {
+    //records are written in time order, the read starts at the last sent second
+    uint32_t from = _same?_last_ts - 1:_last_ts;
+    unsigned int skip = _same;
+    std::size_t pos = 0;
+    _owner._storage.get_event_log().read_since(from, [&](const EventRecord &rec) {
+        if (skip && rec.timestamp == _last_ts) {
+            --skip;
+            return true;
+        }
+        if (pos + sizeof(rec) > size) return false;
+        memcpy(buffer + pos, &rec, sizeof(rec));
+        pos += sizeof(rec);
+        if (rec.timestamp == _last_ts) ++_same;
+        else {
+            _last_ts = rec.timestamp;
+            _same = 1;
+        }
+        return true;
+    });
+    return pos?static_cast<int>(pos):end_of_content;
+}
+
+void Controller::storage_stats_out(Stream &s) {
+    const auto &eeprom = _storage.get_eeprom();
+    for (unsigned int i = 0; i < eeprom.page_count; ++i) {
+        s.print("flash.page");
+        s.print(i);
+        print_data_line(s, ".erases", eeprom.get_page_erase_count(i));
+    }
+    for (unsigned int i = 0; i < eeprom.total_files; ++i) {
+        s.print("flash.file");
+        s.print(i);
+        print_data_line(s, ".writes", eeprom.get_file_write_count(i));
+    }
+    print_data_line(s, "flash.writes.logical", eeprom.get_logical_writes());
+    print_data_line(s, "flash.writes.physical", eeprom.get_physical_writes());
+    if (eeprom.get_logical_writes()) {
+        print_data_line(s, "flash.write_amplification",
+                static_cast<float>(eeprom.get_physical_writes()) / eeprom.get_logical_writes());
+    }
+    print_data_line(s, "flash.crc_errors", eeprom.get_crc_error_counter());
+}
+
+static constexpr const char *metric_sensor_labels[] = {"output", "input"};
+static constexpr const char *metric_runtime_labels[] = {
+        "active", "fan", "pump", "feeder", "full_power", "low_power",
+        "cooling", "stop", "overheat"};
+static constexpr const char *metric_start_labels[] = {"feeder", "fan", "pump"};
+static constexpr const char *metric_mode_labels[] = {"full_power", "low_power", "cooling", "stop"};
+static constexpr const char *metric_event_labels[] = {
+        "restart", "overheat", "feeder_overheat", "tray_open", "temp_read_failure"};
+static constexpr const char *metric_write_labels[] = {"logical", "physical"};
+
+bool Controller::tasks_out(Stream &s, unsigned int item) {
+    if (item >= _scheduler.task_count) return false;
+    const AbstractTask *t = _scheduler.get_task(item);
+    print(s,get_task_name(t)," ",t->_run_time," ",t->get_scheduled_time(),"\r\n");
+    return true;
+}
 
+bool Controller::metrics_out(Stream &s, unsigned int item) {
+    using Eeprom = std::remove_reference_t<decltype(_storage.get_eeprom())>;
+    static constexpr MetricFamily<Controller> metrics[] = {
+        {"kotel_temperature_celsius", MetricType::gauge, "celsius",
+            "Measured temperature", std::size(metric_sensor_labels),
+            [](Controller &c, Stream &s, unsigned int i) {
+                print_metric_label(s, "sensor", metric_sensor_labels[i]);
+                print_metric_value(s, i?c._temp_sensors.get_input_temp():c._temp_sensors.get_output_temp());
+        }},
+        {"kotel_temperature_trend_celsius", MetricType::gauge, "celsius",
+            "Temperature extrapolated from recent samples", std::size(metric_sensor_labels),
+            [](Controller &c, Stream &s, unsigned int i) {
+                print_metric_label(s, "sensor", metric_sensor_labels[i]);
+                print_metric_value(s, i?c._temp_sensors.get_input_ampl():c._temp_sensors.get_output_ampl());
+        }},
+        {"kotel_temperature_sensor_status", MetricType::gauge, nullptr,
+            "Status of temperature sensor (0 - ok)", std::size(metric_sensor_labels),
+            [](Controller &c, Stream &s, unsigned int i) {
+                print_metric_label(s, "sensor", metric_sensor_labels[i]);
+                print_metric_value(s, static_cast<int>(i?c._temp_sensors.get_input_status():c._temp_sensors.get_output_status()));
+        }},
+        {"kotel_runtime_seconds", MetricType::counter, "seconds",
+            "Time spent in state", std::size(metric_runtime_labels),
+            [](Controller &c, Stream &s, unsigned int i) {
+                const auto &st = c._storage;
+                const uint32_t values[] = {
+                        st.runtm2.active_time, st.runtm.fan_time, st.runtm.pump_time,
+                        st.tray.feeder_time, st.runtm.full_power_time, st.runtm.low_power_time,
+                        st.runtm.cooling_time, st.runtm2.stop_time, st.runtm2.overheat_time};
+                static_assert(std::size(values) == std::size(metric_runtime_labels));
+                print_metric_label(s, "state", metric_runtime_labels[i]);
+                print_metric_value(s, values[i]);
+        }},
+        {"kotel_starts", MetricType::counter, nullptr,
+            "Count of starts of device", std::size(metric_start_labels),
+            [](Controller &c, Stream &s, unsigned int i) {
+                const auto &cn = c._storage.cntr1;
+                const uint32_t values[] = {cn.feeder_start_count, cn.fan_start_count, cn.pump_start_count};
+                static_assert(std::size(values) == std::size(metric_start_labels));
+                print_metric_label(s, "device", metric_start_labels[i]);
+                print_metric_value(s, values[i]);
+        }},
+        {"kotel_mode_entries", MetricType::counter, nullptr,
+            "Count of switches to mode", std::size(metric_mode_labels),
+            [](Controller &c, Stream &s, unsigned int i) {
+                const auto &cn = c._storage.cntr2;
+                const uint32_t values[] = {cn.full_power_count, cn.low_power_count, cn.cool_count, cn.stop_count};
+                static_assert(std::size(values) == std::size(metric_mode_labels));
+                print_metric_label(s, "mode", metric_mode_labels[i]);
+                print_metric_value(s, values[i]);
+        }},
+        {"kotel_events", MetricType::counter, nullptr,
+            "Count of events", std::size(metric_event_labels),
+            [](Controller &c, Stream &s, unsigned int i) {
+                const auto &st = c._storage;
+                const uint32_t values[] = {
+                        st.cntr1.restart_count, st.cntr1.overheat_count, st.cntr1.feeder_overheat_count,
+                        st.cntr1.tray_open_count, st.cntr2.temp_read_failure_count};
+                static_assert(std::size(values) == std::size(metric_event_labels));
+                print_metric_label(s, "event", metric_event_labels[i]);
+                print_metric_value(s, values[i]);
+        }},
+        {"kotel_tray_fill_kilograms", MetricType::gauge, "kilograms",
+            "Estimated fuel in tray", 1,
+            [](Controller &c, Stream &s, unsigned int) {
+                print_metric_value(s, c._storage.tray.calc_tray_fill());
+        }},
+        {"kotel_fuel_consumed_kilograms", MetricType::counter, "kilograms",
+            "Total consumed fuel", 1,
+            [](Controller &c, Stream &s, unsigned int) {
+                print_metric_value(s, c._storage.tray.calc_total_consumed_fuel());
+        }},
+        {"kotel_wifi_rssi_dbm", MetricType::gauge, "dbm",
+            "WiFi signal strength", 1,
+            [](Controller &c, Stream &s, unsigned int) {
+                print_metric_value(s, static_cast<int>(c._network.get_rssi()));
+        }},
+        {"kotel_task_run_time_seconds", MetricType::gauge, "seconds",
+            "Run time of task (peak, slowly decaying)", decltype(_scheduler)::task_count,
+            [](Controller &c, Stream &s, unsigned int i) {
+                const AbstractTask *t = c._scheduler.get_task(i);
+                print_metric_label(s, "task", c.get_task_name(t));
+                print_metric_value(s, t->_run_time * 0.001f, 3);
+        }},
+        {"kotel_flash_page_erases", MetricType::counter, nullptr,
+            "Count of erases of flash page", Eeprom::page_count,
+            [](Controller &c, Stream &s, unsigned int i) {
+                print_metric_label(s, "page", i);
+                print_metric_value(s, c._storage.get_eeprom().get_page_erase_count(i));
+        }},
+        {"kotel_flash_file_writes", MetricType::counter, nullptr,
+            "Count of writes of file", Eeprom::total_files,
+            [](Controller &c, Stream &s, unsigned int i) {
+                print_metric_label(s, "file", i);
+                print_metric_value(s, c._storage.get_eeprom().get_file_write_count(i));
+        }},
+        {"kotel_flash_writes", MetricType::counter, nullptr,
+            "Count of writes to flash", std::size(metric_write_labels),
+            [](Controller &c, Stream &s, unsigned int i) {
+                const auto &eeprom = c._storage.get_eeprom();
+                print_metric_label(s, "kind", metric_write_labels[i]);
+                print_metric_value(s, i?eeprom.get_physical_writes():eeprom.get_logical_writes());
+        }},
+        {"kotel_flash_crc_errors", MetricType::counter, nullptr,
+            "Count of CRC errors found in flash", 1,
+            [](Controller &c, Stream &s, unsigned int) {
+                print_metric_value(s, c._storage.get_eeprom().get_crc_error_counter());
+        }},
+    };
+    return print_metric_item(s, metrics, *this, item);
 }
 
 void Controller::control_pump() {
@@ -533,16 +761,21 @@ void Controller::run_other_mode() {
 
 void Controller::run_stop_mode() {
     if (_cur_mode != DriveMode::stop) {
+        uint16_t reason = 0;
         ++_storage.cntr2.stop_count;
         if (!_temp_sensors.get_output_temp()) {
             ++_storage.cntr2.temp_read_failure_count;
+            reason |= stop_temp_read_failure;
         } else if (is_overheat()) {
             ++_storage.cntr1.overheat_count;
+            reason |= stop_overheat;
         }
         if (_sensors.feeder_overheat) {
             ++_storage.cntr1.feeder_overheat_count;
+            reason |= stop_feeder_overheat;
         }
-        _storage.save();
+        _storage.save(_storage.cntr1, _storage.cntr2);
+        log_event(EventType::stop, reason);
     }
     _cur_mode = DriveMode::stop;
     _auto_mode = AutoMode::notset;
@@ -587,7 +820,6 @@ void Controller::send_file(MyHttpServer::Request &req, std::string_view content_
             i = f.get();
         }
     }
-    req.client->stop();
 }
 #endif
 
@@ -605,7 +837,15 @@ constexpr std::pair<const char *, float SimulInfo::*> simulate_temp_table[] = {
 
 void Controller::handle_server(MyHttpServer::Request &req) {
 
-    using Ctx = MyHttpServer::ContentType;
+    static constexpr auto router = make_router<RouteHandler>({
+        {"/api/code",       HttpMethod::POST,   &Controller::api_code},
+        {"/api/config",     HttpMethod::GET,    &Controller::api_config},
+        {"/api/scan_temp",  HttpMethod::POST,   &Controller::api_scan_temp},
+        {"/api/status",     HttpMethod::GET,    &Controller::api_status},
+        {"/api/ws",         HttpMethod::GET,    &Controller::api_ws},
+        {"/metrics",        HttpMethod::GET,    &Controller::api_metrics},
+    });
+    static_assert(router.valid(), "Router table can't be built");
 
     auto &_server = _network.get_server();
 
@@ -614,63 +854,37 @@ void Controller::handle_server(MyHttpServer::Request &req) {
     if (req.request_line.method == HttpMethod::WS) {
         handle_ws_request(req);
         return;
-    } else if (req.request_line.path == "/api/scan_temp" && req.request_line.method == HttpMethod::POST) {
-        if (_list_temp_async.has_value()) {
-            _server.error_response(req, 503, "Service unavailable" , {}, {});
-        } else {
-            _server.send_simple_header(req, Ctx::text);
-            _list_temp_async.emplace(std::move(*req.client));
+    }
+    std::string_view path = req.request_line.path;
+    std::string_view query;
+    auto qpos = path.find('?');
+    if (qpos != path.npos) {
+        query = path.substr(qpos+1);
+        path = path.substr(0, qpos);
+    }
+    auto match = router.find(req.request_line.method, path);
+    if (match.route) {
+        (this->*match.route->handler)(req, RouteQuery(query));
+    } else if (match.allowed) {
+        char allow[48];
+        _server.error_response(req, 405, "Method not allowed", {{"Allow", router.format_allow(allow, match.allowed)}});
+    } else if (auto asset = find_embedded_asset(path)) {
+        if (req.request_line.method != HttpMethod::GET) {
+            _server.error_response(req, 405, "Method not allowed", {{"Allow", "GET"}});
             return;
         }
-    } else if (req.request_line.path == "/api/code" && req.request_line.method == HttpMethod::POST) {
-        if (req.body.empty()) {
-            generate_otp_code();
-            _display.display_code( _last_code);
-            _server.error_response(req, 202, {});
-        } else if (std::string_view(_last_code.data(), _last_code.size()) == req.body) {
-            static_buff.clear();
-            gen_and_print_token();
-            _server.send_file_async(req, Ctx::text, static_buff.get_text(), false);
-            std::fill(_last_code.begin(), _last_code.end(),0);
-        } else {
-            _server.error_response(req, 409, "Conflict", {}, "code doesn't match");
+        using Cc = MyHttpServer::CacheControl;
+        //referenced with version (?v=) - the content never changes under the same URL
+        std::string_view cache_control = qpos != req.request_line.path.npos?Cc::immutable:Cc::revalidate;
+        if (asset->cache_control == cache_control
+                && _server.send_prebuilt_async(req, asset->response, asset->not_modified, asset->etag)) {
+            return; //connection is owned by the server until the content is sent
         }
-
-    } else if (req.request_line.path.substr(0,7) == "/api/ws" && req.request_line.method == HttpMethod::GET) {
-        uint16_t code = 0;
-        auto q = req.request_line.path.substr(7);
-        if (q.substr(0,7) != "?token=") {
-            code = 4020;
-        } else {
-            q = q.substr(7);
-            auto tkn = generate_signed_token(q);
-            if (std::string_view(tkn.data(), tkn.size()) != q) {
-                code = 4090;
-            }
-        }
-        auto iter = std::find_if(req.headers, req.headers+req.headers_count, [&](const auto &hdr){
-            return icmp(hdr.first,"Sec-WebSocket-Key");
-        });
-        if (iter != req.headers+req.headers_count) {
-            auto accp = ws::calculate_ws_accept(iter->second);
-            _server.send_header(req,{
-                {"Upgrade","websocket"},
-                {"Connection","upgrade"},
-                {"Sec-WebSocket-Accept",accp}
-            },101,"Switching protocols");
-            if (code) {
-                _server.send_ws_message(req, ws::Message{"",ws::Type::connClose, code});
-            } else {
-                 return;
-            }
-        } else {
-            _server.error_response(req,400,{});
-        }
-    } else if (req.request_line.path == "/") {
-        _server.send_file_async(req, HttpServerBase::ContentType::html, embedded_index_html, true, embedded_index_html_etag);
+        _server.send_file_async(req, asset->content_type, asset->content, true, asset->etag, cache_control);
 #ifdef EMULATOR
     } else {
-        std::string_view ext = req.request_line.path.substr(req.request_line.path.find('.')+1);
+        using Ctx = MyHttpServer::ContentType;
+        std::string_view ext = path.substr(path.find('.')+1);
         std::string_view ctx;
         if (ext == "html") ctx = Ctx::html;
         else if (ext == "js") ctx = Ctx::javascript;
@@ -683,9 +897,77 @@ void Controller::handle_server(MyHttpServer::Request &req) {
         _server.error_response(req, 404, "Not found");
     }
 #endif
-    req.client->stop();
+    //connection is closed by the server, if the response doesn't allow keep-alive
+}
+
+void Controller::send_with_token(MyHttpServer::Request &req, const RouteQuery &query,
+        std::string_view content_type, ResponseProducer &producer) {
+    auto &_server = _network.get_server();
+    if (check_token(query)) {
+        _server.error_response(req, 403, {});
+    } else if (!_server.send_async(req, content_type, producer)) {
+        _server.error_response(req, 503, "Service unavailable" , {}, {});
+    }
+    //otherwise the connection is owned by the server until the content is sent
+}
+
+void Controller::api_scan_temp(MyHttpServer::Request &req, const RouteQuery &) {
+    auto &_server = _network.get_server();
+    if (!_server.send_async(req, MyHttpServer::ContentType::text, _sensor_scan)) {
+        _server.error_response(req, 503, "Service unavailable" , {}, {});
+    }
 }
 
+void Controller::api_config(MyHttpServer::Request &req, const RouteQuery &query) {
+    send_with_token(req, query, MyHttpServer::ContentType::text, _config_producer);
+}
+
+void Controller::api_status(MyHttpServer::Request &req, const RouteQuery &query) {
+    send_with_token(req, query, MyHttpServer::ContentType::text, _status_producer);
+}
+
+void Controller::api_metrics(MyHttpServer::Request &req, const RouteQuery &query) {
+    send_with_token(req, query, MyHttpServer::ContentType::openmetrics, _metrics_producer);
+}
+
+void Controller::api_code(MyHttpServer::Request &req, const RouteQuery &) {
+    auto &_server = _network.get_server();
+    if (req.body.empty()) {
+        generate_otp_code();
+        _display.display_code( _last_code);
+        _server.error_response(req, 202, {});
+    } else if (std::string_view(_last_code.data(), _last_code.size()) == req.body) {
+        static_buff.clear();
+        gen_and_print_token();
+        //static_buff is shared by all connections, send it now
+        _server.send_file(req, MyHttpServer::ContentType::text, static_buff.get_text(), false);
+        std::fill(_last_code.begin(), _last_code.end(),0);
+    } else {
+        _server.error_response(req, 409, "Conflict", {}, "code doesn't match");
+    }
+}
+
+void Controller::api_ws(MyHttpServer::Request &req, const RouteQuery &query) {
+    auto &_server = _network.get_server();
+    uint16_t code = check_token(query);
+    auto iter = std::find_if(req.headers, req.headers+req.headers_count, [&](const auto &hdr){
+        return icmp(hdr.first,"Sec-WebSocket-Key");
+    });
+    if (iter != req.headers+req.headers_count) {
+        auto accp = ws::calculate_ws_accept(iter->second);
+        _server.send_header(req,{
+            {"Upgrade","websocket"},
+            {"Connection","upgrade"},
+            {"Sec-WebSocket-Accept",accp}
+        },101,"Switching protocols");
+        if (code) {
+            _server.send_ws_message(req, ws::Message{"",ws::Type::connClose, code});
+            req.client->stop();
+        }
+    } else {
+        _server.error_response(req,400,{});
+    }
+}
 
 
 
@@ -754,7 +1036,8 @@ TimeStampMs Controller::update_motorhours(TimeStampMs now) {
     ++stor.runtm2.active_time;
 
     if (now >= _flush_time) {
-        stor.save();
+        //counters of starts are incremented without save, store them here
+        stor.save(stor.tray, stor.runtm, stor.runtm2, stor.cntr1, stor.cntr2);
         _flush_time = now+60000;
     }
     return 1000;
@@ -785,14 +1068,14 @@ bool Controller::set_fuel(const SetFuelParams &sfp) {
     }
 
     _storage.tray.tray_fill_time = filltime;
-    _storage.save();
+    _storage.save(_storage.tray);
     return true;
 
 
 }
 
 void Controller::factory_reset() {
-    _storage.get_eeprom().erase_all();
+    _storage.erase_all();
     while (true) {
         delay(1);
     }
@@ -832,7 +1115,7 @@ TimeStampMs Controller::auto_drive_cycle(TimeStampMs cur_time) {
             case AutoMode::lowpower: _storage.cntr2.low_power_count++;break;
             default: break;
         }
-        _storage.save();
+        _storage.save(_storage.cntr2);
     }
 
     const Profile *p;
@@ -878,6 +1161,10 @@ void Controller::handle_ws_request(MyHttpServer::Request &req)
     auto &_server = _network.get_server();
 
     auto msg = req.body;
+    if (msg.size() >= ws_request_id_size && msg[0] == static_cast<char>(WsReqCmd::request_id)) {
+        static_buff.write(msg.data(), ws_request_id_size);
+        msg = msg.substr(ws_request_id_size);
+    }
     if (msg.empty()) return;
     WsReqCmd cmd = static_cast<WsReqCmd>(msg[0]);
     msg = msg.substr(1);
@@ -902,8 +1189,11 @@ void Controller::handle_ws_request(MyHttpServer::Request &req)
     }
     break;
     case WsReqCmd::get_config: {
-        config_out(static_buff);
-        _server.send_ws_message(req, ws::Message{static_buff.get_text(), ws::Type::text});
+        if (!_server.send_ws_async(req, ws::Type::text, _config_producer, static_buff.get_text())) {
+            //producer is busy (HTTP response), send what fits to the buffer
+            config_out(static_buff);
+            _server.send_ws_message(req, ws::Message{static_buff.get_text(), ws::Type::text});
+        }
     }
     break;
     case WsReqCmd::get_stats: {
@@ -918,6 +1208,19 @@ void Controller::handle_ws_request(MyHttpServer::Request &req)
         static_buff.write(reinterpret_cast<const char *>(&consumed_kg_total), sizeof(consumed_kg_total));
         static_buff.write(reinterpret_cast<const char *>(&cntr), sizeof(cntr));
         static_buff.write(reinterpret_cast<const char *>(&timestamp), sizeof(timestamp));
+        const auto &eeprom = _storage.get_eeprom();
+        static_assert(Storage::FileStorage::page_count == 6 && Storage::FileStorage::total_files == 11,
+                "Update StatsOutWs in binary_formats.js");
+        uint32_t flash_writes[2] = {eeprom.get_logical_writes(), eeprom.get_physical_writes()};
+        static_buff.write(reinterpret_cast<const char *>(flash_writes), sizeof(flash_writes));
+        for (unsigned int i = 0; i < eeprom.page_count; ++i) {
+            uint32_t n = eeprom.get_page_erase_count(i);
+            static_buff.write(reinterpret_cast<const char *>(&n), sizeof(n));
+        }
+        for (unsigned int i = 0; i < eeprom.total_files; ++i) {
+            uint32_t n = eeprom.get_file_write_count(i);
+            static_buff.write(reinterpret_cast<const char *>(&n), sizeof(n));
+        }
         _server.send_ws_message(req, ws::Message{static_buff.get_text(), ws::Type::binary});
     }
     break;
@@ -970,10 +1273,10 @@ void Controller::handle_ws_request(MyHttpServer::Request &req)
         _server.send_ws_message(req, ws::Message{static_buff.get_text(), ws::Type::binary});
     break;
     case WsReqCmd::enum_tasks:
-        _scheduler.enum_tasks([&](const AbstractTask *t){
-            print(static_buff,get_task_name(t)," ",t->_run_time," ",t->get_scheduled_time(),"\r\n");
-        });
-        _server.send_ws_message(req, ws::Message{static_buff.get_text(), ws::Type::text});
+        if (!_server.send_ws_async(req, ws::Type::text, _tasks_producer, static_buff.get_text())) {
+            for (unsigned int i = 0; tasks_out(static_buff, i); ++i);
+            _server.send_ws_message(req, ws::Message{static_buff.get_text(), ws::Type::text});
+        }
         break;
     case WsReqCmd::generate_code:
         generate_otp_code();
@@ -989,6 +1292,21 @@ void Controller::handle_ws_request(MyHttpServer::Request &req)
         _server.send_ws_message(req, ws::Message{static_buff.get_text(), ws::Type::text});
         delay(10000);   //delay more than 5 sec invokes WDT
         break;
+    case WsReqCmd::get_events: if (msg.size() == sizeof(uint32_t)) {
+        uint32_t since;
+        std::copy(msg.begin(), msg.end(), reinterpret_cast<char *>(&since));
+        //the first byte is set when the producer is busy (no records
+        //are sent), the client repeats the request later
+        if (_events_producer.is_busy()) {
+            static_buff.write(static_cast<char>(1));
+            _server.send_ws_message(req, ws::Message{static_buff.get_text(), ws::Type::binary});
+            break;
+        }
+        static_buff.write(static_cast<char>(0));
+        _events_producer.set_since(since);
+        _server.send_ws_async(req, ws::Type::binary, _events_producer, static_buff.get_text());
+    }
+    break;
     case WsReqCmd::clear_stats:
         _storage.tray.commit_consumed(_storage.tray.feeder_time);
         _storage.tray.feeder_time = _storage.tray.feeder_time - _storage.tray.tray_fill_time ;
@@ -999,14 +1317,80 @@ void Controller::handle_ws_request(MyHttpServer::Request &req)
         _storage.cntr2 = {};
         _storage.runtm = {};
         _storage.runtm2 = {};
-        _storage.save();
+        _storage.save(_storage.tray, _storage.cntr1, _storage.cntr2, _storage.runtm, _storage.runtm2);
         _server.send_ws_message(req, ws::Message{static_buff.get_text(), ws::Type::text});
         break;
+    case WsReqCmd::scan_sensors: {
+        //the scan blocks, it is done later when it is safe. Other
+        //requests are processed meanwhile
+        auto iter = std::find_if(std::begin(_deferred_scans), std::end(_deferred_scans), [](const DeferredWsReply &r){
+            return r.session == MyHttpServer::no_ws_session_id;
+        });
+        auto session = _server.get_ws_session(req);
+        if (iter == std::end(_deferred_scans) || session == MyHttpServer::no_ws_session_id) {
+            //too many requests, reply empty list
+            _server.send_ws_message(req, ws::Message{static_buff.get_text(), ws::Type::text});
+        } else {
+            auto prefix = static_buff.get_text();
+            iter->session = session;
+            iter->prefix_len = static_cast<uint8_t>(prefix.copy(iter->prefix, sizeof(iter->prefix)));
+        }
+    }
+    break;
+    case WsReqCmd::subscribe_status: {
+        bool subscribe = msg.empty() || msg[0] != 0;
+        static_buff.print(_server.set_ws_subscription(req, subscribe)?'\x0':'\x1');
+        _server.send_ws_message(req, ws::Message{static_buff.get_text(), ws::Type::binary});
+        //first status immediately
+        _next_status_broadcast = 0;
+    }
+    break;
     default:
         break;
     }
 }
 
+void Controller::broadcast_status(TimeStampMs cur_time) {
+    auto &_server = _network.get_server();
+    if (cur_time < _next_status_broadcast || !_server.get_ws_subscribers()) return;
+    _next_status_broadcast = cur_time + 1000;
+    //encoded once for all sessions
+    static_buff.clear();
+    static_buff.write(static_cast<char>(WsReqCmd::status_broadcast));
+    status_out_ws(static_buff);
+    _server.broadcast_ws_message(ws::Message{static_buff.get_text(), ws::Type::binary});
+}
+
+void Controller::finish_ws_requests() {
+    auto &_server = _network.get_server();
+    std::size_t result_size = 0;
+    bool scan_done = false;
+    for (auto &r: _deferred_scans) {
+        if (r.session == MyHttpServer::no_ws_session_id) continue;
+        if (!_server.is_ws_session_open(r.session)) {
+            r = {};
+            continue;
+        }
+        if (!scan_done) {
+            if (_temp_sensors.is_reading() || !is_safe_for_blocking()) return;
+            //one scan serves all waiting requests
+            static_buff.clear();
+            list_onewire_sensors(static_buff);
+            result_size = static_buff.get_text().size();
+            scan_done = true;
+        }
+        //the reply is built behind the result of the scan
+        static_buff.write(r.prefix, r.prefix_len);
+        static_buff.write(static_buff.get_text().data(), result_size);
+        auto reply = static_buff.get_text().substr(result_size);
+        if (_server.send_ws_session_message(r.session, ws::Message{reply, ws::Type::text})
+                || !_server.is_ws_session_open(r.session)) {
+            r = {};
+        }
+        static_buff.truncate(result_size);
+    }
+}
+
 struct StatusOutWs {
     uint32_t cur_time;
     uint32_t feeder_time;
@@ -1029,6 +1413,7 @@ struct StatusOutWs {
     uint8_t pump;
     uint8_t feeder;
     uint8_t fan;
+    uint8_t storage_pending;
 };
 
 static int16_t encode_temp(std::optional<float> v) {
@@ -1062,11 +1447,40 @@ void Controller::status_out_ws(Stream &s) {
         static_cast<uint8_t>(_pump.is_active()?1:0),
         static_cast<uint8_t>(_feeder.is_active()?1:0),
         static_cast<uint8_t>(_fan.get_current_speed()),
+        static_cast<uint8_t>(_storage.is_commit_pending()?1:0),
     };
     s.write(reinterpret_cast<const char *>(&st), sizeof(st));
 }
 
 
+void Controller::log_event(EventType type, uint16_t arg) {
+    EventRecord rec;
+    rec.timestamp = get_current_time();
+    rec.type = type;
+    rec.mode = static_cast<uint8_t>(_cur_mode);
+    rec.temp_output = encode_temp(_temp_sensors.get_output_temp());
+    rec.temp_input = encode_temp(_temp_sensors.get_input_temp());
+    rec.arg = arg;
+    if (is_current_time_set()) {
+        commit_deferred_events();
+        _storage.log_event(rec);
+    } else {
+        //uptime based timestamp would break order of the log
+        _storage.defer_event(rec);
+    }
+}
+
+void Controller::commit_deferred_events() {
+    if (!is_current_time_set()) return;
+    uint32_t uptime = static_cast<uint32_t>(get_current_timestamp()/1000);
+    _storage.commit_deferred_events(get_current_time() - uptime);
+}
+
+TimeStampMs Controller::storage_commit(TimeStampMs) {
+    //one sector per call, check for new changes every 100ms
+    return _storage.commit_step()?1:100;
+}
+
 TimeStampMs Controller::read_serial(TimeStampMs) {
     while (handle_serial(*this));
     return 250;
@@ -1083,6 +1497,8 @@ std::string_view Controller::get_task_name(const AbstractTask *task) {
     if (task == &_network) return "network";
     if (task == &_read_serial) return "read_serial";
     if (task == &_refresh_wdt) return "wdt";
+    if (task == &_keyboard_scanner) return "keyboard";
+    if (task == &_storage_commit) return "storage_commit";
     return "unknown";
 }
 
@@ -1132,6 +1548,27 @@ std::array<char, 20> Controller::generate_token_random_code() {
 }
 
 std::array<char, 40> Controller::generate_signed_token(std::string_view random) {
+    std::array<char, 40> out;
+    std::array<char, 20> tmp;
+    std::fill(tmp.begin(), tmp.end(), 'A');
+    std::fill(out.begin(), out.end(), 'A');
+    random = random.substr(0, 20);
+    std::copy(random.begin(), random.end(), tmp.begin());
+    std::copy(random.begin(), random.end(), out.begin());
+    //key midstate is cached, signing costs two compressions
+    auto digest = _token_key.sign(std::string_view(tmp.data(), tmp.size()));
+    std::array<char, (TokenHash::digest_size + 2) / 3 * 4> digest_base64;
+    base64url.encode(digest.begin(), digest.end(), digest_base64.begin());
+    std::copy(digest_base64.begin(), digest_base64.begin() + 20, out.begin()+20);
+    return out;
+}
+
+void Controller::update_token_key() {
+    const auto &secret = _storage.pair_secret.password.text;
+    _token_key.set_key(std::string_view(secret, sizeof(secret)));
+}
+
+std::array<char, 40> Controller::generate_legacy_token(std::string_view random) {
     std::array<char, 40> out;
     std::array<char, 20> tmp;
     std::fill(tmp.begin(), tmp.end(), 'A');
@@ -1150,11 +1587,23 @@ std::array<char, 40> Controller::generate_signed_token(std::string_view random)
     return out;
 }
 
+uint16_t Controller::check_token(const RouteQuery &query) {
+    auto token = query.get("token");
+    if (!token.has_value()) return 4020;
+    auto tkn = generate_signed_token(*token);
+    if (digest_equal(std::string_view(tkn.data(), tkn.size()), *token)) return 0;
+    //tokens paired before HMAC signing
+    tkn = generate_legacy_token(*token);
+    if (digest_equal(std::string_view(tkn.data(), tkn.size()), *token)) return 0;
+    return 4090;
+}
+
 void Controller::generate_pair_secret() {
     SATSE.begin();
     SATSE.random(reinterpret_cast<unsigned char *>(_storage.pair_secret.password.text), sizeof(_storage.pair_secret.password.text));
     SATSE.end();
-    _storage.save();
+    _storage.save(_storage.pair_secret);
+    update_token_key();
 }
 
 void Controller::gen_and_print_token() {
@@ -1220,7 +1669,7 @@ TimeStampMs Controller::run_keyboard(TimeStampMs cur_time) {
             if (stop_btn.stabilize(stop_btn_start_interval_ms)) {
                 _storage.config.operation_mode = 1;
                 stop_btn.set_user_state();
-                _storage.save();
+                _storage.save(_storage.config);
             }
         } else {
             if (stop_btn.stabilize(default_btn_release_interval_ms)) {
@@ -1228,7 +1677,7 @@ TimeStampMs Controller::run_keyboard(TimeStampMs cur_time) {
                     _storage.config.operation_mode = 0;
                     _feeder.stop();
                     _fan.stop();
-                    _storage.save();
+                    _storage.save(_storage.config);
                 }
             }
         }
@@ -8,6 +8,9 @@
 #include "pump.h"
 #include "http_server.h"
 #include "http_utils.h"
+#include "open_metrics.h"
+#include "http_router.h"
+#include "hmac.h"
 #include <WDT.h>
 
 #include "ntp.h"
@@ -16,6 +19,18 @@
 #include "network_control.h"
 
 #include "keyboard.h"
+
+///sign tokens by HMAC-SHA256 instead of HMAC-SHA1 (tokens signed by the other variant are not accepted)
+#ifndef TOKEN_HMAC_SHA256
+#define TOKEN_HMAC_SHA256 0
+#endif
+
+#if TOKEN_HMAC_SHA256
+#include "sha256.h"
+#else
+#include "sha1.h"
+#endif
+
 namespace kotel {
 
 
@@ -56,6 +71,10 @@ public:
     };
 
     using MyHttpServer = NetworkControl::MyHttpServer;
+    ///parsed query string of request
+    using RouteQuery = QueryParams<4>;
+    ///handler of route
+    using RouteHandler = void (Controller::*)(MyHttpServer::Request &req, const RouteQuery &query);
 
     Controller();
     void begin();
@@ -63,6 +82,19 @@ public:
 
     void config_out(Stream &s);
     void status_out(Stream &s);
+    ///print one line of config
+    /** @retval false no more lines */
+    bool config_out(Stream &s, unsigned int item);
+    ///print one line of status
+    /** @retval false no more lines */
+    bool status_out(Stream &s, unsigned int item);
+    ///print one item of metrics (OpenMetrics text format)
+    /** @retval false no more items */
+    bool metrics_out(Stream &s, unsigned int item);
+    ///print one line of list of tasks (name, run time, scheduled time)
+    /** @retval false no more lines */
+    bool tasks_out(Stream &s, unsigned int item);
+    void storage_stats_out(Stream &s);
     bool config_update(std::string_view body, std::string_view &&failed_field = {});
     void list_onewire_sensors(Stream &s);
 
@@ -99,6 +131,10 @@ public:
     };
 
     void handle_server(MyHttpServer::Request &req);
+    ///broadcast status to subscribed websocket sessions (once per second)
+    void broadcast_status(TimeStampMs cur_time);
+    ///send replies of deferred websocket requests which are complete
+    void finish_ws_requests();
 
 
 struct SetFuelParams {
@@ -130,8 +166,45 @@ protected:
     TimeStampMs auto_drive_cycle(TimeStampMs cur_time);
     TimeStampMs read_serial(TimeStampMs cur_time);
     TimeStampMs refresh_wdt(TimeStampMs cur_time);
+    TimeStampMs storage_commit(TimeStampMs cur_time);
 protected:
 
+    ///Produces list of onewire sensors
+    /**
+     * The scan blocks, so it waits until the temperature sensors are idle
+     * and blocking is safe
+     */
+    class SensorScanProducer: public ResponseProducer {
+    public:
+        SensorScanProducer(Controller &owner):_owner(owner) {}
+        virtual int produce(char *buffer, std::size_t size) override;
+    protected:
+        virtual void on_start() override {_done = false;}
+        Controller &_owner;
+        bool _done = false;
+    };
+
+    ///Produces records of the event log newer than given timestamp
+    /**
+     * The log is read once per produced chunk. The position is kept as
+     * timestamp of the last sent record and count of sent records having
+     * this timestamp, so records of the same second are never lost or
+     * repeated, regardless on their count
+     */
+    class EventsProducer: public ResponseProducer {
+    public:
+        EventsProducer(Controller &owner):_owner(owner) {}
+        ///set timestamp, records newer than this timestamp are produced
+        void set_since(uint32_t since) {_since = since;}
+        virtual int produce(char *buffer, std::size_t size) override;
+    protected:
+        virtual void on_start() override {_last_ts = _since; _same = 0;}
+        Controller &_owner;
+        uint32_t _since = 0;
+        uint32_t _last_ts = 0;
+        unsigned int _same = 0;
+    };
+
 
     Sensors _sensors;
 
@@ -147,6 +220,28 @@ protected:
     TimeStampMs _time_resync = 0;
     TimeStampMs _last_net_activity = max_timestamp;
     TimeStampMs _start_mode_until = 0;
+    TimeStampMs _next_status_broadcast = 0;
+
+    ///Websocket request which is answered later
+    struct DeferredWsReply {
+        MyHttpServer::WsSessionId session = MyHttpServer::no_ws_session_id;
+        ///beginning of the reply (request id and command)
+        char prefix[3] = {};
+        uint8_t prefix_len = 0;
+    };
+    static constexpr unsigned int max_deferred_ws_replies = 4;
+    ///size of the request id prefix ('@' and id)
+    static constexpr unsigned int ws_request_id_size = 2;
+    ///requests waiting for sensor scan
+    DeferredWsReply _deferred_scans[max_deferred_ws_replies];
+
+#if TOKEN_HMAC_SHA256
+    using TokenHash = SHA256;
+#else
+    using TokenHash = SHA1;
+#endif
+    ///key of tokens (pair secret) with cached HMAC midstate
+    HmacKey<TokenHash> _token_key;
 
 
 
@@ -161,9 +256,15 @@ protected:
     TaskMethod<Controller, &Controller::read_serial> _read_serial;
     TaskMethod<Controller, &Controller::refresh_wdt> _refresh_wdt;
     TaskMethod<Controller, &Controller::run_keyboard> _keyboard_scanner;
+    TaskMethod<Controller, &Controller::storage_commit> _storage_commit;
     NetworkControl _network;
-    Scheduler<10> _scheduler;
-    std::optional<TCPClient> _list_temp_async;
+    Scheduler<11> _scheduler;
+    SensorScanProducer _sensor_scan;
+    EventsProducer _events_producer;
+    ItemProducerMethod<Controller, &Controller::config_out> _config_producer;
+    ItemProducerMethod<Controller, &Controller::status_out> _status_producer;
+    ItemProducerMethod<Controller, &Controller::metrics_out> _metrics_producer;
+    ItemProducerMethod<Controller, &Controller::tasks_out> _tasks_producer;
     StringStream<1024> static_buff;
     std::array<char, 4> _last_code;
     IPAddress _my_ip;
@@ -193,7 +294,17 @@ protected:
         generate_code = 'G',
         unpair_all ='U',
         reset = '!',
-        clear_stats = '0'
+        clear_stats = '0',
+        get_events = 'E',
+        ///scan onewire sensors, reply is sent when the scan is possible
+        scan_sensors = 'D',
+        ///optional prefix of request: '@' and id byte. Reply has the same
+        ///prefix, so the client can match replies sent out of order
+        request_id = '@',
+        ///subscribe to status broadcast (payload 0 - unsubscribe)
+        subscribe_status = 's',
+        ///status broadcasted to subscribed sessions (not a request)
+        status_broadcast = 'b'
 
 
     };
@@ -207,14 +318,35 @@ protected:
 
     void handle_ws_request(MyHttpServer::Request &req);
     void send_file(MyHttpServer::Request &req, std::string_view content_type, std::string_view file_name);
+    ///send content of producer if the query contains valid token
+    void send_with_token(MyHttpServer::Request &req, const RouteQuery &query,
+            std::string_view content_type, ResponseProducer &producer);
+    void api_scan_temp(MyHttpServer::Request &req, const RouteQuery &query);
+    void api_config(MyHttpServer::Request &req, const RouteQuery &query);
+    void api_status(MyHttpServer::Request &req, const RouteQuery &query);
+    void api_metrics(MyHttpServer::Request &req, const RouteQuery &query);
+    void api_code(MyHttpServer::Request &req, const RouteQuery &query);
+    void api_ws(MyHttpServer::Request &req, const RouteQuery &query);
 
     bool set_fuel(const SetFuelParams &sfp);
     void status_out_ws(Stream &s);
+    void log_event(EventType type, uint16_t arg = 0);
+    void commit_deferred_events();
     std::string_view get_task_name(const AbstractTask *task);
     bool is_overheat() const;
     void generate_otp_code();
     std::array<char, 20> generate_token_random_code();
     std::array<char, 40> generate_signed_token(std::string_view random);
+    ///token signed by the scheme used before HMAC (SHA1 of random XOR secret)
+    std::array<char, 40> generate_legacy_token(std::string_view random);
+    ///compute midstate of the token key from the pair secret
+    void update_token_key();
+    ///check token in query string
+    /**
+     * @param query parsed query string (parameter token)
+     * @return 0 valid token, 4020 token missing, 4090 token is not valid
+     */
+    uint16_t check_token(const RouteQuery &query);
     void generate_pair_secret();
     void gen_and_print_token();
     //void update_time();
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+///HMAC key with cached midstate
+/**
+ * The key is padded and hashed once, when it is set. The object keeps
+ * state of the inner and outer hash after the first block. Signing of
+ * a short message then costs two compressions (the inner and the outer
+ * final block) instead of four
+ *
+ * @tparam Hash hash function (SHA1, SHA256). It must be copyable, and
+ * it must define block_size and digest_size
+ */
+template<typename Hash>
+class HmacKey {
+public:
+
+    using Digest = typename Hash::Digest;
+
+    constexpr HmacKey() = default;
+    constexpr HmacKey(std::string_view key) {set_key(key);}
+
+    ///set key, computes the midstate
+    constexpr void set_key(std::string_view key) {
+        unsigned char k[Hash::block_size] = {};
+        if (key.size() > Hash::block_size) {
+            auto d = Hash(key).final();
+            for (std::size_t i = 0; i < Hash::digest_size; ++i) k[i] = d[i];
+        } else {
+            for (std::size_t i = 0; i < key.size(); ++i) k[i] = static_cast<unsigned char>(key[i]);
+        }
+        char ipad[Hash::block_size] = {};
+        char opad[Hash::block_size] = {};
+        for (std::size_t i = 0; i < Hash::block_size; ++i) {
+            ipad[i] = static_cast<char>(k[i] ^ 0x36);
+            opad[i] = static_cast<char>(k[i] ^ 0x5C);
+        }
+        _inner = Hash();
+        _inner.update(std::string_view(ipad, Hash::block_size));
+        _outer = Hash();
+        _outer.update(std::string_view(opad, Hash::block_size));
+    }
+
+    ///sign message
+    constexpr Digest sign(std::string_view message) const {
+        Hash inner = _inner;
+        inner.update(message);
+        auto d = inner.final();
+        char dbytes[Hash::digest_size] = {};
+        for (std::size_t i = 0; i < Hash::digest_size; ++i) dbytes[i] = static_cast<char>(d[i]);
+        Hash outer = _outer;
+        outer.update(std::string_view(dbytes, Hash::digest_size));
+        return outer.final();
+    }
+
+protected:
+    Hash _inner = {};
+    Hash _outer = {};
+};
+
+///compare digests (or their parts) in constant time
+constexpr bool digest_equal(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    unsigned char diff = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) diff |= static_cast<unsigned char>(a[i] ^ b[i]);
+    return diff == 0;
+}
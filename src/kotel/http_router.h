@@ -0,0 +1,195 @@
+#pragma once
+#include "http_utils.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace kotel {
+
+///Query string parsed into fixed array of parameters
+/**
+ * @tparam N maximum count of parameters. Extra parameters are ignored
+ *
+ * @note names and values are not decoded, they reference the request.
+ */
+template<unsigned int N>
+class QueryParams {
+public:
+    using Param = std::pair<std::string_view, std::string_view>;
+
+    QueryParams() = default;
+
+    ///parse query string
+    /**
+     * @param query query string without leading '?'
+     */
+    explicit QueryParams(std::string_view query) {
+        while (!query.empty() && _count < N) {
+            auto value = split(query, "&");
+            if (value.empty()) continue;
+            auto name = split(value, "=");
+            _params[_count++] = {name, value};
+        }
+    }
+
+    ///get value of parameter
+    /**
+     * @param name name of parameter
+     * @return value, or no value if parameter is not present
+     */
+    std::optional<std::string_view> get(std::string_view name) const {
+        for (const auto &p: *this) if (p.first == name) return p.second;
+        return {};
+    }
+
+    const Param *begin() const {return _params;}
+    const Param *end() const {return _params+_count;}
+    unsigned int size() const {return _count;}
+    bool empty() const {return _count == 0;}
+
+protected:
+    Param _params[N] = {};
+    unsigned int _count = 0;
+};
+
+
+///Route of HttpRouter
+template<typename Handler>
+struct HttpRoute {
+    std::string_view path;
+    HttpMethod method;
+    Handler handler;
+};
+
+///Compile time router of HTTP requests
+/**
+ * Paths are stored in a perfect hash table computed at compile time,
+ * so a request is dispatched by one hash and one string compare
+ * regardless count of routes. The table is constexpr, so it stays in flash
+ *
+ * @tparam Handler type of handler (for example pointer to member function)
+ * @tparam N count of routes
+ */
+template<typename Handler, std::size_t N>
+class HttpRouter {
+public:
+
+    using Route = HttpRoute<Handler>;
+
+    struct Match {
+        ///matching route, nullptr if not found
+        const Route *route = nullptr;
+        ///methods allowed on the path (bit per HttpMethod), 0 - path not found
+        unsigned int allowed = 0;
+    };
+
+    ///construct router
+    /**
+     * @param routes list of routes. Routes of the same path with different
+     * methods must be adjacent
+     *
+     * @note check valid() in static_assert
+     */
+    constexpr HttpRouter(const Route (&routes)[N]) {
+        for (std::size_t i = 0; i < N; ++i) _routes[i] = routes[i];
+        for (std::size_t i = 1; i < N; ++i) {
+            for (std::size_t j = 0; j + 1 < i; ++j) {
+                //same path must not appear in two separated groups
+                if (_routes[j].path == _routes[i].path && _routes[i-1].path != _routes[i].path) return;
+            }
+        }
+        for (uint32_t seed = 0; seed < max_seed; ++seed) {
+            if (build_table(seed)) {
+                _seed = seed;
+                _valid = true;
+                return;
+            }
+        }
+    }
+
+    ///returns true when table was built (unique groups, perfect hash found)
+    constexpr bool valid() const {return _valid;}
+
+    ///find route
+    /**
+     * @param method method of request
+     * @param path path without query string
+     * @return match
+     */
+    constexpr Match find(HttpMethod method, std::string_view path) const {
+        Match m;
+        auto slot = _slots[hash(_seed, path) & (table_size - 1)];
+        if (slot == 0 || _routes[slot-1].path != path) return m;
+        for (std::size_t i = slot - 1U; i < N && _routes[i].path == path; ++i) {
+            m.allowed |= 1U << static_cast<unsigned int>(_routes[i].method);
+            if (_routes[i].method == method) m.route = _routes+i;
+        }
+        return m;
+    }
+
+    ///format value of Allow header
+    /**
+     * @param buffer output buffer
+     * @param allowed mask of allowed methods (Match::allowed)
+     * @return formatted list
+     */
+    template<std::size_t sz>
+    static std::string_view format_allow(char (&buffer)[sz], unsigned int allowed) {
+        std::size_t pos = 0;
+        for (const auto &[m, name]: method_map) {
+            if (!(allowed & (1U << static_cast<unsigned int>(m)))) continue;
+            std::string_view n(name);
+            if (pos + n.size() + 2 > sz) break;
+            if (pos) {buffer[pos++] = ','; buffer[pos++] = ' ';}
+            for (char c: n) buffer[pos++] = c;
+        }
+        return {buffer, pos};
+    }
+
+protected:
+
+    static constexpr uint32_t max_seed = 1000;
+
+    static constexpr std::size_t calc_table_size() {
+        std::size_t sz = 4;
+        while (sz < 2 * N) sz <<= 1;
+        return sz;
+    }
+
+    static constexpr std::size_t table_size = calc_table_size();
+    static_assert(N < 255, "Too many routes");
+
+    static constexpr uint32_t hash(uint32_t seed, std::string_view path) {
+        uint32_t h = 2166136261U ^ (seed * 0x9E3779B9U);
+        for (char c: path) h = (h ^ static_cast<uint8_t>(c)) * 16777619U;
+        return h ^ (h >> 16);
+    }
+
+    constexpr bool build_table(uint32_t seed) {
+        for (auto &s: _slots) s = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            if (i && _routes[i-1].path == _routes[i].path) continue;
+            auto &s = _slots[hash(seed, _routes[i].path) & (table_size - 1)];
+            if (s) return false;
+            s = static_cast<uint8_t>(i + 1);
+        }
+        return true;
+    }
+
+    Route _routes[N] = {};
+    ///index of first route of the path + 1, 0 - empty
+    uint8_t _slots[table_size] = {};
+    uint32_t _seed = 0;
+    bool _valid = false;
+};
+
+///Construct router, deduces count of routes
+template<typename Handler, std::size_t N>
+constexpr HttpRouter<Handler, N> make_router(const HttpRoute<Handler> (&routes)[N]) {
+    return HttpRouter<Handler, N>(routes);
+}
+
+}
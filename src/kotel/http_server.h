@@ -8,6 +8,8 @@
 #include "websocket.h"
 
 #include <algorithm>
+#include <cstring>
+#include <optional>
 namespace kotel {
 
 
@@ -16,10 +18,34 @@ public:
 
     using HeaderPair = std::pair<std::string_view, std::string_view>;
     using HeaderIL = std::initializer_list<HeaderPair>;
+    ///initial size of chunk of async response
     static constexpr unsigned int send_cluster = 256;
+    ///smallest chunk of async response
+    static constexpr unsigned int min_send_cluster = 64;
+    ///time which can be spent by writing one chunk (per connection and call of get_request)
+    static constexpr unsigned int send_time_budget_ms = 20;
+    ///throughput is measured over this period
+    static constexpr unsigned int throughput_window_ms = 100;
+    ///idle keep-alive connection is closed after this time
+    static constexpr unsigned int keep_alive_timeout_ms = 15000;
+    ///count of idle keep-alive connections tracked by the server. When
+    ///there are more, the oldest one is closed
+    static constexpr unsigned int max_idle_connections = 4;
+    ///count of websocket sessions tracked by the server. When a new session
+    ///is opened and the table is full, the least active session is closed
+    static constexpr unsigned int max_ws_sessions = 3;
+    ///idle websocket session is pinged after this time
+    static constexpr unsigned int ws_ping_interval_ms = 20000;
+    ///websocket session which didn't send anything is closed after this time
+    static constexpr unsigned int ws_session_timeout_ms = 60000;
+    ///broadcasted message up to this size (including frame header) is
+    ///written by single write
+    static constexpr unsigned int ws_broadcast_buffer = 256;
 
     struct Request {
         TCPClient *client = nullptr;
+        ///index of connection slot which received the request
+        unsigned int connection = 0;
         HttpRequestLine request_line = {};
         const HeaderPair  *headers = {};
         std::size_t headers_count = {};
@@ -27,6 +53,23 @@ public:
     };
 
 
+    ///format unsigned number
+    /**
+     * @param buff buffer for text
+     * @param val value
+     * @return text of number (placed in the buffer)
+     */
+    template<std::size_t N>
+    static std::string_view format_uint(char (&buff)[N], unsigned long val) {
+        char *e = buff + N;
+        char *c = e;
+        do {
+            *(--c) = static_cast<char>(val % 10 + '0');
+            val /= 10;
+        } while (val && c != buff);
+        return {c, static_cast<std::size_t>(e - c)};
+    }
+
     constexpr static std::string_view get_message(int code) {
         switch(code) {
             case 200: return "OK";
@@ -50,22 +93,200 @@ public:
         static constexpr char png[]= "image/png";
         static constexpr char gif[]= "image/gif";
         static constexpr char jpeg[]= "image/jpeg";
+        static constexpr char openmetrics[]= "application/openmetrics-text; version=1.0.0; charset=utf-8";
+    };
+
+    struct CacheControl {
+        ///client must validate cached content (by ETag)
+        static constexpr char revalidate[] = "no-cache";
+        ///content never changes under the same URL (versioned URL)
+        static constexpr char immutable[] = "public, max-age=31536000, immutable";
+    };
+
+
+};
+
+
+///Producer of content of async response
+/**
+ * The server pulls content from the producer when the connection is able to
+ * send more data. Produced data are stored in the buffer of the connection slot
+ * and they are sent in chunks. Size of the chunk is adapted to the measured
+ * throughput of the network, so one chunk doesn't block the main loop for too long.
+ * Next content is requested after everything has been sent
+ *
+ * The producer can serve one connection at time. It must stay valid until
+ * it is finished (see is_busy())
+ */
+class ResponseProducer {
+public:
+
+    static constexpr int end_of_content = -1;
+
+    virtual ~ResponseProducer() = default;
+
+    ///Produce next part of content
+    /**
+     * @param buffer buffer to fill
+     * @param size size of the buffer
+     * @return count of bytes written to the buffer. Returns 0 if content is not
+     * ready yet (the server asks later), or end_of_content
+     */
+    virtual int produce(char *buffer, std::size_t size) = 0;
+
+    ///producer is used by a connection
+    bool is_busy() const {return _busy;}
+
+protected:
+    ///called when the producer is attached to a connection
+    virtual void on_start() {}
+    ///called when the producer is released (content sent or connection lost)
+    virtual void on_finish() {}
+
+    bool _busy = false;
+
+    template<unsigned int, unsigned int, unsigned int> friend class HttpServer;
+};
+
+///Produces content of a string
+class StringProducer: public ResponseProducer {
+public:
+    StringProducer() = default;
+    StringProducer(std::string_view content):_content(content) {}
+
+    virtual int produce(char *buffer, std::size_t size) override {
+        if (_content.empty()) return end_of_content;
+        auto sz = _content.copy(buffer, size);
+        _content = _content.substr(sz);
+        return static_cast<int>(sz);
+    }
+
+protected:
+    std::string_view _content;
+};
+
+///Produces content printed by items (lines) to a Stream
+/**
+ * Items are printed to the buffer while they fit. Item which doesn't fit
+ * is printed again by next call. Item larger than whole buffer is truncated
+ */
+class ItemProducer: public ResponseProducer {
+public:
+
+    virtual int produce(char *buffer, std::size_t size) override {
+        Output out(buffer, size);
+        while (true) {
+            auto pos = out.get_text().size();
+            if (!print_item(out, _item)) {
+                return pos?static_cast<int>(pos):end_of_content;
+            }
+            if (out.overflow) {
+                if (pos) return static_cast<int>(pos);
+                ++_item;
+                return static_cast<int>(size);
+            }
+            ++_item;
+        }
+    }
+
+protected:
+    ///print item
+    /**
+     * @param s output stream
+     * @param item index of item
+     * @retval true printed
+     * @retval false no more items
+     */
+    virtual bool print_item(Stream &s, unsigned int item) = 0;
+
+    virtual void on_start() override {_item = 0;}
+
+    class Output: public StringStreamExt {
+    public:
+        using StringStreamExt::StringStreamExt;
+        using StringStreamExt::write;
+        bool overflow = false;
+        virtual size_t write(uint8_t x) override {
+            auto r = StringStreamExt::write(x);
+            overflow = overflow || !r;
+            return r;
+        }
     };
 
+    unsigned int _item = 0;
+};
+
+///Item producer which prints items by a member function
+/**
+ * @tparam X class
+ * @tparam fn function bool(Stream &, unsigned int item), returns false if
+ * there are no more items
+ */
+template<typename X, bool (X::*fn)(Stream &s, unsigned int item)>
+class ItemProducerMethod: public ItemProducer { // @suppress("Miss copy constructor or assignment operator")
+public:
+    ItemProducerMethod(X *object):_object(object) {}
 
+protected:
+    virtual bool print_item(Stream &s, unsigned int item) override {
+        return ((*_object).*fn)(s, item);
+    }
+
+    X *_object;
 };
 
 
-template<unsigned int max_request_size = 8192,
-         unsigned int max_header_lines = 32>
+///HTTP server
+/**
+ * @tparam buffer_size total size of receive buffers. The space is split
+ * evenly between connection slots, so the largest request which can be
+ * received is buffer_size / max_connections
+ * @tparam max_header_lines maximum count of header lines reported
+ * with the request
+ * @tparam max_connections count of connection slots. Every connection which
+ * is receiving a request or sending an async response occupies one slot.
+ * Idle connections (keep-alive, websocket between messages) don't occupy
+ * any slot
+ *
+ * Connections are persistent (HTTP/1.1 keep-alive) when the response has
+ * known length and the client doesn't ask to close the connection.
+ * Otherwise the server closes the connection after the response has been
+ * written - the request handler doesn't need to close it. Idle keep-alive
+ * connections are closed after keep_alive_timeout_ms. Pipelined requests
+ * received along with the current request are processed after the response
+ *
+ * Connections upgraded to websocket are tracked in a table of sessions,
+ * so the server can write to them while they are idle (broadcast)
+ */
+template<unsigned int buffer_size = 8192,
+         unsigned int max_header_lines = 32,
+         unsigned int max_connections = 1>
 class HttpServer: public HttpServerBase {
 public:
 
+    static_assert(max_connections > 0 && max_connections < 256);
+
+    ///largest request which can be received
+    static constexpr unsigned int max_request_size = buffer_size / max_connections;
+
     HttpServer(int port);
     void begin();
     void end();
 
 
+    ///Process connections
+    /**
+     * Connection slots are serviced in round-robin order. Every call
+     * accepts at most one new connection, reads available data from the
+     * slots and sends one cluster of each async response. When a request
+     * is completed, the function returns immediately and next call
+     * continues by the next slot
+     *
+     * @return request. If the member client is nullptr, there is no request
+     *
+     * @note response must be written before next call. If the response
+     * doesn't allow to keep the connection, it is closed by next call
+     */
     Request get_request();
 
 
@@ -120,10 +341,14 @@ public:
      * @param req request
      * @param content_type content type
      * @param content_len content length, if -1 then Connection: close is added
+     * @param compressed content is compressed by gzip
+     * @param etag ETag of the content (optional)
+     * @param cache_control Cache-Control for content with ETag (see CacheControl)
      * @note reuses server's buffer. You should avoid to reference any string
      * retrieved by request. It also destroys the request content
      */
-    void send_simple_header(Request &req, std::string_view content_type, int content_len = -1, bool compressed = false, std::string_view etag = {});
+    void send_simple_header(Request &req, std::string_view content_type, int content_len = -1, bool compressed = false,
+            std::string_view etag = {}, std::string_view cache_control = CacheControl::revalidate);
 
     ///send file
     /**
@@ -138,232 +363,838 @@ public:
      * @param req request
      * @param content_type content type
      * @param content content
+     *
+     * @param compressed content is compressed by gzip
+     * @param etag ETag of the content. If the request has matching
+     * If-None-Match, only 304 is sent
+     * @param cache_control Cache-Control for content with ETag (see CacheControl)
+     *
+     * @note content is sent by following calls of get_request(). The
+     * connection keeps its slot until the content is sent
      */
-    void send_file_async(Request &req, std::string_view content_type, std::string_view content, bool compressed = false, std::string_view etag = {});
+    void send_file_async(Request &req, std::string_view content_type, std::string_view content, bool compressed = false,
+            std::string_view etag = {}, std::string_view cache_control = CacheControl::revalidate);
+
+    ///send prebuilt response
+    /**
+     * Sends response prepared at compile time (header and body in one
+     * buffer) without any formatting.
+     *
+     * @param req request
+     * @param response complete response for persistent HTTP/1.1 connection
+     * @param not_modified complete 304 response, sent if the request has
+     * matching If-None-Match
+     * @param etag ETag of the content
+     * @retval true response is being sent (by following calls of get_request())
+     * @retval false the request needs other header (HTTP/1.0, Connection: close).
+     * Nothing was sent, use send_file_async()
+     */
+    bool send_prebuilt_async(Request &req, std::string_view response, std::string_view not_modified, std::string_view etag);
+
+    ///send content generated by producer
+    /**
+     * @param req request
+     * @param content_type content type
+     * @param producer producer of the content
+     * @param content_len content length, if -1 then the connection is closed
+     * after the content is sent
+     * @retval true response started, content is pulled from the producer
+     * by following calls of get_request()
+     * @retval false producer is busy, nothing was sent
+     */
+    bool send_async(Request &req, std::string_view content_type, ResponseProducer &producer, int content_len = -1);
 
     void send_ws_message(Request &req, const ws::Message &msg);
 
+    ///send websocket message generated by producer
+    /**
+     * The message is fragmented. The prefix is sent immediately as the
+     * first frame, then every produced chunk is sent as a continuation
+     * frame and the message is terminated by an empty final frame. Size
+     * of the message is not limited by any buffer. Broadcast messages
+     * are not delivered to the session while the message is being sent
+     *
+     * @param req websocket request
+     * @param type type of message (text or binary)
+     * @param producer producer of the payload
+     * @param prefix beginning of the payload (for example selector of reply)
+     * @retval true message started, content is pulled from the producer
+     * by following calls of get_request()
+     * @retval false producer is busy, nothing was sent
+     */
+    bool send_ws_async(Request &req, ws::Type type, ResponseProducer &producer, std::string_view prefix = {});
+
+    ///send message to all subscribed websocket sessions
+    /**
+     * The frame is built once and the same bytes are written to every
+     * session. A session which fails to receive the message is closed
+     *
+     * @param msg message
+     * @return count of sessions which received the message
+     */
+    unsigned int broadcast_ws_message(const ws::Message &msg);
+
+    ///identifies websocket session, no_ws_session_id if none
+    /**
+     * Identifier contains a generation, so it doesn't match another
+     * session which reuses the same entry of the table
+     */
+    using WsSessionId = uint16_t;
+    static constexpr WsSessionId no_ws_session_id = 0;
+
+    ///get websocket session of the request
+    /**
+     * Use this to send reply of a request which completes later
+     * (see send_ws_session_message())
+     *
+     * @param req websocket request
+     * @return identifier of the session, no_ws_session_id if none
+     */
+    WsSessionId get_ws_session(const Request &req) const;
+
+    ///websocket session is still open
+    bool is_ws_session_open(WsSessionId id) const {
+        return find_ws_session(id) != nullptr;
+    }
+
+    ///send message to a websocket session outside of request handler
+    /**
+     * @param id identifier of the session
+     * @param msg message
+     * @retval true sent
+     * @retval false not sent, the session is closed or it is sending
+     * a fragmented message (try it later, see is_ws_session_open())
+     */
+    bool send_ws_session_message(WsSessionId id, const ws::Message &msg);
+
+    ///subscribe websocket session of the request to broadcasted messages
+    /**
+     * @param req websocket request
+     * @param subscribe true to subscribe, false to unsubscribe
+     * @retval true done
+     * @retval false the request doesn't belong to a websocket session
+     */
+    bool set_ws_subscription(const Request &req, bool subscribe);
+
+    ///count of websocket sessions subscribed to broadcast
+    unsigned int get_ws_subscribers() const {
+        unsigned int cnt = 0;
+        for (const auto &s: _ws_sessions) cnt += s.used && s.subscribed?1:0;
+        return cnt;
+    }
+
     uint8_t get_activity_counter() const {
         return _activity_counter;
     }
 
+    ///current size of chunk of async response (adapted to measured throughput)
+    unsigned int get_send_chunk_size() const {
+        return _chunk_size;
+    }
+
+    ///count of occupied connection slots
+    unsigned int get_active_connections() const {
+        unsigned int cnt = 0;
+        for (const auto &c: _connections) cnt += c.client?1:0;
+        return cnt;
+    }
+
 protected:
 
+    ///State of one connection slot
+    struct Connection {
+        TCPClient client = {};
+        unsigned int write_pos = 0;
+        unsigned int hdr_end = 0;
+        ///count of received bytes which belong to next request (stored at the end of buffer)
+        unsigned int carry_len = 0;
+        int body_size = -1;    //-1 reading header, 0 = no body, else remaining size of body
+        unsigned long read_timeout_tp = 0;
+        ///used to select slot for eviction
+        unsigned long last_activity = 0;
+        HttpRequestLine rl = {};
+        ///producer of async response
+        ResponseProducer *producer = nullptr;
+        ///produced data in the buffer (offset of unsent data, end of data)
+        unsigned int out_pos = 0;
+        unsigned int out_end = 0;
+        ///producer for send_file_async
+        StringProducer file_content = {};
+        bool body_trunc = false;
+        bool ws_mode = false;
+        bool deactivate_client = false;
+        ///client asked for persistent connection
+        bool keep_alive = false;
+        ///close connection after current response
+        bool close_after_response = false;
+        ///connection was switched to websocket, it is never closed for inactivity
+        bool websocket = false;
+        ///index of websocket session served by this slot (no_ws_session if none)
+        uint8_t ws_session = no_ws_session;
+        ///producer generates fragmented websocket message
+        bool ws_stream = false;
+        ///final frame of the websocket message has been prepared
+        bool ws_stream_end = false;
+        ws::Parser<Connection> ws;
+        char input_buff[max_request_size] = {};
+
+        Connection():ws(*this) {}
+        Connection(const Connection &) = delete;
+        Connection &operator=(const Connection &) = delete;
+
+        //WS support functions
+        void push_back(char c);
+        char *alloc_back(std::size_t n);
+        std::size_t size() const {return write_pos;}
+        void clear() {write_pos = 0;}
+        const char *data() const {return input_buff;}
+    };
+
 
     TCPServer _srv = {};
-    TCPClient _active_client = {};
-    char _input_buff[max_request_size] = {};
-    unsigned int _write_pos = 0;
-    unsigned int _hdr_end = 0;
+    Connection _connections[max_connections];
+    std::pair<std::string_view, std::string_view>  _header_lines[max_header_lines];
     unsigned int _hdr_count = 0;
-    HttpRequestLine _rl;
-    int _body_size = -1;    //-1 reading header, 0 = no body, else size of body
-    unsigned long read_timeout_tp = 0;
-    bool _body_trunc = false;
-    bool _ws_mode = false;
-    bool _deactivate_client = false;
+    uint8_t _next_connection = 0;
     uint8_t _activity_counter = 0;
-    std::pair<std::string_view, std::string_view>  _header_lines[max_header_lines];
-    ws::Parser<HttpServer> _ws;
+    unsigned int _chunk_size = send_cluster;
+    ///bytes and time of writes in current measurement window
+    unsigned long _tx_bytes = 0;
+    unsigned long _tx_time = 0;
+
+    ///Idle keep-alive connection
+    struct IdleClient {
+        TCPClient client = {};
+        unsigned long expires = 0;
+    };
+    IdleClient _idle[max_idle_connections];
 
-    TCPClient _sending_client = {};
-    std::string_view _sending_buffer = {};
+    static constexpr uint8_t no_ws_session = 0xFF;
+    ///space reserved before produced websocket payload for frame header
+    static constexpr unsigned int ws_frame_header_space = 4;
+    static_assert(max_request_size <= 0xFFFF + ws_frame_header_space, "Frame header doesn't fit to reserved space");
+    static constexpr uint8_t no_slot = 0xFF;
 
-    void parse_header();
-    void reset_server(bool keep_client);
+    ///Websocket session
+    /**
+     * While the session is receiving a message, the client is owned by
+     * a connection slot (with the parser state). Between messages the
+     * client is parked here
+     */
+    struct WsSession {
+        ///client of parked session
+        TCPClient client = {};
+        unsigned long last_activity = 0;
+        ///slot which serves the session, no_slot if parked
+        uint8_t slot = no_slot;
+        ///generation of the entry (part of WsSessionId)
+        uint8_t generation = 0;
+        bool used = false;
+        bool subscribed = false;
+        bool ping_sent = false;
+    };
+    WsSession _ws_sessions[max_ws_sessions];
+    uint8_t _ws_generation = 0;
 
-    //WS support functions
-    friend class ws::Parser<HttpServer>;
-    void push_back(char c);
-    std::size_t size() const;
-    void clear() {_write_pos = 0;}
-    const char *data() const;
+    ///Websocket frame prepared for writing
+    /**
+     * Frame is built to the stack buffer. Payload of large frame is
+     * written directly from the message after the header
+     */
+    struct WsFrame {
+        char buffer[ws_broadcast_buffer];
+        ///size of data in the buffer
+        std::size_t size = 0;
+        ///payload which doesn't fit to the buffer
+        std::string_view payload = {};
+
+        WsFrame(const ws::Message &msg);
+        bool write(TCPClient &client) const;
+    };
+
+    void accept_connection(unsigned long curtm);
+    void send_produced(Connection &conn, unsigned long curtm);
+    void start_producer(Connection &conn, ResponseProducer &producer);
+    ///release slot of idle connection, the client is tracked for idle timeout
+    void park_client(Connection &conn, unsigned long curtm);
+    void close_expired_clients(unsigned long curtm);
+    ///register upgraded connection as websocket session
+    void open_ws_session(unsigned int idx, unsigned long curtm);
+    ///close websocket session (parked or served by a slot)
+    void close_ws_session(unsigned int session);
+    ///find open session by identifier, nullptr if not found
+    const WsSession *find_ws_session(WsSessionId id) const;
+    ///session is sending fragmented message, other frames must wait
+    bool is_ws_streaming(const WsSession &session) const {
+        return session.slot != no_slot && _connections[session.slot].ws_stream;
+    }
+    ///get client of the websocket session
+    TCPClient &get_ws_client(WsSession &session) {
+        return session.slot == no_slot?session.client:_connections[session.slot].client;
+    }
+    ///prepare response header, updates keep-alive state of connection
+    template<typename KeyValueHeader>
+    std::string_view build_header(Request &req, const KeyValueHeader &header, int code, std::string_view message);
+    void release_producer(Connection &conn);
+    void update_throughput(unsigned int bytes, unsigned long time);
+    ///put header of frame of streamed websocket message before the payload
+    /**
+     * @param conn connection, payload is at ws_frame_header_space offset
+     * @param len length of payload
+     * @param fin final frame
+     * @return offset of the frame
+     */
+    static unsigned int frame_ws_chunk(Connection &conn, unsigned int len, bool fin);
+    ///request has If-None-Match with the etag
+    static bool is_not_modified(const Request &req, std::string_view etag);
+    bool process_connection(Connection &conn, unsigned int idx, unsigned long curtm, Request &ret);
+    void parse_header(Connection &conn, bool store_lines);
+    ///find end of header in buffer
+    /**
+     * @param buff buffer
+     * @param from offset of new data
+     * @param to end of data
+     * @return size of header including empty line, or 0 if not found
+     */
+    static unsigned int find_header_end(const char *buff, unsigned int from, unsigned int to);
+    ///keep data of next request
+    void keep_unprocessed(Connection &conn, std::string_view data);
+    void reset_connection(Connection &conn, bool keep_client);
+    Connection &get_connection(const Request &req) {return _connections[req.connection];}
+    ///size of buffer which can be used to build response
+    static unsigned int response_space(const Connection &conn) {return max_request_size - conn.carry_len;}
 
 };
 
-template<unsigned int max_request_size, unsigned int max_header_lines >
-inline void HttpServer<max_request_size, max_header_lines>::push_back(char c) {
-        if (_write_pos >= max_request_size) {
-            _body_trunc = true;
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::Connection::push_back(char c) {
+        if (write_pos >= max_request_size) {
+            body_trunc = true;
         } else{
-            _input_buff[_write_pos] = c;
-            ++_write_pos;
+            input_buff[write_pos] = c;
+            ++write_pos;
         }
 }
 
-template<unsigned int max_request_size, unsigned int max_header_lines >
-inline std::size_t HttpServer<max_request_size, max_header_lines>::size() const {
-    return _write_pos;
-}
 
-template<unsigned int max_request_size, unsigned int max_header_lines >
-inline const char *HttpServer<max_request_size, max_header_lines>::data() const {
-    return _input_buff;
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline char *HttpServer<buffer_size, max_header_lines, max_connections>::Connection::alloc_back(std::size_t n) {
+    //doesn't fit, parser falls back to push_back() which marks truncation
+    if (n > max_request_size - write_pos) return nullptr;
+    char *p = input_buff + write_pos;
+    write_pos += n;
+    return p;
 }
 
-
-template<unsigned int max_request_size, unsigned int max_header_lines >
-inline HttpServer<max_request_size, max_header_lines>::HttpServer(int port)
-    :_srv(port),_ws(*this)
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline HttpServer<buffer_size, max_header_lines, max_connections>::HttpServer(int port)
+    :_srv(port)
 {
 
 }
 
-template<unsigned int max_request_size, unsigned int max_header_lines>
-inline void HttpServer<max_request_size, max_header_lines>::begin() {
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::begin() {
     _srv.begin();
 }
 
-template<unsigned int max_request_size, unsigned int max_header_lines>
-inline void HttpServer<max_request_size, max_header_lines>::end() {
-    if (_sending_client) _sending_client.stop();
-    if (_active_client) _active_client.stop();
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::end() {
+    for (auto &c: _connections) {
+        reset_connection(c, false);
+    }
+    for (auto &c: _idle) {
+        if (c.client) c.client.stop();
+    }
+    for (unsigned int i = 0; i < max_ws_sessions; ++i) {
+        if (_ws_sessions[i].used) close_ws_session(i);
+    }
     _srv.end();
 }
 
 
-template<unsigned int max_request_size, unsigned int max_header_lines>
-inline typename  HttpServer<max_request_size, max_header_lines>::Request
-    HttpServer<max_request_size, max_header_lines>::get_request() {
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline typename  HttpServer<buffer_size, max_header_lines, max_connections>::Request
+    HttpServer<buffer_size, max_header_lines, max_connections>::get_request() {
 
     Request ret {};
+    auto curtm = millis();
 
-    if (!_sending_buffer.empty()) {
-        ++_activity_counter;
-        auto c = _sending_buffer.substr(0, HttpServerBase::send_cluster);
-        _sending_buffer = _sending_buffer.substr(c.size());
-        if (_sending_client.write(c.data(),c.size()) != c.size() || _sending_buffer.empty()) {
-            _sending_buffer = {};
-            _sending_client.detach();
+    close_expired_clients(curtm);
+    accept_connection(curtm);
+
+    for (unsigned int i = 0; i < max_connections; ++i) {
+        unsigned int idx = (_next_connection + i) % max_connections;
+        Connection &conn = _connections[idx];
+        if (!conn.client) continue;
+        if (process_connection(conn, idx, curtm, ret)) {
+            //next call starts by next connection
+            _next_connection = (idx + 1) % max_connections;
+            return ret;
+        }
+    }
+    _next_connection = (_next_connection + 1) % max_connections;
+    return ret;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::accept_connection(unsigned long curtm) {
+    TCPClient cln;
+    if (!_srv.available(cln)) return;
+    Connection *target = nullptr;
+    for (auto &c: _connections) {
+        if (c.client) {
+            //data of connection which already has slot, it is read by its slot
+            if (c.client == cln) {
+                cln.detach();
+                return;
+            }
+            if (!target || (target->client && static_cast<long>(c.last_activity - target->last_activity) < 0)) {
+                target = &c;
+            }
+        } else if (!target || target->client) {
+            target = &c;
+        }
+    }
+    for (auto &c: _idle) {
+        //idle connection is active again, it is now tracked by its slot
+        if (c.client && c.client == cln) c.client.detach();
+    }
+    //no free slot - evict least recently active connection
+    //(also clears state of a free slot)
+    reset_connection(*target, false);
+    for (auto &s: _ws_sessions) {
+        if (s.used && s.slot == no_slot && s.client == cln) {
+            //parked websocket session received data, the slot serves it now
+            s.client.detach();
+            s.slot = static_cast<uint8_t>(target - _connections);
+            target->websocket = true;
+            target->ws_session = static_cast<uint8_t>(&s - _ws_sessions);
+            break;
         }
-        return ret;
     }
+    target->client = std::move(cln);
+    target->read_timeout_tp = curtm+5000;    //total timeout
+    target->last_activity = curtm;
+}
 
-    auto curtm = millis();
-    if (static_cast<long>(curtm - read_timeout_tp) > 0 && _active_client) {
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline bool HttpServer<buffer_size, max_header_lines, max_connections>::process_connection(
+        Connection &conn, unsigned int idx, unsigned long curtm, Request &ret) {
 
-        reset_server(false);
-        return ret;
+    if (conn.producer) {
+        conn.last_activity = curtm;
+        send_produced(conn, curtm);
+        return false;
     }
 
-    if (!_active_client) {
-        if (!_srv.available(_active_client)) return ret;
-        read_timeout_tp = curtm+5000;    //total timeout
+    if (conn.close_after_response) {
+        //response was sent with Connection: close, pipelined requests are dropped
+        reset_connection(conn, false);
+        return false;
     }
-    int b = _active_client.read();
-    if (b != -1) {
-        ++_activity_counter;
+
+    if (static_cast<long>(curtm - conn.read_timeout_tp) > 0) {
+        reset_connection(conn, false);
+        return false;
     }
-    while (b != -1) {
-        _deactivate_client = false;
-        if ((_write_pos == 0 && (b & 0x7F)<16) || _ws_mode) {  //0x00-0x0F || 0x80-0x8F = websocket frame
-            char c = static_cast<char>(b);
-            if (!_ws_mode) {
-                _ws_mode = true;
-                _ws.reset();
+
+    bool fetch = true;
+    while (true) {
+        //received data are always appended to the buffer. Websocket parser
+        //unmasks payload in place (write position never overtakes read position)
+        char *chunk = conn.input_buff + conn.write_pos;
+        std::size_t n;
+        if (conn.carry_len) {
+            //unprocessed data of previous request
+            n = conn.carry_len;
+            std::memmove(chunk, conn.input_buff + max_request_size - n, n);
+            conn.carry_len = 0;
+        } else {
+            std::size_t space = max_request_size - conn.write_pos;
+            if (conn.body_size > 0) {
+                //read body exactly, discard what doesn't fit
+                if (space == 0) {
+                    conn.body_trunc = true;
+                    conn.write_pos = conn.hdr_end;
+                    chunk = conn.input_buff + conn.write_pos;
+                    space = max_request_size - conn.write_pos;
+                }
+                space = std::min<std::size_t>(space, conn.body_size);
+            } else if (space == 0) {
+                //websocket message or header too large
+                reset_connection(conn, false);
+                return false;
             }
-            bool pst = _ws.push_data({&c,1});
-            if (_body_trunc) {
-                reset_server(false);
-                return ret;
+            //only first read can fetch new data, then drain client's buffer
+            int r = fetch?conn.client.read(reinterpret_cast<uint8_t *>(chunk), space)
+                         :conn.client.read_nb(reinterpret_cast<uint8_t *>(chunk), space);
+            fetch = false;
+            if (r <= 0) break;
+            n = r;
+        }
+        ++_activity_counter;
+        conn.last_activity = curtm;
+        conn.deactivate_client = false;
+
+        if (!conn.ws_mode && conn.websocket) {
+            //start of next websocket message
+            conn.ws_mode = true;
+            conn.ws.reset();
+        }
+        if (conn.ws_mode) {
+            bool pst = conn.ws.push_data({chunk, n});
+            if (conn.body_trunc) {
+                reset_connection(conn, false);
+                return false;
             }
             if (pst) {
-                auto msg = _ws.get_message();
+                keep_unprocessed(conn, conn.ws.get_unused_data());
+                auto msg = conn.ws.get_message();
                 ret.body = msg.payload;
                 ret.request_line.method = HttpMethod::WS;
-                ret.client = &_active_client;
+                ret.client = &conn.client;
+                ret.connection = idx;
                 if (msg.type == ws::Type::ping) {
-                    std::string_view newpl (_input_buff+sizeof(_input_buff)-msg.payload.size(), msg.payload.size());
+                    std::string_view newpl (conn.input_buff+max_request_size-conn.carry_len-msg.payload.size(), msg.payload.size());
                     std::move(msg.payload.data(), msg.payload.end(), const_cast<char *>(newpl.data()));
                     send_ws_message(ret, ws::Message{newpl, ws::Type::pong});
                     ret.client = nullptr;
-                    reset_server(true);
+                    reset_connection(conn, true);
+                    continue;
+                } else if (msg.type == ws::Type::pong) {
+                    //answer to our ping, the session is alive
+                    ret.client = nullptr;
+                    reset_connection(conn, true);
+                    continue;
                 } else if (msg.type == ws::Type::connClose) {
                     send_ws_message(ret, ws::Message{{},ws::Type::connClose, ws::Base::closeNormal});
                     ret.client = nullptr;
-                    reset_server(false);
+                    reset_connection(conn, false);
+                    return false;
                 } else {
-                    reset_server(true);
+                    reset_connection(conn, true);
                 }
-                return ret;
+                return true;
+            }
+            continue;
+        }
 
+        unsigned int scan_from = conn.write_pos;
+        conn.write_pos += n;
+        if (conn.body_size == -1) {
+            unsigned int hdr_size = find_header_end(conn.input_buff, scan_from, conn.write_pos);
+            if (!hdr_size) {
+                if (conn.write_pos == max_request_size) {
+                    reset_connection(conn, false);
+                    return false;
+                }
+                continue;
+            }
+            conn.hdr_end = hdr_size - 2;  //save 2 bytes for body (empty header line)
+            parse_header(conn, false);
+            if (conn.rl.version.empty()) {
+                reset_connection(conn, false);
+                return false;
+            }
+            //move data after header to the body position
+            unsigned int extra = conn.write_pos - hdr_size;
+            std::memmove(conn.input_buff + conn.hdr_end, conn.input_buff + hdr_size, extra);
+            conn.write_pos = conn.hdr_end + extra;
+            if (static_cast<unsigned int>(conn.body_size) < extra) {
+                //data of next request
+                unsigned int req_end = conn.hdr_end + conn.body_size;
+                keep_unprocessed(conn, {conn.input_buff + req_end, conn.write_pos - req_end});
+                conn.write_pos = req_end;
+                conn.body_size = 0;
+            } else {
+                conn.body_size -= extra;
             }
         } else {
-            _input_buff[_write_pos] = static_cast<char>(b);
-            ++_write_pos;
-            if (_body_size == -1) {
-                if (_write_pos > 3
-                    && _input_buff[_write_pos-1] == '\n'
-                    && _input_buff[_write_pos-2] == '\r'
-                    && _input_buff[_write_pos-3] == '\n'
-                    && _input_buff[_write_pos-4] == '\r') {
-                        _write_pos-=2;  //save 2 bytes for body (empty header line)
-                        _hdr_end = _write_pos;
-                        parse_header();
-                        if (_rl.version.empty()) {
-                            reset_server(false);
-                            return ret;
-                        }
-                } else if (_write_pos == max_request_size) {
-                    reset_server(false);
-                    return ret;
-                }
+            conn.body_size -= n;
+        }
+        if (conn.body_size == 0) {
+            //header lines are stored to shared table only for returned request
+            auto body_end = conn.write_pos;
+            parse_header(conn, true);
+            ret.client = &conn.client;
+            ret.connection = idx;
+            ret.request_line = conn.rl;
+            ret.headers = _header_lines;
+            ret.headers_count = _hdr_count;
+            ret.body = {conn.input_buff+conn.hdr_end, body_end -conn.hdr_end};
+            if (conn.body_trunc) {
+                error_response(ret, 413, "Content Too Large");
+                reset_connection(conn, false);
+                ret = {};
+                return false;
             } else {
-                --_body_size;
-                if (_write_pos == max_request_size) {
-                    --_write_pos;
-                    _body_trunc = true;
-                }
+                reset_connection(conn, true);
+                return true;
             }
-            if (_body_size == 0) {
-                ret.client = &_active_client;
-                ret.request_line = _rl;
-                ret.headers = _header_lines;
-                ret.headers_count = _hdr_count;
-                ret.body = {_input_buff+_hdr_end, _write_pos -_hdr_end};
-                if (_body_trunc) {
-                    error_response(ret, 413, "Content Too Large");
-                    reset_server(false);
-                    ret = {};
-                    return ret;
-                } else {
-                    reset_server(true);
-                    return ret;
-                }
+        }
+    }
+    if (conn.deactivate_client) {
+        //idle connection, release the slot
+        conn.deactivate_client = false;
+        park_client(conn, curtm);
+    }
+    return false;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::send_produced(Connection &conn, unsigned long curtm) {
+    if (conn.out_pos == conn.out_end) {
+        //everything sent, pull next content
+        unsigned int hdr_space = conn.ws_stream?ws_frame_header_space:0;
+        int r = conn.ws_stream_end?ResponseProducer::end_of_content
+                :conn.producer->produce(conn.input_buff + hdr_space, response_space(conn) - hdr_space);
+        if (r == 0) return;     //not ready yet
+        if (r < 0 && conn.ws_stream && !conn.ws_stream_end) {
+            //terminate the message by empty final frame
+            conn.ws_stream_end = true;
+            r = 0;
+        } else if (r < 0) {
+            release_producer(conn);
+            if (conn.close_after_response) {
+                reset_connection(conn, false);
+            } else if (!conn.carry_len) {
+                park_client(conn, curtm);
             }
+            //else pipelined request is processed by next call
+            return;
         }
-        b = _active_client.read_nb();
+        conn.out_pos = conn.ws_stream?frame_ws_chunk(conn, r, conn.ws_stream_end):0;
+        conn.out_end = hdr_space + r;
     }
-    if (_deactivate_client) {
-        _active_client.detach();
+    ++_activity_counter;
+    unsigned int sz = std::min(conn.out_end - conn.out_pos, _chunk_size);
+    auto start = millis();
+    if (conn.client.write(conn.input_buff + conn.out_pos, sz) != sz) {
+        reset_connection(conn, false);
+        return;
     }
-    return ret;
+    update_throughput(sz, millis() - start);
+    conn.out_pos += sz;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline unsigned int HttpServer<buffer_size, max_header_lines, max_connections>::frame_ws_chunk(Connection &conn, unsigned int len, bool fin) {
+    //server frames are not masked, length up to 65535 needs 4 bytes
+    char *p = conn.input_buff + ws_frame_header_space;
+    if (len < 126) {
+        *--p = static_cast<char>(len);
+    } else {
+        *--p = static_cast<char>(len & 0xFF);
+        *--p = static_cast<char>(len >> 8);
+        *--p = 126;
+    }
+    *--p = static_cast<char>((fin?0x80:0) | ws::Base::opcodeContFrame);
+    return static_cast<unsigned int>(p - conn.input_buff);
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::update_throughput(unsigned int bytes, unsigned long time) {
+    _tx_bytes += bytes;
+    _tx_time += time;
+    //fast network can't be measured by millis(), decide by amount of data
+    if (_tx_time < throughput_window_ms && _tx_bytes < 4UL * max_request_size) return;
+    unsigned long fit = _tx_time?_tx_bytes * send_time_budget_ms / _tx_time:max_request_size;
+    //smooth changes
+    fit = (fit + _chunk_size) / 2;
+    _chunk_size = static_cast<unsigned int>(std::clamp<unsigned long>(fit, min_send_cluster, max_request_size));
+    _tx_bytes = 0;
+    _tx_time = 0;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::start_producer(
+        Connection &conn, ResponseProducer &producer) {
+    //connection keeps its slot until the content is sent
+    conn.deactivate_client = false;
+    conn.producer = &producer;
+    conn.out_pos = 0;
+    conn.out_end = 0;
+    producer._busy = true;
+    producer.on_start();
 }
 
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::release_producer(Connection &conn) {
+    if (!conn.producer) return;
+    conn.producer->_busy = false;
+    conn.producer->on_finish();
+    conn.producer = nullptr;
+    conn.out_pos = 0;
+    conn.out_end = 0;
+    conn.ws_stream = false;
+    conn.ws_stream_end = false;
+}
 
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::park_client(Connection &conn, unsigned long curtm) {
+    if (conn.websocket) {
+        //websocket is long living, the session keeps the client
+        if (conn.ws_session == no_ws_session) {
+            conn.client.stop();
+        } else {
+            auto &s = _ws_sessions[conn.ws_session];
+            s.client = std::move(conn.client);
+            s.slot = no_slot;
+            s.last_activity = conn.last_activity;
+            s.ping_sent = false;
+            conn.client.detach();
+            conn.ws_session = no_ws_session;
+        }
+        conn.websocket = false;
+        return;
+    }
+    IdleClient *target = &_idle[0];
+    for (auto &c: _idle) {
+        if (!c.client) {
+            target = &c;
+            break;
+        }
+        if (static_cast<long>(c.expires - target->expires) < 0) target = &c;
+    }
+    //too many idle connections - close the oldest one
+    if (target->client) target->client.stop();
+    target->client = std::move(conn.client);
+    target->expires = curtm + keep_alive_timeout_ms;
+    conn.client.detach();
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::close_expired_clients(unsigned long curtm) {
+    for (auto &c: _idle) {
+        if (c.client && static_cast<long>(curtm - c.expires) > 0) c.client.stop();
+    }
+    for (unsigned int i = 0; i < max_ws_sessions; ++i) {
+        auto &s = _ws_sessions[i];
+        if (!s.used || s.slot != no_slot) continue;
+        auto idle = curtm - s.last_activity;
+        if (idle > ws_session_timeout_ms) {
+            close_ws_session(i);
+        } else if (idle > ws_ping_interval_ms && !s.ping_sent) {
+            //the answer (pong) activates the session
+            static constexpr char ping[] = {static_cast<char>(0x80 | ws::Base::opcodePing), 0};
+            s.ping_sent = true;
+            if (s.client.write(ping, sizeof(ping)) != sizeof(ping)) close_ws_session(i);
+        }
+    }
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::open_ws_session(unsigned int idx, unsigned long curtm) {
+    Connection &conn = _connections[idx];
+    if (conn.ws_session != no_ws_session) return;
+    unsigned int target = 0;
+    for (unsigned int i = 0; i < max_ws_sessions; ++i) {
+        const auto &s = _ws_sessions[i];
+        if (!s.used) {
+            target = i;
+            break;
+        }
+        auto act = s.slot == no_slot?s.last_activity:_connections[s.slot].last_activity;
+        auto tact = _ws_sessions[target].slot == no_slot?_ws_sessions[target].last_activity
+                                                       :_connections[_ws_sessions[target].slot].last_activity;
+        if (static_cast<long>(act - tact) < 0) target = i;
+    }
+    //table is full - close least active session
+    if (_ws_sessions[target].used) close_ws_session(target);
+    auto &s = _ws_sessions[target];
+    s.used = true;
+    //generation is never 0, so identifier is never no_ws_session_id
+    if (++_ws_generation == 0) ++_ws_generation;
+    s.generation = _ws_generation;
+    s.subscribed = false;
+    s.ping_sent = false;
+    s.slot = static_cast<uint8_t>(idx);
+    s.last_activity = curtm;
+    conn.ws_session = static_cast<uint8_t>(target);
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::close_ws_session(unsigned int session) {
+    auto &s = _ws_sessions[session];
+    if (s.slot != no_slot) {
+        //releases the session
+        reset_connection(_connections[s.slot], false);
+    } else {
+        if (s.client) s.client.stop();
+        s = WsSession();
+    }
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline unsigned int HttpServer<buffer_size, max_header_lines, max_connections>::find_header_end(
+        const char *buff, unsigned int from, unsigned int to) {
+    //the terminating LF must be in new data, check only LFs there
+    const char *p = buff + from;
+    const char *e = buff + to;
+    while (p < e) {
+        p = static_cast<const char *>(std::memchr(p, '\n', e - p));
+        if (!p) break;
+        if (p - buff >= 3 && p[-1] == '\r' && p[-2] == '\n' && p[-3] == '\r') {
+            return p - buff + 1;
+        }
+        ++p;
+    }
+    return 0;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::keep_unprocessed(
+        Connection &conn, std::string_view data) {
+    //stored at the end of the buffer, beyond current request
+    conn.carry_len = data.size();
+    std::memmove(conn.input_buff + max_request_size - data.size(), data.data(), data.size());
+}
+
+
+///print response header
+/**
+ * @param keep_alive_allowed client accepts persistent connection
+ * @retval true connection stays open after the response
+ * @retval false connection must be closed after the response
+ *
+ * @note Connection header is added, unless it is already in the header
+ */
 template<typename KeyValueHeader>
-inline void send_header_impl(Stream &s,
+inline bool send_header_impl(Stream &s,
         std::string_view ver,
         int code,
         std::string_view message,
-        const KeyValueHeader &header) {
+        const KeyValueHeader &header,
+        bool keep_alive_allowed = false) {
 
+    //version can be located in the buffer which is being overwritten
+    bool http10 = ver == "HTTP/1.0";
     print(s,ver, " ",code, " ", message,"\r\n");
-    bool keep_alive = false;
+    //response without body has known length
+    bool has_length = code == 204 || code == 304;
+    bool has_connection = false;
     for (const auto &[k, v]: header) {
         print(s, k, ": ", v, "\r\n");
-        keep_alive = keep_alive || icmp(k, "Content-Length");
+        has_length = has_length || icmp(k, "Content-Length");
+        has_connection = has_connection || icmp(k, "Connection");
     }
-    if (!keep_alive) {
+    if (has_connection) {
+        //explicit connection header (upgrade)
+    } else if (!has_length || !keep_alive_allowed) {
         print(s, "Connection: close\r\n");
+        keep_alive_allowed = false;
+    } else if (http10) {
+        print(s, "Connection: keep-alive\r\n");
     }
     s.print("\r\n");
+    return keep_alive_allowed || has_connection;
 }
 
 
 
-template<unsigned int max_request_size, unsigned int max_header_lines>
-inline void HttpServer<max_request_size, max_header_lines>::error_response(
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::error_response(
         Request &req,
         int code,
         std::string_view message,
@@ -371,143 +1202,289 @@ inline void HttpServer<max_request_size, max_header_lines>::error_response(
         std::string_view extra_message) {
 
     if (message.empty()) message = get_message(code);
-    StringStreamExt buff(_input_buff, max_request_size);
+    Connection &conn = get_connection(req);
 
+    auto print_body = [&](Stream &s) {
+        print(s, "<!DOCTYPE html><html><head><title>",
+                code," ",message,"</title></head><body><h1>",
+                code," ",message,"</h1><pre>",extra_message,"</pre></body></html>");
+    };
+    CountingStream cnt;
+    print_body(cnt);
+    char lenbuff[20];
     std::initializer_list<std::pair<std::string_view, std::string_view> > hdr = {
-            {"Content-Type","text/html; charset=utf-8"}
+            {"Content-Type","text/html; charset=utf-8"},
+            {"Content-Length", format_uint(lenbuff, cnt.get_count())}
     };
-    send_header_impl(buff, req.request_line.version, code, message,
-            CombinedContainers<HeaderIL,HeaderIL>(hdr, extra_header));
-
-    print(buff, "<!DOCTYPE html><html><head><title>",
-            code," ",message,"</title></head><body><h1>",
-            code," ",message,"</h1><pre>",extra_message,"</pre></body></html>");
+    StringStreamExt buff(conn.input_buff, response_space(conn));
+    conn.close_after_response = !send_header_impl(buff, req.request_line.version, code, message,
+            CombinedContainers<HeaderIL,HeaderIL>(hdr, extra_header), conn.keep_alive);
+    print_body(buff);
     auto data = buff.get_text();
     req.client->write(data.data(), data.size());
 
 
 }
 
-template<unsigned int max_request_size, unsigned int max_header_lines>
-inline void HttpServer<max_request_size, max_header_lines>::parse_header() {
-    _body_size = 0;
-    auto first_line = parse_http_header(std::string_view(_input_buff, _hdr_end),
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::parse_header(Connection &conn, bool store_lines) {
+    conn.body_size = 0;
+    _hdr_count = 0;
+    std::optional<bool> keep_alive;
+    auto first_line = parse_http_header(std::string_view(conn.input_buff, conn.hdr_end),
             [&](std::string_view key, std::string_view value){
         if (icmp(key, "Content-Length")) {
-            _body_size = std::strtoul(value.data(), nullptr, 10);
+            conn.body_size = std::strtoul(value.data(), nullptr, 10);
+        } else if (icmp(key, "Connection")) {
+            while (!value.empty()) {
+                auto tk = trim(split(value, ","));
+                if (icmp(tk, "close")) keep_alive = false;
+                else if (icmp(tk, "keep-alive")) keep_alive = true;
+            }
         }
-        if (_hdr_count != max_header_lines) {
+        if (store_lines && _hdr_count != max_header_lines) {
             _header_lines[_hdr_count] = {key,value};
             ++_hdr_count;
         }
     });
-    _rl = parse_http_request_line(first_line);
+    conn.rl = parse_http_request_line(first_line);
+    //HTTP/1.1 is persistent by default
+    conn.keep_alive = keep_alive.value_or(conn.rl.version != "HTTP/1.0");
 }
 
-template<unsigned int max_request_size, unsigned int max_header_lines>
-inline void HttpServer<max_request_size, max_header_lines>::reset_server(bool keep_client) {
-    _body_size = -1;
-    _ws_mode = false;
-    _write_pos = 0;
-    _hdr_end = 0;
-    _hdr_count = 0;
-    _body_trunc = false;
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::reset_connection(Connection &conn, bool keep_client) {
+    conn.body_size = -1;
+    conn.ws_mode = false;
+    conn.write_pos = 0;
+    conn.hdr_end = 0;
+    conn.body_trunc = false;
+    conn.close_after_response = false;
     if (keep_client) {
-        _deactivate_client = true;
+        conn.deactivate_client = true;
+        conn.read_timeout_tp = millis()+5000;
     } else {
-        if (_active_client) {
-            _active_client.stop();
+        release_producer(conn);
+        conn.deactivate_client = false;
+        conn.websocket = false;
+        conn.carry_len = 0;
+        if (conn.ws_session != no_ws_session) {
+            //client of the session is closed below
+            _ws_sessions[conn.ws_session] = WsSession();
+            conn.ws_session = no_ws_session;
+        }
+        if (conn.client) {
+            conn.client.stop();
         }
     }
 }
 
-template<unsigned int max_request_size, unsigned int max_header_lines>
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
 template<typename KeyValueHeader>
-inline void HttpServer<max_request_size, max_header_lines>::send_header(Request &req,
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::send_header(Request &req,
         const KeyValueHeader &header,
         int code, std::string_view message) {
 
-    if (message.empty()) message = get_message(code);
-    StringStreamExt buff(this->_input_buff, max_request_size);
-    send_header_impl(buff, req.request_line.version, code, message, header);
-    auto txt = buff.get_text();
+    auto txt = build_header(req, header, code, message);
     req.client->write(txt.data(), txt.size());
 
 }
 
-template<unsigned int max_request_size, unsigned int max_header_lines>
-inline void HttpServer<max_request_size, max_header_lines>::send_header(Request &req,
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+template<typename KeyValueHeader>
+inline std::string_view HttpServer<buffer_size, max_header_lines, max_connections>::build_header(Request &req,
+        const KeyValueHeader &header,
+        int code, std::string_view message) {
+
+    if (message.empty()) message = get_message(code);
+    Connection &conn = get_connection(req);
+    StringStreamExt buff(conn.input_buff, response_space(conn));
+    conn.close_after_response = !send_header_impl(buff, req.request_line.version, code, message, header, conn.keep_alive);
+    if (code == 101) {
+        conn.websocket = true;
+        open_ws_session(req.connection, millis());
+    }
+    return buff.get_text();
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::send_header(Request &req,
         const HeaderIL &header,
         int code, std::string_view message) {
     send_header<decltype(header)>(req, header, code, message);
 }
 
-template<unsigned int max_request_size, unsigned int max_header_lines>
-void HttpServer<max_request_size, max_header_lines>::send_simple_header(Request &req, std::string_view content_type, int content_len, bool compressed, std::string_view etag) {
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+void HttpServer<buffer_size, max_header_lines, max_connections>::send_simple_header(Request &req, std::string_view content_type, int content_len, bool compressed,
+        std::string_view etag, std::string_view cache_control) {
     StaticVector<HeaderPair, 6> hp;
     char buff[20];
-    char *c = std::end(buff);
-    *(--c) = 0;
     hp.emplace_back("Content-Type", content_type);
     if (content_len >= 0) {
-        hp[1].first = "Content-Length";
-        if (content_len == 0) *(--c) = '0';
-        else while (content_len != 0) {
-            *(--c) = (content_len % 10) + '0';
-            content_len/=10;
-        }
-        hp.emplace_back("Content-Length", c);
+        hp.emplace_back("Content-Length", format_uint(buff, content_len));
     }
     if (compressed) {
         hp.emplace_back("Content-Encoding", "gzip");
     }
     if (!etag.empty()) {
         hp.emplace_back("ETag", etag);
-        hp.emplace_back("Cache-Control", "no-cache");
+        hp.emplace_back("Cache-Control", cache_control);
     }
     send_header(req, hp, 200, {});
 }
 
-template<unsigned int max_request_size, unsigned int max_header_lines>
-void HttpServer<max_request_size, max_header_lines>::send_file(Request &req, std::string_view content_type, std::string_view content, bool compressed) {
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+void HttpServer<buffer_size, max_header_lines, max_connections>::send_file(Request &req, std::string_view content_type, std::string_view content, bool compressed) {
     int content_len = content.size();
     send_simple_header(req, content_type, content_len, compressed);
     req.client->write(content.data(), content.size());
 }
 
-template <unsigned int max_request_size, unsigned int max_header_lines>
-inline void HttpServer<max_request_size, max_header_lines>::send_ws_message(Request &req, const ws::Message &msg)
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline void HttpServer<buffer_size, max_header_lines, max_connections>::send_ws_message(Request &req, const ws::Message &msg)
 {
+    Connection &conn = get_connection(req);
+    char *buff = conn.input_buff;
+    std::size_t space = response_space(conn);
     std::size_t sz = 0;
     ws::build(msg,[&](char c){
-        if (sz < max_request_size) {
-            _input_buff[sz++] = c;
+        if (sz < space) {
+            buff[sz] = c;
         }
+        ++sz;
     },nullptr);
-    if (sz > max_request_size) req.client->stop();
+    if (sz > space) req.client->stop();
     else {
-        req.client->write(_input_buff, sz);
+        req.client->write(buff, sz);
     }
 }
-template <unsigned int max_request_size, unsigned int max_header_lines>
-void HttpServer<max_request_size, max_header_lines>::send_file_async(Request &req, std::string_view content_type, std::string_view content, bool compressed, std::string_view etag) {
-    if (!etag.empty()) {
-        auto b = req.headers;
-        auto e = req.headers+ req.headers_count;
-
-        auto p = std::find_if(b, e,[&](const HeaderPair &hp){
-            return icmp(hp.first, "if-none-match");
-        });
-        if (p != e && p->second.find(etag) != p->second.npos) {
-            send_header(req, {}, 304, {});
-            return;
-        }
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline unsigned int HttpServer<buffer_size, max_header_lines, max_connections>::broadcast_ws_message(const ws::Message &msg)
+{
+    if (!get_ws_subscribers()) return 0;
+    WsFrame frame(msg);
+    unsigned int cnt = 0;
+    for (unsigned int i = 0; i < max_ws_sessions; ++i) {
+        auto &s = _ws_sessions[i];
+        if (!s.used || !s.subscribed) continue;
+        //frames of other message can't be inserted into fragmented message
+        if (is_ws_streaming(s)) continue;
+        if (frame.write(get_ws_client(s))) ++cnt;
+        else close_ws_session(i);
+    }
+    return cnt;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline HttpServer<buffer_size, max_header_lines, max_connections>::WsFrame::WsFrame(const ws::Message &msg) {
+    ws::build(msg,[&](char c){
+        if (size < sizeof(buffer)) buffer[size] = c;
+        ++size;
+    },nullptr);
+    if (size > sizeof(buffer)) {
+        //large message - frame header is in the buffer, payload is written from the message
+        size -= msg.payload.size();
+        payload = msg.payload;
+    }
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline bool HttpServer<buffer_size, max_header_lines, max_connections>::WsFrame::write(TCPClient &client) const {
+    if (client.write(buffer, size) != size) return false;
+    return payload.empty() || client.write(payload.data(), payload.size()) == payload.size();
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline typename HttpServer<buffer_size, max_header_lines, max_connections>::WsSessionId
+    HttpServer<buffer_size, max_header_lines, max_connections>::get_ws_session(const Request &req) const {
+    const Connection &conn = _connections[req.connection];
+    if (conn.ws_session == no_ws_session) return no_ws_session_id;
+    return static_cast<WsSessionId>((_ws_sessions[conn.ws_session].generation << 8) | conn.ws_session);
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline const typename HttpServer<buffer_size, max_header_lines, max_connections>::WsSession *
+    HttpServer<buffer_size, max_header_lines, max_connections>::find_ws_session(WsSessionId id) const {
+    unsigned int idx = id & 0xFF;
+    if (idx >= max_ws_sessions) return nullptr;
+    const auto &s = _ws_sessions[idx];
+    if (!s.used || s.generation != (id >> 8)) return nullptr;
+    return &s;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline bool HttpServer<buffer_size, max_header_lines, max_connections>::send_ws_session_message(WsSessionId id, const ws::Message &msg) {
+    auto cs = find_ws_session(id);
+    if (!cs || is_ws_streaming(*cs)) return false;
+    unsigned int idx = static_cast<unsigned int>(cs - _ws_sessions);
+    if (WsFrame(msg).write(get_ws_client(_ws_sessions[idx]))) return true;
+    close_ws_session(idx);
+    return false;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+inline bool HttpServer<buffer_size, max_header_lines, max_connections>::set_ws_subscription(const Request &req, bool subscribe) {
+    const Connection &conn = get_connection(req);
+    if (conn.ws_session == no_ws_session) return false;
+    _ws_sessions[conn.ws_session].subscribed = subscribe;
+    return true;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+void HttpServer<buffer_size, max_header_lines, max_connections>::send_file_async(Request &req, std::string_view content_type, std::string_view content, bool compressed,
+        std::string_view etag, std::string_view cache_control) {
+    if (is_not_modified(req, etag)) {
+        send_header(req, {{"ETag", etag},{"Cache-Control", cache_control}}, 304, {});
+        return;
     }
 
     int content_len = content.size();
-    send_simple_header(req, content_type, content_len, compressed, etag);
-    _sending_client = std::move(*req.client);
-    _sending_buffer = content;
+    send_simple_header(req, content_type, content_len, compressed, etag, cache_control);
+    Connection &conn = get_connection(req);
+    conn.file_content = StringProducer(content);
+    start_producer(conn, conn.file_content);
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+bool HttpServer<buffer_size, max_header_lines, max_connections>::is_not_modified(const Request &req, std::string_view etag) {
+    if (etag.empty()) return false;
+    auto b = req.headers;
+    auto e = req.headers+ req.headers_count;
+    auto p = std::find_if(b, e,[&](const HeaderPair &hp){
+        return icmp(hp.first, "if-none-match");
+    });
+    return p != e && p->second.find(etag) != p->second.npos;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+bool HttpServer<buffer_size, max_header_lines, max_connections>::send_prebuilt_async(Request &req, std::string_view response, std::string_view not_modified, std::string_view etag) {
+    Connection &conn = get_connection(req);
+    if (!conn.keep_alive || req.request_line.version != "HTTP/1.1") return false;
+    if (is_not_modified(req, etag)) {
+        req.client->write(not_modified.data(), not_modified.size());
+        return true;
+    }
+    conn.file_content = StringProducer(response);
+    start_producer(conn, conn.file_content);
+    return true;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+bool HttpServer<buffer_size, max_header_lines, max_connections>::send_async(Request &req, std::string_view content_type, ResponseProducer &producer, int content_len) {
+    if (producer.is_busy()) return false;
+    send_simple_header(req, content_type, content_len);
+    start_producer(get_connection(req), producer);
+    return true;
+}
+
+template<unsigned int buffer_size, unsigned int max_header_lines, unsigned int max_connections>
+bool HttpServer<buffer_size, max_header_lines, max_connections>::send_ws_async(Request &req, ws::Type type, ResponseProducer &producer, std::string_view prefix) {
+    if (producer.is_busy()) return false;
+    send_ws_message(req, ws::Message{prefix, type, 0, false});
+    Connection &conn = get_connection(req);
+    start_producer(conn, producer);
+    conn.ws_stream = true;
+    return true;
 }
 
 }
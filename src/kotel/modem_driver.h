@@ -0,0 +1,12 @@
+#pragma once
+#include "at_modem.h"
+#include "at_udp.h"
+
+#include <WifiTCP.h>
+
+namespace kotel {
+
+///asynchronous driver of the modem of this platform (see ModemUart in WifiTCP.h)
+using ModemDriver = AtModem<ModemUart>;
+
+}
@@ -4,7 +4,11 @@
 
 namespace kotel {
 
-NetworkControl::NetworkControl(Controller &cntr):_cntr(cntr),_server(80) {
+static constexpr const char *ntp_host = "pool.ntp.org";
+static constexpr TimeStampMs ntp_timeout = 2000;
+
+NetworkControl::NetworkControl(Controller &cntr)
+    :_cntr(cntr),_server(80),_modem(modem_uart()),_ntp(_modem),_sdns(_modem) {
 
 }
 
@@ -17,7 +21,15 @@ void NetworkControl::run(TimeStampMs cur_time) {
     if (_cntr.get_storage().config.serial_log_out) {
         Serial.println("NetworkControl cycle");
     }
+    //blocking calls of the modem (HTTP server, WiFi begin/end) can't be
+    //mixed with commands of asynchronous driver, wait until they are done
+    //(they are pumped by the controller)
+    if (!_modem.is_idle()) {
+        resume_at(cur_time+1);
+        return;
+    }
     if (!_cntr.is_safe_for_blocking()) {
+        run_action(cur_time);
         resume_at(cur_time+1);
         return;
     }
@@ -27,15 +39,22 @@ void NetworkControl::run(TimeStampMs cur_time) {
             _connected = false;
             init_wifi();
             return;
-
+        case WifiMode::restart:
+            //sockets of the driver are closed now
+            WiFi.end();
+            init_wifi_client();
+            _wifi_reset_at = cur_time+from_minutes(2);
+            return;
         case WifiMode::client:
-            if (cur_time > _wifi_check_at) {
+            if (_disconnected_streak>30) {
+                init_wifi_ap();
+                return;
+            }
+            if (cur_time > _wifi_check_at && _action == Action::inactive) {
                 _wifi_check_at = cur_time + 1000;
                 _action = Action::get_status;
             } else if (cur_time > _wifi_reset_at ) {
                 stop_wifi();
-                init_wifi_client();
-                _wifi_reset_at = cur_time+from_minutes(2);
                 return;
             }
             break;
@@ -51,27 +70,75 @@ void NetworkControl::run(TimeStampMs cur_time) {
             _connected = true;
             break;
     }
+    if (_connected) {
+        auto req = _server.get_request();
+        if (req.client) {
+            _wifi_last_activity = cur_time;
+            _cntr.handle_server(req);
+        }
+        _cntr.broadcast_status(cur_time);
+        _cntr.finish_ws_requests();
+    }
+    //commands are queued after the server is served, so it is not starved
+    run_action(cur_time);
+}
+
+///issue the query or collect its result
+/**
+ * @retval false query is pending
+ * @retval true query is done, result is in _query_result (empty on error)
+ */
+bool NetworkControl::query(const char *prompt, const char *cmd) {
+    if (_query == no_at_ticket) {
+        _query = _modem.command(prompt, AtReply::text, cmd);
+        _modem.set_notify(_query, this);
+        return false;
+    }
+    if (!_modem.is_done(_query)) return false;
+    std::string_view r;
+    if (_modem.get_status(_query) == AtStatus::ok) r = _modem.get_result(_query);
+    *std::copy(r.begin(), r.end(), _query_result) = 0;
+    _modem.release(_query);
+    return true;
+}
+
+void NetworkControl::run_action(TimeStampMs cur_time) {
     switch (_action) {
         case Action::inactive:
             break;
-        case Action::wait_dns:
-            if (_sdns.is_ready()) {
-                IPAddress adr(_sdns.get_result());
-                _ntp.cancel();
-                _ntp.request(adr, 123);
-                _action = Action::wait_ntp;
+        case Action::wait_dns: {
+            IPAddress adr;
+            switch (_sdns.lookup(ntp_host, adr, cur_time)) {
+                case SimpleDNS::Status::found:
+                    _ntp.cancel();
+                    _ntp.request(adr, 123);
+                    _ntp_timeout = cur_time + ntp_timeout;
+                    _action = Action::wait_ntp;
+                    break;
+                case SimpleDNS::Status::failed:
+                    _action = Action::inactive;
+                    break;
+                default:
+                    break;
             }
-            break;
+        } break;
         case Action::wait_ntp:
             if (_ntp.is_ready()){
                 set_current_time(static_cast<uint32_t>(_ntp.get_result()));
                 _ntp_resync = cur_time + 24*60*60*1000;
                 _action = Action::inactive;
+            } else if (cur_time > _ntp_timeout) {
+                //try next address of the pool immediately
+                _ntp.cancel();
+                if (_sdns.rotate(ntp_host)) _ntp_resync = cur_time;
+                _action = Action::inactive;
             }
             break;
         case Action::get_status:
-            _last_status = WiFiUtils::status();
-            _action = Action::determine_connection;
+            if (query(PROMPT(_GETSTATUS), CMD_READ(_GETSTATUS))) {
+                _last_status = static_cast<uint8_t>(std::atoi(_query_result));
+                _action = Action::determine_connection;
+            }
             break;
         case Action::determine_connection:
             _connected = _last_status == WL_CONNECTED;
@@ -82,32 +149,40 @@ void NetworkControl::run(TimeStampMs cur_time) {
                 ++_disconnected_streak;
                 _action = Action::inactive;
             }
-            if (_disconnected_streak>30) {
-                init_wifi_ap();
-                return;
-            }
             break;
         case Action::get_rssi:
-            _rssi = WiFi.RSSI();
-            _action = Action::get_ip;
+            if (query(PROMPT(_GETRSSI), CMD_READ(_GETRSSI))) {
+                _rssi = static_cast<int8_t>(std::atoi(_query_result));
+                _action = Action::get_ip;
+            }
             break;
         case Action::get_ip:
-            WiFiUtils::localIP(_local_ip);
-            _action = Action::inactive;
+            if (query(PROMPT(_IPSTA), CMD_WRITE(_IPSTA) "0" _ENDL)) {
+                _local_ip.fromString(_query_result);
+                //DNS servers are read once per connection
+                _action = _dns_ip == IPAddress{}?Action::get_dns:Action::inactive;
+            }
+            break;
+        case Action::get_dns:
+            if (query(PROMPT(_GETDNS), CMD_WRITE(_GETDNS) "0" _ENDL)) {
+                _dns_ip.fromString(_query_result);
+                _action = Action::get_dns2;
+            }
+            break;
+        case Action::get_dns2:
+            if (query(PROMPT(_GETDNS), CMD_WRITE(_GETDNS) "1" _ENDL)) {
+                IPAddress dns2;
+                dns2.fromString(_query_result);
+                _sdns.set_servers(_dns_ip, dns2);
+                _action = Action::inactive;
+            }
             break;
     }
-    if (_connected) {
-        auto req = _server.get_request();
-        if (req.client) {
-            _wifi_last_activity = cur_time;
-            _cntr.handle_server(req);
-        }
-        if (_mode == WifiMode::client && _ntp_resync < cur_time) {
-            _ntp_resync = cur_time + 5000;
-            _sdns.cancel();
-            _sdns.request("pool.ntp.org");
-            _action = Action::wait_dns;
-        }
+    if (_connected && _action == Action::inactive
+            && _mode == WifiMode::client && _ntp_resync < cur_time
+            && _dns_ip != IPAddress{}) {
+        _ntp_resync = cur_time + 5000;
+        _action = Action::wait_dns;
     }
 }
 
@@ -126,7 +201,7 @@ static IPAddress conv_ip(const IPAddr &x) {
 
 void NetworkControl::init_wifi_client() {
     if (_mode == WifiMode::inactive) {
-        stop_wifi();
+        WiFi.end();
     }
     WiFi.setTimeout(0);
     const auto &storage = _cntr.get_storage();
@@ -158,7 +233,7 @@ void NetworkControl::init_wifi_client() {
 
 void NetworkControl::init_wifi_ap() {
     if (_mode == WifiMode::inactive) {
-        stop_wifi();
+        WiFi.end();
     }
     WiFi.setTimeout(0);
     auto status = WiFi.beginAP("kotel");
@@ -174,12 +249,14 @@ void NetworkControl::init_wifi_ap() {
 
 void NetworkControl::stop_wifi() {
     _server.end();
-    _sdns.cancel();
-    _ntp.cancel();
+    _modem.release(_query);
+    _sdns.close();
+    _ntp.close();
     _action = Action::inactive;
-    _mode = WifiMode::inactive;
+    _mode = WifiMode::restart;
+    _connected = false;
     _local_ip = IPAddress{};
-    WiFi.end();
+    _dns_ip = IPAddress{};
 }
 
 
@@ -3,6 +3,7 @@
 #include "http_server.h"
 
 #include "ntp.h"
+#include "modem_driver.h"
 
 #include "simple_dns.h"
 namespace kotel {
@@ -13,12 +14,14 @@ class Controller;
 class NetworkControl: public AbstractTask {
 public:
 
-    using MyHttpServer = HttpServer<4096,32>;
+    using MyHttpServer = HttpServer<4096,32,3>;
 
     NetworkControl(Controller &cntr);
 
     void begin();
     virtual void run(TimeStampMs cur_time) override;
+    ///process traffic of asynchronous modem driver (call it in every loop)
+    void pump_modem(TimeStampMs cur_time) {_modem.pump(cur_time);}
 
     bool is_ap_mode() const {return _mode == WifiMode::ap;}
     bool any_active_client() const {
@@ -34,6 +37,8 @@ protected:
 
     enum class WifiMode : uint8_t{
         inactive,
+        ///sockets are being closed, then the client is started again
+        restart,
         client,
         ap,
     };
@@ -44,6 +49,8 @@ protected:
         wait_ntp,
         get_rssi,
         get_ip,
+        get_dns,
+        get_dns2,
         get_status,
         determine_connection
     };
@@ -54,6 +61,14 @@ protected:
     TimeStampMs _wifi_check_at = disabled_task;
     TimeStampMs _wifi_last_activity = 0;
     TimeStampMs _ntp_resync = 0;
+    TimeStampMs _ntp_timeout = 0;
+    ///asynchronous driver, used for WiFi status, NTP and DNS
+    /**
+     * HTTP server (TCPClient) and WiFi begin/end use the blocking
+     * layer of WifiTCP.h, they run only when this driver is idle
+     */
+    ModemDriver _modem;
+    AtTicket _query = no_at_ticket;
     NTPClient _ntp;
     SimpleDNS _sdns;
     int8_t _rssi = 0;
@@ -63,12 +78,17 @@ protected:
     uint8_t _disconnected_streak = 0;
     bool _connected = false;
     IPAddress _local_ip;
+    IPAddress _dns_ip;
+    char _query_result[ModemDriver::result_size+1] = {};
 
 
     void init_wifi();
     void init_wifi_client();
     void init_wifi_ap();
+    ///close connections and sockets, the modem is reset in next cycle
     void stop_wifi();
+    void run_action(TimeStampMs cur_time);
+    bool query(const char *prompt, const char *cmd);
 
     void continue_init_wifi(const std::vector<CAccessPoint> &aps);
 
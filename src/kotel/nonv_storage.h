@@ -1,6 +1,8 @@
 #pragma once
 #include "nonv_storage_def.h"
 #include <r4eeprom.h>
+#include <block_device_partition.h>
+#include <event_log.h>
 
 #include <algorithm>
 namespace kotel {
@@ -64,9 +66,18 @@ struct WiFi_Password{
 
 
 
+///pages of DataFlash used by event log (at the end of the flash)
+constexpr unsigned int event_log_pages = 2;
+///size of DataFlash used by file storage (at the beginning of the flash)
+constexpr unsigned int file_storage_size = FLASH_TOTAL_SIZE - event_log_pages * FLASH_BLOCK_SIZE;
+
 class Storage {
 public:
 
+    using FileStorage = EEPROM<sizeof(StorageSector),file_directory_len, FLASH_BLOCK_SIZE, file_storage_size>;
+    using EventLogDevice = BlockDevicePartition<DataFlashBlockDevice, file_storage_size, event_log_pages * FLASH_BLOCK_SIZE>;
+    using EventLogType = EventLog<EventRecord, FLASH_BLOCK_SIZE, event_log_pages * FLASH_BLOCK_SIZE, EventLogDevice>;
+
 
     Config config;
     Tray tray;
@@ -83,56 +94,208 @@ public:
 
 
     void begin() {
+        _eeprom.set_deferred_erase(true);
+        if (!_event_log.begin()) {
+            //damaged log page is repaired, it must not trigger the conversion
+            if (is_legacy_layout()) migrate_legacy_layout();
+            else _event_log.repair();
+        }
         _eeprom.begin();
-        _eeprom.read_file(file_config, config);
-        _eeprom.read_file(file_tray, tray);
-        _eeprom.read_file(file_runtime1, runtm);
-        _eeprom.read_file(file_runtime2, runtm2);
-        _eeprom.read_file(file_cntrs1, cntr1);
-        _eeprom.read_file(file_cntrs2, cntr2);
-        _eeprom.read_file(file_tempsensor, temp);
-        _eeprom.read_file(file_wifi_ssid, wifi_ssid);
-        _eeprom.read_file(file_wifi_pwd, wifi_password);
-        _eeprom.read_file(file_wifi_net, wifi_config);
-        pair_secret_need_init = !_eeprom.read_file(file_pair_secret,pair_secret);
-    }
-    auto get_eeprom() const {
+        for_each_file([&](unsigned int id, auto &data) {
+            bool ok = _eeprom.read_file(id, data);
+            if (id == file_pair_secret) pair_secret_need_init = !ok;
+        });
+    }
+    const FileStorage &get_eeprom() const {
         return _eeprom;
     }
+    const EventLogType &get_event_log() const {
+        return _event_log;
+    }
+    EventLogType &get_event_log() {
+        return _event_log;
+    }
+
+    ///append record to event log (written immediately)
+    /**
+     * The next page of the log is erased in advance by commit_step(),
+     * so this only programs the record
+     */
+    void log_event(const EventRecord &rec) {
+        _event_log.append(rec);
+    }
+
+    ///hold record until the clock is synchronized (timestamp is uptime)
+    void defer_event(const EventRecord &rec) {
+        _event_log.defer(rec);
+    }
+
+    ///write held records, convert their timestamps by the offset of the clock
+    void commit_deferred_events(uint32_t offset) {
+        if (_event_log.get_deferred_count()) _event_log.commit_deferred(offset);
+    }
+
+    ///erase files and event log
+    void erase_all() {
+        _eeprom.erase_all();
+        _event_log.format();
+    }
 
     ///save change sesttings now
     /** This operation is still asynchronous. The controller must call flush()
      * to perform actual store
+     *
+     * @note marks all files modified. Use save(items...) when you know
+     * which structures were modified
      */
     void save() {
-        _update_flag = true;
+        _dirty_files = all_files_mask;
+    }
+
+    ///save only specified structures
+    /**
+     * @param items members of this object which were modified (for example cntr1, tray).
+     * Only these files are compared and written during commit()
+     */
+    template<typename ... Items>
+    void save(const Items & ... items) {
+        (mark_dirty(items),...);
     }
 
+    ///returns true if there are modified files not yet commited
+    bool is_dirty() const {
+        return _dirty_files != 0;
+    }
+
+    ///commit all modified files now (blocking)
     void commit() {
-        if (_update_flag) {
-            _eeprom.update_file(file_config,config);
-            _eeprom.update_file(file_tray,tray);
-            _eeprom.update_file(file_runtime1,runtm);
-            _eeprom.update_file(file_cntrs1,cntr1);
-            _eeprom.update_file(file_runtime2,runtm2);
-            _eeprom.update_file(file_cntrs2,cntr2);
-            _eeprom.update_file(file_tempsensor,temp);
-            _eeprom.update_file(file_wifi_ssid,wifi_ssid);
-            _eeprom.update_file(file_wifi_pwd,wifi_password);
-            _eeprom.update_file(file_wifi_net, wifi_config);
-            _eeprom.update_file(file_pair_secret, pair_secret);
-            _update_flag = false;
+        if (_dirty_files) {
+            for_each_file([&](unsigned int id, const auto &data) {
+                if (_dirty_files & (1U << id)) _eeprom.update_file(id, data);
+            });
+            _dirty_files = 0;
         }
+        _eeprom.flush_erase();
+    }
+
+    ///perform one step of background commit
+    /**
+     * Writes one modified file. Files are written in fixed order, one
+     * sector per step. When there is nothing to write, the page released by
+     * defragmentation is erased, so the next defragmentation doesn't need to
+     * wait for the erase. Then the next page of the event log is erased
+     * when the current page is almost full. One erase per step.
+     *
+     * @retval true more work is pending
+     * @retval false nothing to do
+     */
+    bool commit_step() {
+        if (_dirty_files) {
+            bool done = false;
+            for_each_file([&](unsigned int id, const auto &data) {
+                DirtyMask m = 1U << id;
+                if (!done && (_dirty_files & m)) {
+                    _dirty_files &= ~m;
+                    _eeprom.update_file(id, data);
+                    done = true;
+                }
+            });
+        } else if (!_eeprom.flush_erase()) {
+            _event_log.prepare();
+        }
+        return is_commit_pending();
+    }
+
+    ///returns true, if there are data not yet written or page not yet erased
+    bool is_commit_pending() const {
+        return _dirty_files != 0 || _eeprom.is_erase_pending()
+                || _event_log.is_prepare_pending();
     }
 
 
 protected:
-    EEPROM<sizeof(StorageSector),file_directory_len> _eeprom;
-    bool _update_flag = false;
+    using DirtyMask = uint16_t;
+    static_assert(file_directory_len <= sizeof(DirtyMask)*8);
+    static constexpr DirtyMask all_files_mask = (1U << file_directory_len) - 1;
+
+    using LegacyStorage = EEPROM<sizeof(StorageSector),file_directory_len>;
+
+    FileStorage _eeprom;
+    EventLogType _event_log;
+    DirtyMask _dirty_files = 0;
+
+    ///flash was written by older firmware
+    /**
+     * Older firmware used whole flash for files, so a page of the event log
+     * region starts by a valid sector of the file storage. If the region is blank,
+     * the files didn't reach it (or the flash is blank), the conversion is
+     * harmless. Log page damaged by power failure has no such sector
+     */
+    bool is_legacy_layout() {
+        bool blank = true;
+        for (unsigned int p = 0; p < event_log_pages; ++p) {
+            LegacyStorage::Sector s;
+            EventLogDevice::getInstance().read(&s, p * FLASH_BLOCK_SIZE, sizeof(s));
+            if (LegacyStorage::is_valid_sector(s)) return true;
+            blank = blank && _event_log.get_page_info(p).erased;
+        }
+        return blank;
+    }
+
+    ///convert flash from older firmware
+    /**
+     * Older firmware used whole flash for files. Files are read using
+     * the old layout to RAM, the flash is erased and the files are written
+     * to the smaller file storage. The event log is formatted as last step.
+     *
+     * @note The conversion is not power-fail safe. The old layout spans the
+     * whole flash, so there is no place to keep it while the new files are
+     * written. If the power fails after the erase, the files are lost and
+     * the next start continues with default settings. The conversion runs
+     * only once, on the first start of the new firmware (see is_legacy_layout())
+     */
+    void migrate_legacy_layout() {
+        LegacyStorage legacy;
+        legacy.begin();
+        DirtyMask found = 0;
+        for_each_file([&](unsigned int id, auto &data) {
+            if (legacy.read_file(id, data)) found |= 1U << id;
+        });
+        _eeprom.erase_all();
+        for_each_file([&](unsigned int id, const auto &data) {
+            if (found & (1U << id)) _eeprom.write_file(id, data);
+        });
+        _event_log.format();
+    }
+
+    ///call function for every file (file id, reference to structure)
+    template<typename Fn>
+    void for_each_file(Fn &&fn) {
+        fn(file_config, config);
+        fn(file_tray, tray);
+        fn(file_runtime1, runtm);
+        fn(file_cntrs1, cntr1);
+        fn(file_runtime2, runtm2);
+        fn(file_cntrs2, cntr2);
+        fn(file_tempsensor, temp);
+        fn(file_wifi_ssid, wifi_ssid);
+        fn(file_wifi_pwd, wifi_password);
+        fn(file_wifi_net, wifi_config);
+        fn(file_pair_secret, pair_secret);
+    }
+
+    template<typename T>
+    void mark_dirty(const T &item) {
+        DirtyMask m = 0;
+        for_each_file([&](unsigned int id, const auto &data) {
+            if (static_cast<const void *>(&data) == static_cast<const void *>(&item)) m |= 1U << id;
+        });
+        //unknown object - to be safe, save everything
+        _dirty_files |= m?m:all_files_mask;
+    }
 
 
 };
 
 
 }
-
@@ -203,6 +203,32 @@ struct WiFi_NetSettings {
 };
 
 
+///type of record in event log
+enum class EventType: uint8_t {
+    restart = 1,        //system started
+    stop = 2,           //transition to stop mode, arg = StopReason bits
+    tray_open = 3,      //tray opened
+    tray_close = 4,     //tray closed
+};
+
+///reason of stop (bits)
+enum StopReason: uint16_t {
+    stop_temp_read_failure = 1,
+    stop_overheat = 2,
+    stop_feeder_overheat = 4,
+};
+
+///record in event log (stored outside of file storage)
+struct EventRecord {
+    uint32_t timestamp = 0;     //get_current_time() (seconds)
+    EventType type = {};
+    uint8_t mode = 0;           //drive mode when event happened
+    int16_t temp_output = 0;    //output temperature * 10
+    int16_t temp_input = 0;     //input temperature * 10
+    uint16_t arg = 0;           //argument depends on type
+};
+
+static_assert(sizeof(EventRecord) == 12);
 
 union StorageSector {
     Config cfg;
@@ -1,10 +1,12 @@
 #include <WiFiS3.h>
 
 #pragma once
+#include "modem_driver.h"
 
 class NTPClient {
 public:
 
+    NTPClient(kotel::ModemDriver &modem):_client(modem) {}
 
     int request(IPAddress addr, unsigned int port) {
         int r = _client.open(62123);
@@ -15,17 +17,16 @@ public:
         std::copy(std::begin(hdr), std::end(hdr), _client.data());
         r = _client.send(addr, port, _client.size());
         if (r == -1) {
-            _client.close();
+            cancel();
             return r;
         }
-        _opened = true;
         return 0;
     }
     bool is_ready() {
         if (!_opened) return false;
         auto data = _client.receive();
-        if (data.empty()) return false;
         constexpr int TRANSMIT_TIMESTAMP_OFFSET = 40;
+        if (data.size() < TRANSMIT_TIMESTAMP_OFFSET + 4) return false;
         constexpr uint32_t NTP_UNIX_EPOCH_DIFF = 2208988800;
         auto bseconds = reinterpret_cast<const unsigned char *>(data.data()+TRANSMIT_TIMESTAMP_OFFSET);
 
@@ -46,15 +47,22 @@ public:
         return _result;
     }
 
+    ///stop waiting for the reply, socket stays open for next request
     void cancel() {
         if (_opened) {
-            _client.close();
+            _client.cancel();
             _opened = false;
         }
     }
 
+    ///close socket (modem should be idle)
+    void close() {
+        cancel();
+        _client.close();
+    }
+
 protected:
-    UDPClient<48> _client;
+    kotel::AtUDPClient<kotel::ModemDriver, 48> _client;
     bool _opened = false;
     uint64_t _result = 0;
 };
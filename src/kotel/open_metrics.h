@@ -0,0 +1,138 @@
+#pragma once
+#include <Arduino.h>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace kotel {
+
+///Type of metric family (OpenMetrics)
+enum class MetricType {
+    gauge,
+    counter
+};
+
+///Definition of one metric family
+/**
+ * Families are stored in a constexpr table, the encoder prints them
+ * directly to the output stream one item (metadata or sample) at time
+ *
+ * @tparam Context object which provides values of samples
+ */
+template<typename Context>
+struct MetricFamily {
+    ///name of the family, samples of counter have suffix _total
+    const char *name;
+    MetricType type;
+    ///unit of the family (name must end by _unit). Can be nullptr
+    const char *unit;
+    const char *help;
+    ///count of samples
+    unsigned int samples;
+    ///print sample - labels and value (use print_metric_label, print_metric_value)
+    void (*sample)(Context &ctx, Stream &s, unsigned int index);
+};
+
+///print label of sample
+/**
+ * @param s output stream
+ * @param name name of label
+ * @param value value of label. It must not contain quotes, backslashes
+ * and new lines (they are not escaped)
+ */
+inline void print_metric_label(Stream &s, const char *name, std::string_view value) {
+    s.print('{');
+    s.print(name);
+    s.print("=\"");
+    s.write(value.data(), value.size());
+    s.print("\"}");
+}
+
+///print label of sample with numeric value
+inline void print_metric_label(Stream &s, const char *name, unsigned int value) {
+    s.print('{');
+    s.print(name);
+    s.print("=\"");
+    s.print(value);
+    s.print("\"}");
+}
+
+///print value of sample and terminate the line
+template<typename T>
+void print_metric_value(Stream &s, T value) {
+    s.print(' ');
+    s.print(value);
+    s.print('\n');
+}
+
+///print floating point value of sample and terminate the line
+/**
+ * @param s output stream
+ * @param value value
+ * @param digits count of decimal digits
+ */
+inline void print_metric_value(Stream &s, float value, int digits = 2) {
+    s.print(' ');
+    if (std::isnan(value)) s.print("NaN");
+    else if (std::isinf(value)) s.print(value > 0?"+Inf":"-Inf");
+    else s.print(value, digits);
+    s.print('\n');
+}
+
+///print optional value, missing value is reported as NaN
+inline void print_metric_value(Stream &s, const std::optional<float> &value) {
+    print_metric_value(s, value.has_value()?*value:NAN);
+}
+
+///print one item of the exposition
+/**
+ * Every family occupies one item for metadata (TYPE, UNIT, HELP) and one
+ * item per sample. The last item is # EOF. Items are short, so the output
+ * can be streamed through small buffer without an intermediate copy
+ *
+ * @param s output stream
+ * @param table table of families
+ * @param ctx context passed to the sample functions
+ * @param item index of item
+ * @retval true printed
+ * @retval false no more items
+ */
+template<typename Context, std::size_t N>
+bool print_metric_item(Stream &s, const MetricFamily<Context> (&table)[N], Context &ctx, unsigned int item) {
+    for (const auto &m: table) {
+        if (item == 0) {
+            s.print("# TYPE ");
+            s.print(m.name);
+            s.print(m.type == MetricType::counter?" counter\n":" gauge\n");
+            if (m.unit) {
+                s.print("# UNIT ");
+                s.print(m.name);
+                s.print(' ');
+                s.print(m.unit);
+                s.print('\n');
+            }
+            s.print("# HELP ");
+            s.print(m.name);
+            s.print(' ');
+            s.print(m.help);
+            s.print('\n');
+            return true;
+        }
+        --item;
+        if (item < m.samples) {
+            s.print(m.name);
+            if (m.type == MetricType::counter) s.print("_total");
+            m.sample(ctx, s, item);
+            return true;
+        }
+        item -= m.samples;
+    }
+    if (item == 0) {
+        s.print("# EOF\n");
+        return true;
+    }
+    return false;
+}
+
+}
@@ -19,7 +19,7 @@ public:
                 ++_stor.cntr1.pump_start_count;
                 pinMode(pin_out_pump_on, active_pump);
             } else {
-                _stor.save();
+                _stor.save(_stor.cntr1);
                 pinMode(pin_out_pump_on, inactive_pump);
             }
         }
@@ -16,6 +16,7 @@ public:
         for (auto x: arr) {
             _items[pos]._tp = x->get_scheduled_time();
             _items[pos]._task = x;
+            _tasks[pos] = x;
             ++pos;
         }
     }
@@ -54,6 +55,19 @@ public:
         }
     }
 
+    ///count of tasks
+    static constexpr unsigned int task_count = N;
+
+    ///get task by index
+    /**
+     * @param index index of task in order of the constructor. Unlike
+     * enum_tasks(), the order is stable while the scheduler runs
+     * @return pointer to task
+     */
+    AbstractTask *get_task(unsigned int index) const {
+        return _tasks[index];
+    }
+
 protected:
 
     struct Item { // @suppress("Miss copy constructor or assignment operator")
@@ -72,6 +86,7 @@ protected:
     }
 
     Item _items[N];
+    AbstractTask *_tasks[N];
 
     void do_reschedule() {
         for (unsigned int i = 0; i < N; ++i) {
@@ -88,6 +88,7 @@ bool handle_serial(Controller &controller) {
                             "/s - status, \r\n"
                             "/c - config, \r\n"
                             "/d - dump eeprom, \r\n"
+                            "/w - flash wear statistics, \r\n"
                             "/e <field>=<value> simulate temperature\r\n"
                             "/x - disable simulate temperature\r\n"
                             "/k - kbtest\r\n"
@@ -112,6 +113,11 @@ bool handle_serial(Controller &controller) {
                             dump_eeprom();
                             print_dot();
                             break;
+                        case 'w':
+                            print_ok();
+                            controller.storage_stats_out(Serial);
+                            print_dot();
+                            break;
                         case 'e':
                             if (controller.enable_temperature_simulation(cmd.substr(2))) {
                                 print_ok();
@@ -1,3 +1,4 @@
+#pragma once
 #include <cstddef>
 #include <cstdint>
 #include <string_view>
@@ -8,6 +9,9 @@ class SHA1
 {
 public:
 
+    static constexpr std::size_t block_size = 64;
+    static constexpr std::size_t digest_size = 20;
+
     class Digest {
     public:
         constexpr Digest () = default;
@@ -0,0 +1,138 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <string_view>
+
+///constexpr SHA256 for C++17 (same interface as SHA1)
+
+class SHA256
+{
+public:
+
+    static constexpr std::size_t block_size = 64;
+    static constexpr std::size_t digest_size = 32;
+
+    class Digest {
+    public:
+        constexpr Digest () = default;
+        constexpr Digest(std::initializer_list<unsigned char> lst) {
+            int i = 0;
+            for (unsigned char x: lst) _bytes[i++] = x;
+        }
+        constexpr unsigned char &operator[](std::size_t i) {return _bytes[i];}
+        constexpr const unsigned char &operator[](std::size_t i) const {return _bytes[i];}
+        constexpr operator std::basic_string_view<unsigned char>() const {return {_bytes,digest_size};}
+        constexpr bool operator==(const Digest &other) const {
+            for (unsigned int i = 0; i < digest_size; ++i) if (_bytes[i] != other._bytes[i]) return false;
+            return true;
+        }
+        constexpr bool operator!=(const Digest &other) const {
+            return !operator==(other);
+        }
+        constexpr auto begin() const {return std::begin(_bytes);}
+        constexpr auto end() const {return std::end(_bytes);}
+    protected:
+        unsigned char _bytes[digest_size] = {};
+    };
+
+    constexpr SHA256() = default;
+    constexpr SHA256(std::string_view data) {
+        update(data);
+    }
+    constexpr SHA256(std::initializer_list<std::string_view> data) {
+        for (const auto &x:data) update(x);
+    }
+
+    constexpr void update(std::string_view data) {
+        for (char c: data) {
+            _buffer[_buffer_size++] = static_cast<unsigned char>(c);
+            if (_buffer_size == block_size) {
+                transform();
+                _buffer_size = 0;
+                ++_blocks;
+            }
+        }
+    }
+
+    constexpr Digest final() {
+        uint64_t total_bits = (_blocks * block_size + _buffer_size) * 8;
+        _buffer[_buffer_size++] = 0x80;
+        if (_buffer_size > block_size - 8) {
+            while (_buffer_size < block_size) _buffer[_buffer_size++] = 0;
+            transform();
+            _buffer_size = 0;
+        }
+        while (_buffer_size < block_size - 8) _buffer[_buffer_size++] = 0;
+        for (int i = 7; i >= 0; --i) {
+            _buffer[_buffer_size++] = static_cast<unsigned char>(total_bits >> (8 * i));
+        }
+        transform();
+        Digest ret;
+        for (unsigned int i = 0; i < 8; ++i) {
+            ret[4*i] = static_cast<unsigned char>(_state[i] >> 24);
+            ret[4*i+1] = static_cast<unsigned char>(_state[i] >> 16);
+            ret[4*i+2] = static_cast<unsigned char>(_state[i] >> 8);
+            ret[4*i+3] = static_cast<unsigned char>(_state[i]);
+        }
+        return ret;
+    }
+
+private:
+
+    static constexpr uint32_t k[64] = {
+        0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+        0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+        0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+        0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+        0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+        0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+        0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+        0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+    };
+
+    uint32_t _state[8] = {0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19};
+    unsigned char _buffer[block_size] = {};
+    std::size_t _buffer_size = 0;
+    uint64_t _blocks = 0;
+
+    static constexpr uint32_t ror(uint32_t value, unsigned int bits) {
+        return (value >> bits) | (value << (32 - bits));
+    }
+
+    ///Hash a single 512-bit block from the buffer
+    constexpr void transform() {
+        uint32_t w[64] = {};
+        for (unsigned int i = 0; i < 16; ++i) {
+            w[i] = static_cast<uint32_t>(_buffer[4*i]) << 24
+                 | static_cast<uint32_t>(_buffer[4*i+1]) << 16
+                 | static_cast<uint32_t>(_buffer[4*i+2]) << 8
+                 | static_cast<uint32_t>(_buffer[4*i+3]);
+        }
+        for (unsigned int i = 16; i < 64; ++i) {
+            uint32_t s0 = ror(w[i-15], 7) ^ ror(w[i-15], 18) ^ (w[i-15] >> 3);
+            uint32_t s1 = ror(w[i-2], 17) ^ ror(w[i-2], 19) ^ (w[i-2] >> 10);
+            w[i] = w[i-16] + s0 + w[i-7] + s1;
+        }
+        uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+        uint32_t e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+        for (unsigned int i = 0; i < 64; ++i) {
+            uint32_t s1 = ror(e, 6) ^ ror(e, 11) ^ ror(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t t1 = h + s1 + ch + k[i] + w[i];
+            uint32_t s0 = ror(a, 2) ^ ror(a, 13) ^ ror(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = s0 + maj;
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        _state[0] += a; _state[1] += b; _state[2] += c; _state[3] += d;
+        _state[4] += e; _state[5] += f; _state[6] += g; _state[7] += h;
+    }
+};
+
+static_assert(SHA256(std::string_view("abc", 3)).final() == SHA256::Digest{
+    0xba,0x78,0x16,0xbf,0x8f,0x01,0xcf,0xea,0x41,0x41,0x40,0xde,0x5d,0xae,0x22,0x23,
+    0xb0,0x03,0x61,0xa3,0x96,0x17,0x7a,0x9c,0xb4,0x10,0xff,0x61,0xf2,0x00,0x15,0xad
+});
@@ -9,51 +9,255 @@
 #define SRC_KOTEL_SIMPLE_DNS_H_
 
 #include <api/IPAddress.h>
+#include "modem_driver.h"
+#include "timestamp.h"
 
+#include <array>
+#include <cstring>
 
-class SimpleDNS {
+
+///Small DNS resolver with cache
+/**
+ * Resolves A records over UDP socket of the modem. Results are cached
+ * for their TTL, so repeated lookups cost no modem traffic. Several
+ * addresses of the host are kept, the caller can rotate them when the
+ * current address doesn't respond. Query which is not answered by the
+ * primary server is repeated on the secondary server. More queries can
+ * be outstanding, replies are matched by the transaction id.
+ *
+ * @tparam Modem modem driver (AtModem)
+ */
+template<typename Modem>
+class SimpleDNSClient {
 public:
 
+    enum class Status : uint8_t {
+        ///address is known
+        found,
+        ///query is running, call lookup() later
+        pending,
+        ///host can't be resolved
+        failed
+    };
 
-    int request(const char *host) {
-        int r = _client.open(62124);
-        if (r == -1) return r;
-        _opened =true;
-        auto sz = createDNSQuery(host);
-        auto dnsip = WiFi.dnsIP();
-        r = _client.send(dnsip, 53, sz);
-        if (r == -1) {
-            _client.close();
-            return r;
+    static constexpr unsigned int cache_size = 2;
+    static constexpr unsigned int max_addresses = 4;
+    static constexpr unsigned int max_queries = 2;
+    ///longest host name (query must fit to 48 bytes)
+    static constexpr unsigned int max_host_len = 30;
+    static constexpr TimeStampMs query_timeout = 1500;
+    static constexpr uint32_t min_ttl = 10;
+    static constexpr uint32_t max_ttl = 24*60*60;
+    static constexpr uint16_t local_port = 62124;
+
+    SimpleDNSClient(Modem &modem):_client(modem) {}
+
+    ///set DNS servers
+    /**
+     * @param primary primary server
+     * @param secondary secondary server, can be empty
+     */
+    void set_servers(IPAddress primary, IPAddress secondary) {
+        _servers[0] = to_ipv4(primary);
+        _servers[1] = to_ipv4(secondary);
+    }
+
+    ///find address of the host
+    /**
+     * Returns cached address, or starts query. Call it repeatedly
+     * until the status is not pending (it also processes replies)
+     *
+     * @param host host name
+     * @param addr receives address
+     * @param now current time
+     * @return status of the lookup
+     */
+    Status lookup(const char *host, IPAddress &addr, TimeStampMs now) {
+        poll(now);
+        Entry *e = find_entry(host);
+        if (e) {
+            switch (e->state) {
+                case EntryState::valid:
+                    if (now < e->expires) {
+                        const auto &a = e->addr[e->current];
+                        addr = IPAddress(a[0], a[1], a[2], a[3]);
+                        return Status::found;
+                    }
+                    break;
+                case EntryState::pending:
+                    return Status::pending;
+                case EntryState::failed:
+                    *e = {};
+                    return Status::failed;
+                default:
+                    break;
+            }
+        } else {
+            if (std::strlen(host) > max_host_len) return Status::failed;
+            e = alloc_entry();
+            //all entries are resolving, try later
+            if (!e) return Status::pending;
+            std::strcpy(e->host, host);
         }
-        _opened = true;
-        return 0;
-    }
-    bool is_ready() {
-        if (!_opened) return false;
-        auto data = _client.receive();
-        if (data.empty()) return false;
-        _result = parseDNSResponse(data);
-        cancel();
-        return true;
+        if (!start_query(*e, now)) {
+            if (e->state == EntryState::empty) *e = {};
+            //failed only if there is no server, otherwise wait for free query
+            return _servers[0] == IPv4{} && _servers[1] == IPv4{}?Status::failed:Status::pending;
+        }
+        e->state = EntryState::pending;
+        return Status::pending;
     }
-    uint64_t get_result() const {
-        return _result;
+
+    ///current address of the host doesn't respond, use next one
+    /**
+     * @param host host name
+     * @retval true next address is available
+     * @retval false all addresses were tried, next lookup resolves the host again
+     */
+    bool rotate(const char *host) {
+        Entry *e = find_entry(host);
+        if (!e || e->state != EntryState::valid) return false;
+        if (++e->tried >= e->count) {
+            e->expires = 0;
+            return false;
+        }
+        e->current = (e->current + 1) % e->count;
+        return true;
     }
 
-    void cancel() {
-        if (_opened) {
-            _client.close();
-            _opened = false;
+    ///send queued queries, process replies and timeouts
+    void poll(TimeStampMs now) {
+        //opening of the socket must progress even if all queries timed out
+        _client.poll();
+        bool waiting = false;
+        for (auto &q: _queries) {
+            if (!q.active) continue;
+            if (now > q.deadline) {
+                on_timeout(q, now);
+                continue;
+            }
+            if (q.sent) {
+                waiting = true;
+            } else if (!_client.is_sending() && _client.open(local_port) == 0) {
+                //one datagram can be queued at time, others are sent later
+                const auto &srv = _servers[q.server];
+                auto sz = createDNSQuery(_cache[q.entry].host, q.id);
+                if (_client.send(IPAddress(srv[0], srv[1], srv[2], srv[3]), 53, sz) >= 0) {
+                    q.sent = true;
+                    q.deadline = now + query_timeout;
+                    waiting = true;
+                }
+            }
+        }
+        if (waiting) {
+            auto data = _client.receive();
+            if (!data.empty()) process_reply(data, now);
         }
     }
 
+    ///drop cache and all queries (socket stays open)
+    void clear() {
+        _client.cancel();
+        for (auto &e: _cache) e = {};
+        for (auto &q: _queries) q = {};
+    }
+
+    ///close socket (modem should be idle)
+    void close() {
+        clear();
+        _client.close();
+    }
+
 protected:
-    UDPClient<48> _client;
-    bool _opened = false;
-    IPAddress _result = {};
+
+    using IPv4 = std::array<uint8_t, 4>;
+
+    enum class EntryState : uint8_t {
+        empty,
+        pending,
+        valid,
+        failed
+    };
+
+    struct Entry {
+        char host[max_host_len+1] = {};
+        IPv4 addr[max_addresses] = {};
+        TimeStampMs expires = 0;
+        EntryState state = EntryState::empty;
+        uint8_t count = 0;
+        uint8_t current = 0;
+        ///count of rotations since resolved
+        uint8_t tried = 0;
+    };
+
+    struct Query {
+        TimeStampMs deadline = 0;
+        uint16_t id = 0;
+        uint8_t entry = 0;
+        ///index of server
+        uint8_t server = 0;
+        bool active = false;
+        bool sent = false;
+    };
+
+    kotel::AtUDPClient<Modem, 48, 128> _client;
+    IPv4 _servers[2] = {};
+    Entry _cache[cache_size];
+    Query _queries[max_queries];
     uint16_t _id = 0;
 
+    static IPv4 to_ipv4(IPAddress ip) {
+        return {ip[0], ip[1], ip[2], ip[3]};
+    }
+
+    Entry *find_entry(const char *host) {
+        for (auto &e: _cache) {
+            if (e.state != EntryState::empty && std::strcmp(e.host, host) == 0) return &e;
+        }
+        return nullptr;
+    }
+
+    ///find free entry, or replace the entry which expires first
+    Entry *alloc_entry() {
+        Entry *r = nullptr;
+        for (auto &e: _cache) {
+            if (e.state == EntryState::empty) return &e;
+            if (e.state == EntryState::pending) continue;
+            if (!r || e.expires < r->expires) r = &e;
+        }
+        if (r) *r = {};
+        return r;
+    }
+
+    bool start_query(Entry &e, TimeStampMs now) {
+        uint8_t server = _servers[0] != IPv4{}?0:1;
+        if (_servers[server] == IPv4{}) return false;
+        for (auto &q: _queries) {
+            if (q.active) continue;
+            if (++_id == 0) ++_id;
+            q.id = _id;
+            q.entry = static_cast<uint8_t>(&e - _cache);
+            q.server = server;
+            q.active = true;
+            q.sent = false;
+            q.deadline = now + query_timeout;
+            return true;
+        }
+        return false;
+    }
+
+    ///repeat query on secondary server, or fail
+    void on_timeout(Query &q, TimeStampMs now) {
+        if (q.server == 0 && _servers[1] != IPv4{} && _servers[1] != _servers[0]) {
+            //same id, late reply from the primary server is accepted too
+            q.server = 1;
+            q.sent = false;
+            q.deadline = now + query_timeout;
+            return;
+        }
+        _cache[q.entry].state = EntryState::failed;
+        q.active = false;
+    }
 
     struct DNSHeader {
         uint16_t id = 0;       // Identification
@@ -81,11 +285,11 @@ protected:
     }
 
     // Function to create a DNS query packet
-    unsigned int createDNSQuery(const std::string& domain) {
+    unsigned int createDNSQuery(std::string_view domain, uint16_t id) {
 
         // DNS Header
         DNSHeader header = {
-                htons(++_id),
+                htons(id),
                 htons(0x0100),
                 htons(1)
         };
@@ -106,51 +310,84 @@ protected:
         return c - _client.data();
     }
 
+    static uint16_t get16(std::string_view data, std::size_t offset) {
+        return static_cast<uint8_t>(data[offset])*256+static_cast<uint8_t>(data[offset+1]);
+    }
 
-    IPAddress parseDNSResponse(std::string_view response) {
-        IPAddress ret;
-
-        if (response.size() < sizeof(DNSHeader)) return ret;
-
+    ///skip name at offset (labels or pointer)
+    /** @return offset after the name, or npos if the name is truncated */
+    static std::size_t skip_name(std::string_view data, std::size_t offset) {
+        while (offset < data.size()) {
+            uint8_t len = static_cast<uint8_t>(data[offset]);
+            if (len == 0) return offset + 1;
+            if ((len & 0xC0) == 0xC0) return offset + 2;
+            offset += len + 1;
+        }
+        return data.npos;
+    }
 
-        // Skip DNS Header
-        size_t offset = sizeof(DNSHeader);
+    void process_reply(std::string_view response, TimeStampMs now) {
+        if (response.size() < sizeof(DNSHeader)) return;
+        uint16_t id = get16(response, 0);
+        Query *q = nullptr;
+        for (auto &x: _queries) if (x.active && x.id == id) q = &x;
+        //late reply of timed out query
+        if (!q) return;
+        uint16_t flags = get16(response, 2);
+        uint16_t rcode = flags & 0xF;
+        if (!(flags & 0x8000)) return;
+        if (rcode == 2) {
+            //server failure, try other server
+            on_timeout(*q, now);
+            return;
+        }
+        Entry &e = _cache[q->entry];
+        q->active = false;
+        e.state = EntryState::failed;
+        if (rcode != 0) return;
 
-        // Skip question section
-        while (offset < response.size() && response[offset] != 0x00) {
-            offset += response[offset] + 1; // Skip label
+        uint16_t qd_count = get16(response, 4);
+        uint16_t an_count = get16(response, 6);
+        std::size_t offset = sizeof(DNSHeader);
+        for (uint16_t i = 0; i < qd_count && offset != response.npos; ++i) {
+            offset = skip_name(response, offset);
+            if (offset != response.npos) offset += 4; // QType and QClass
         }
-        offset += 5; // Null byte + QType and QClass
-
-        // Parse answer section
-        while (offset < response.size()) {
-            offset += 2; // Name (pointer, usually 0xC0xx)
-            uint16_t type = static_cast<uint8_t>(response[offset])*256+
-                            static_cast<uint8_t>(response[offset+1]);
-            offset += 2; // Type
-            offset += 2; // Class
-            offset += 4; // TTL
-            uint16_t dataLen = static_cast<uint8_t>(response[offset])*256+
-                               static_cast<uint8_t>(response[offset+1]);
-            offset += 2; // Data length
-
-            if (type == 0x0001 && dataLen == 4) { // Type A, IPv4 address
-                uint8_t a1 = static_cast<uint8_t>(response[offset]);
-                uint8_t a2 = static_cast<uint8_t>(response[offset+1]);
-                uint8_t a3 = static_cast<uint8_t>(response[offset+2]);
-                uint8_t a4 = static_cast<uint8_t>(response[offset+3]);
-                ret = IPAddress(a1,a2,a3,a4);
-                return ret;
+        uint32_t ttl = max_ttl;
+        uint8_t count = 0;
+        //answers which don't fit to the buffer are ignored
+        for (uint16_t i = 0; i < an_count && count < max_addresses; ++i) {
+            if (offset == response.npos) break;
+            offset = skip_name(response, offset);
+            if (offset == response.npos || offset + 10 > response.size()) break;
+            uint16_t type = get16(response, offset);
+            uint16_t cls = get16(response, offset+2);
+            uint32_t rttl = (static_cast<uint32_t>(get16(response, offset+4)) << 16)
+                            | get16(response, offset+6);
+            uint16_t data_len = get16(response, offset+8);
+            offset += 10;
+            if (offset + data_len > response.size()) break;
+            if (type == 0x0001 && cls == 0x0001 && data_len == 4) { // Type A, IPv4 address
+                for (int j = 0; j < 4; ++j) {
+                    e.addr[count][j] = static_cast<uint8_t>(response[offset+j]);
+                }
+                ++count;
+                ttl = std::min(ttl, rttl);
             }
-
-            offset += dataLen; // Skip data
+            offset += data_len; // Skip data
         }
-
-        return ret;
+        if (!count) return;
+        ttl = std::max(ttl, min_ttl);
+        e.state = EntryState::valid;
+        e.count = count;
+        e.current = 0;
+        e.tried = 0;
+        e.expires = now + static_cast<TimeStampMs>(ttl) * 1000;
     }
 };
 
-
+///resolver used by the controller
+using SimpleDNS = SimpleDNSClient<kotel::ModemDriver>;
 
 
 #endif /* SRC_KOTEL_SIMPLE_DNS_H_ */
@@ -11,6 +11,11 @@ public:
 
     void clear() {_sz =0;}
 
+    ///discard text behind given size
+    void truncate(std::size_t sz) {if (sz < _sz) _sz = sz;}
+
+    static constexpr std::size_t capacity() {return size;}
+
     using Stream::write;
 
     virtual size_t write(uint8_t x) override {
@@ -167,8 +167,9 @@ protected:
         bool _first_value = true;
 
         void read(SimpleDallasTemp::AsyncState &st) {
-            set_value(SimpleDallasTemp::async_read_temp_celsius(st),
-                        SimpleDallasTemp::async_get_last_error(st));
+            //async_read_temp_celsius updates status, so it must be called first
+            auto v = SimpleDallasTemp::async_read_temp_celsius(st);
+            set_value(v, SimpleDallasTemp::async_get_last_error(st));
         }
 
         void set_value(std::optional<float> value, SimpleDallasTemp::Status st) {
@@ -1,6 +1,7 @@
 #include "timestamp.h"
 
 static uint32_t time_offset;
+static bool time_set = false;
 
 uint32_t get_current_time() {
     return static_cast<uint32_t>(get_current_timestamp()/1000)+time_offset;
@@ -9,4 +10,8 @@ void set_current_time(uint32_t t) {
     time_offset = 0;
     auto z = get_current_time();
     time_offset = t - z;
+    time_set = true;
+}
+bool is_current_time_set() {
+    return time_set;
 }
@@ -29,5 +29,7 @@ constexpr TimeStampMs max_timestamp = ~TimeStampMs{};
 
 uint32_t get_current_time();
 void set_current_time(uint32_t t);
+///true when the clock was synchronized (by set_current_time())
+bool is_current_time_set();
 
 
@@ -1,8 +1,40 @@
-set(HTML_FILE ../www/index.html.gz.base64)
+#Generates web_page.h
+#
+# -DOUT=<output file>
+# -DASSET_DIR=<directory with compressed assets (<name>.gz.base64)>
+# -DASSETS=<names of assets, separated by ','>. index.html is served as /
 
 set(HEADER_TEMPLATE ${CMAKE_CURRENT_LIST_DIR}/web_page.h.in)
 
-file(READ ${HTML_FILE} HTML_CONTENT)
+string(REPLACE "," ";" ASSET_LIST "${ASSETS}")
 
-configure_file(${HEADER_TEMPLATE} ${OUT} @ONLY)
+set(ASSET_DATA "")
+set(ASSET_TABLE "")
+foreach(NAME ${ASSET_LIST})
+    file(READ ${ASSET_DIR}/${NAME}.gz.base64 CONTENT)
+    string(MAKE_C_IDENTIFIER "embedded_${NAME}" ID)
+    if(NAME STREQUAL "index.html")
+        set(ASSET_PATH "/")
+    else()
+        set(ASSET_PATH "/${NAME}")
+    endif()
+    if(NAME MATCHES "\\.html$")
+        set(MIME "text/html;charset=utf-8")
+    elseif(NAME MATCHES "\\.js$")
+        set(MIME "text/javascript")
+    elseif(NAME MATCHES "\\.css$")
+        set(MIME "text/css")
+    else()
+        set(MIME "application/octet-stream")
+    endif()
+    #page is revalidated, other assets are referenced with version
+    if(NAME STREQUAL "index.html")
+        set(CACHE_CONTROL "no-cache")
+    else()
+        set(CACHE_CONTROL "public, max-age=31536000, immutable")
+    endif()
+    string(APPEND ASSET_DATA "constexpr auto ${ID} = StaticResponse(binary_data(\"${CONTENT}\"), \"${MIME}\", \"${CACHE_CONTROL}\");\n")
+    string(APPEND ASSET_TABLE "        {\"${ASSET_PATH}\", \"${MIME}\", ${ID}.body(), ${ID}.etag(), \"${CACHE_CONTROL}\", ${ID}.response(), ${ID}.not_modified()},\n")
+endforeach()
 
+configure_file(${HEADER_TEMPLATE} ${OUT} @ONLY)
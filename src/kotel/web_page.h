@@ -38,6 +38,117 @@ protected:
         
 };
 
-constexpr auto embedded_index_html = binary_data("H4sIAAAAAAACA+w8227bSJbv+go2gwYmnYjiVSJ9w9qyHceJ48S23O3MNAJKpETGvIWkJMuNAPsBM68LzLxl3xvYh33teVinf2S+ZE9V8VIki7K6sZh92HUQiyqdOnVudW5V8s43h+fDq5u3R5yT+t7ezsnV2Wv4fbR/uLdzdnS1z00cM07sdJcfXR13dZ7r7e2kburZe6/C1PZ2euRNZ8dzg1vOtXb5qblwJ2HAc7Ht7fKJE8bpZJ5yZCxdRfYu7/rmzO5FwYznnNie7vKWmZpbxej22EzsvvrcvT44v1iKr17Mwn34eXM5co5GM3gaorf7s+H+O3g5fD8ZnPbwiH/6+kKEsVef3ry8fwkDL5TL0cXB9dHHk8gapWPpjXO8P13+oFnu9/eD/Xf+wfvRm5UYvBsev5ocH7qr01v3MDw6P1SPD2ZX96/PzqXh0rw/CKf7r4/k18uPQ99xh85Q7XuH/deemA5sT1YnE9sw7j/Ki17v7cp7cXX5zt7vPzs/na/ejcLhS+ndofjs8HYoi9f+pbc6GWm9npUeKwfLoyPtwFYHPwAVo9dHn6L5eO6EV/HJM9/fv18Fq+HoRnl9Ep2PnGk68tSjl9enP9xdXQcT8cC4u5gdhurF+X5y9XKymto3r+4/HS2cdLx/8CLwX4yu1VHf8qX+7cxJXgzu5ZF3Mbpz3hz6Wvj+cPyq5528GQ7iU8s4Wb18+T68PX4RHQdXHxfhjaH0jPPTc9mJ7m7k0XVsesPX4wsxuTi6Wk6MxZV78f3iaNmbpJp7++bktKfZ5kWsHN/uJ4PF3Sqd71vT02eWr/mHI10dS2e3yfKFrpnyWfpp+u7lwHI+Hu1f/KAunh2qM2duz+9+OJjdDD71R+/Op2PbN+f3una0mjofYaFXI2+2OltOw+FYUeT4MBgmQ3d4Ixup/dJ5dX84txZXRj96f7y4GV6szLNzQzo9vbZezmXjzc3ISPffmta7t0vvRtUG8rvo7NyVnznfHx30jy5v4t6l5U7voslb1Z2sUv3QvkzPLnpuf3Ex/jQN3x9HNyeBEyvO+yCaPts/PQt9d3R0Kb69wbZ25B1f3V7O3/nDIQ/m79upyQWmD9a9cO1lBFbPc2DyqR3A3lm6VursWjbsDLuL3zzn3MBNXdPrJhPTs3cltLM6O0m68uxsl6T2XdqbJAmgR3uT+6kzNie3szicB1Z3EnphvMU9kaeyKZvbnez90nFTe7szhYW7U9N3vdUWl5hB0k3s2J1udz53hIUZhwszcAEfWqFreu4s2OImQKgdb3ci07LcYLbFSba/zVhxZXteuCwWjG0rW25puzMn3eLGoZcPJe69DYgEGaH63Hnim8Hc9JBU4tCLzMBGTEVhAoIIgYQkdSe3K1g0jC0bcEvRHZeEnmuhoTQN/S1OZJH0RMQ/Joa7Q6tiBgiaLgxtd3wznrmwhDlPw+0O1sAWZ4iLJfrorpsNaKIYATBLLGzqhXQJ1Ft2AnxYbhJ5Jsh76tmA5OMc2JmuupkNAHeRCco3MeXbHYy+C8ryE8R4bKcTZ7szM6NM8DnBUrvoisWF8RykEyAinEwJGkzj4OdRuvc47juYlwlAEsVvtzeZIySgFjsGI47AtzfmW+7iSZwk7taWOQXxAUAhBt4a+zw2xKU7dcupioxEn9OvYEXkhiDnhsClMRhzZMaAKv+4m4YRDTKZx+jjIbKNAiY2LXee5HhLk4MYZabuwm63nIzQra2xPQ1jG+3CFsiMEVmlGZHlfw4j5hgmzdHeLyUNYvbsabqFScDIlYjmKNfNIwxJfZohSf3fY+gf//rvOU/9gie9bctCRmJ3c7INBLWwY3Ax4HMJpO9almdjgUyc1dgEUVBuixMFHW2+zMkQT0evEyPM2+W+D8KAQibch+PYvLcDk/YNYy+c3GIgsmdzJ/iY80DDXRs5DuwitKjwaUTImZuoYBWQoH5iihSLEE/KnERl4h5H3gFdPiyQO0eyRPFRxcPj9YvQIQoZMBhEQKMrIABEpt2cmA8AKeFtEAqJPUFE0/GhJL8RILhZbK4qrlwRETbMJ8QMrCr0UI0DxH4qpAMjnLRY5q+McDP2TKRCvGkc0wqXWB3FfzDjPCAZEubn3kzCceDegkLMcS3k1VUiCgNEDqEXRbtSuxV5Y/liY8xpAAkiI+cy8prrNn0x/y1fhZu6XkuaYRq6phnb6yinqabCdWWBcXgrcesFUJmc7V4x90Vi1bUMYtBSu/shGLUCiEGMMMbyqOZSGBc4e6ABP0KIsP/QBT/2HP4/bSCR2zhiyuMRlvT1LGUo5TU8yZvzRLEEEbtEQ8VzZGe5D9WJcVakK9M5WoXExge5EKhPWIH4c+dfbu3VNIZcOkG0rsIInGjg+kCW+C33Uwh5lJuusmTjc0c1GINaBRIPGUZjCAE351aFIaDli62B6DAJxRXSpARSoSlK6e1tFgJWIvT+4QuCePj5loNSevHrX+3g4Re+DChZrGD4P2wppYPL/S3lNRrhEDvWhWdakIQ2403vO46ZkHLf9ToQtRNkSlHokriKIxDOKXBUstyY+GpYCujzg+2q9QDuIndALh7hhLHM42Y5ArYs9Ek+nBuLlIcSlFL6YQqS8iPw849sOWKpGDd7/wFilQ5AlcIg+6zpB3EOUEtcpHJPwGJKEZIwbINuKo8sLeFP0rEiS3yRa+Q1VjPE0lrc4wA3CsRIC0AnBAEpLywK3HkyxCS66edVVS2oeKLretsWrVEh4EjNwjcYTBWRzVi1YAScUbywb5MojNzE9tvKUwY5DQtt4NpD1VfwnKPJxrlJMzWr1r91TFvmBK2JiGM5VEhInsP/p4yJTgjZZ+kGWMbLkJ+OfzSZCo8kkcfZcm7tJCMnJk4+KUJ805/QiQtKGiSUsaCsHq+mYdItM3HGoRlbTVdR5p+PVLjYLJcxAke/a3hz4624CnbhLaR25IV+VqowCov/wZBEUrdtdvwj7+o7CQ+27JKC8mbqV0t8KulTc6YANv4BuRAsg4zouE1mzVQxr03Ju9zpZV6vxlEWTR7xDvlWZtBq+hGmleHreAgsgQUub+1EiklpEyazSi1jss9gkbFYKov0OlRKTRZCaincQWZakqBkXqGBTaWx9TfAVRRJTVx9hIsEeeL2KVSsfZHP09fRkJWrORFFpGylAtKhtQJiI2SJKLBtKLTL3W5Ut8zaUoKIoRLCqzE7352kdYdccYZWSrjCSdcIgkCcEVXp69SryiyE0xPdYJOJs9i2A6YQGNMot1QPRpVeDm3wUdme0VDLje4FdOWsy9NcO48+m8k5d4IVH1hRXUvXqek6stbPhLR+MgUyvU8WdsehtUL9h7w/sN1B8XMKLqd7t+W4lpXJt2gtNJKAlkRo06SCaoplOPJ+ILM5WtDR5jbZbK7BJRSpBgOlMZ1O5T4bawZTNgLQ0dvUZNQg/J/kgbrfTBEq8YNKk4l9cd1K86YIosV4viQYHV6ukYA02vvFHiarVdPwwgbQ22zTMzXWZnXshqOW7ZKS1HxvPq8ONis3vrlTmflcO6NShdGyQQsi1DS6sJNbYnGVNSoZjcMUZaKqaNmzp3X+avtfMOo1BYfBqbyMeH1m0dQtu4iPd7RYpVjVj2ekRnMc/+vyrZpEjZ6i+qqcGLGb2qwd05K95eSsz9ozyqjSUqxn67UeD5Y7M3WlPqm2fyq2x+5P4VThOcoYIBl6yuFjxT+A/p5z0tPCKjRkFZTjJGUJOxjl6kHxpAwq2bxN6yAaL1hwmInWsU3iG1jumOHvFEOZqNPJlKrPtPIcouwWlHm8pmtTnX022TxxzLV033UDy77DhTSjv01CS9deAKHJFun3t58bocqfHPmmrm/jQj000+LcgAawQGglAMkWCyk94oHcAB90VPdJtutKvzpgu5EsUWFtisomz9LE2gEKhy5qoNUpaiHXAGLjkCK7pY9SmQKsBaiNBGIs5lHNtgrEfj7Oqcl2CdVFPbquH1o20kTq1FqJLShIU7FdNFkvcR0AaSOuOStHPcUnSWouqOyvFhSLkPzGdOKHL4uHL74gCHnWtzBj14TXiRklW4lvAp/okWndzFqp0iJinc0jW0QUbnyQPbbTJea/0jistZsa+7Ky1B4+ei6OfOslXEsCl4lyXcr1RB/oki7lqdCTKf5paTthbAIyG2kdzkzbNYz0dHnddGzx5HFtE6xEJ7LK5zf2fQCmgfvEFdJZwBfzr38JHn7mILo/fLEevsBz2WMEFoyxMW7Ik9mgvBh9/fObr3+jFg0jae2My6vztxVwcS34/ujq/Gz/qsaV3JJOawrKqCuQAkoiWsW2jz40sbPnetxbL3j4hVs8/HIbBnwbHulxPJcg0F//bm+ATH4c2cPfUm/u1zAorHk10SI4lQX33nTMj+Ei1zsNr7Hgz+HjNIcVkvn4Q34Im5/GovtNbTG7taF2fHys1jEK8wBqOBsXeHfdMptTcLenqPTAB+WlHl3YQzBKWjCSF5hRR51nugwi9ur8sfrJrHn0NFaQ/se//Z2nT8Xxv6KvvI74Kkls3P+Z6SnT0V6NCVaqmpcYeuPoqBkSqMN8uaUdmJ8tgmUFJrKtD7jjkM4r1Au4EKXiSn5Pojbpj+gSKMRw27N2eYjR/I+csEjSeYSvqjVvUKydHs5TPH+1BkFOJL5w0JBf+7k/o36oyIo+EapfgSH3FCi15X3h3xh0q1lweW2MGYxbypvyigWjUO19x1F3P/BtCnQ817hzUjnGW1dModU+IHZMyBfjJsfZrSQ3mIYV660gKSDyy2Nrm4glTcyT+NpdkLKOIaWTLIhPa4vmynq05y41eiZazDg7eKTT/rmDr9c95yDJBukxO421KjG7BGqbKYsi1h6W0L91hRQ+BWT3TjB5f8S3VYO5P7bjHzeQDd34UIkvJHjAIMyxZ1s/MhktKC3zF/RjGDl6dHN2i3NTWHtSIBUWoEpUjbDbaLpYnk1CoBJpv4ItLL/f2HIyBT688L+NKJLdGwO8+rr4CEwoCFmKmBfsuwk2scqFSoY0aK3ASh5UAzY+gMdPtKqLS8HVJVLSYa00C1kQqcP9VD/J4CjsT4bDYW1enGX2TbIzH0r7y+z4oYEgtapiz6pmzEsXe0MIJOhgsT7ZQVop75rRXaoapCVUHT3YwOHhwTYTITNr7dKNwGodTkd9vM0bWKH0xcKlCSBqZRxf52256lEkGKsXgo9pXMOthXS55QwJD1GOD2pKvH/ubQo3pppqxdNd+1pll80oqqBajUvdaS56frgYdMLlBLLStm1GwzTIKZHVGaZSBHQFx226UeZt8sxG2aTgCEBSjXngpj9mqdlzrvlBo9Jf1yqunsYxL/1l3dpaEyq7dVr1/A06d5MfiySSKxL+hN9uQvosSJ8JyUTqM7GGExbsf/3HkAUcMYG/ZYHeLlmgt98zYWdM2BmTt4/t0FypFJJKc0RfOLIViuyDJlvx5rZRIj47bUVMDkWqAYS4U7T5GLqmSa9QXsffRvd2G9KcbtqEmEgJzZk7wqbc2hFibLTKLa7Pnc5OD0f3vZ0e+WLawfnhzd4OukAy8cwk2eVJH5HH3z8L7BQVsvOEJyBorOyywmAPRrNvr1U/R23a/HPyu1NAID/CV5f7gMf2OugKNU0McX+EmCi2owCKkQ+xfe/6fIGWwp7Nyr+WQ+Ylrj/38F0IPiuBYVX8yu+9PX9/frHFXSIQNOXhC0dqIPM5lKzze/CRdpJ+8803jFWKCzgMuisxJ/scw6CbUnvXD7/gWurh53w10Ar6oISjcOVHz4SbvAzLajWTQl6fSFLsVBb5PVnMGHgEVgVYdUPYPsD2N4TVAVbfEBbyNH4Pfj0CjS4uxvaUI+fxhTm0gU/m8aaghI78lhC/1+0K3Y2m5HdumFOot/Tj5kbz+03m/y2GWAzkU/+XLKa8FL3OVvK71cRWinftlKOjIZ7DUQS57yy+PCoj/H0FczOw8SZg8mbY5A2wYWUgHfx2FRTH/VVdYGE6EOAhCtX1cl6eIXBOiO+q/8zUEMKR4f9Arh1AxAotc2F+/QtNA/4+eJW7OpnlzQW2MFrkgyigblw3A2i7vNhcmDDnGjITF0SQhvHv4cIMNmHhMUrQZQR+7+uf7RjKSy/8HYQQDL+JkhYbKrpiDBtCnzUs6O2vf3Wj8CMyHG7d3iaTWaKoGj5b8UniWqxNUQFCX039fTuHwSxKNpMPSzdgcWw7nm2t1rHLUNxOsphx5CvjvIS+ksxn36Ao3qKvmB+Ed7s8ucAtq/gXX8HJLew4gTITJgkS37CMO98LUCqbptFWr7dcLoWlIoTxrCeLotgDCljWFJmp0xhFPyCHM2OgC9pAl/U+Z4hQAPSlgaR6XUnUBfyoUI8TRRQkRdW1QVcxYJaIZqm6IA9UeOrqujAwNFU2qDFJlQVJN2C2KSuaMFAM9Dn1iM9XumhAk/GLMlAAmnsMGoNp3GYz8ICq9oFyjiw10RTgdUAgQA1C35C1gdSVdOAQTywo17oFO14pCw49aqpqKhKgU2EuVz6RRVVV0JU+eQ+fDVQ1fyGfgzDVPhISABqgAW1wf6ZJomCI6JnrqwbUdUjapjQAWkQNL1s+YjOCAUnQAUhSu+Ujx34kM4AaVREGMCDrBB/RP/WIAbtM1PecLw9EQe7L2A6Q+SBE/QnMGAialqk9A8g47sKLTuRGBk5UeFUMJB2zKRugsdsHBem6owBSA/RV4CbCzJDBOsS6uPoCQGa3LxqCiung+rIoiIrsyJIkGH0drakb2H7Lp1w6sHJfQUudIK6JHU26mi4ofR0Ik8S+IGp4a6hAlIrlQA2Wj9eyrggilsNEpGSiCRLYui6IOrbI4gO0q0QNKeC1rMJelBEaDixVEhFrpjYQVMJj+USIBn1i7Whd4FPVHQ1JzUAqngDdqioR0JI0riCdHqRIV/p9mIeeWfrpFjLixGtJgU2Bp5mwZ1QZYy2fyJ6F9/IAqRs9KSrS2YmiwHIS4hckhVwLWtnURKGv61z2QpaDN4YOS8hoWBqAZmRDULDmFxrsWU1EjxO00QVFQTuZk0CWRETFgsWTVo7dn8lg9mrGvwRylJAxgAeUkWXLnKTJAtaT5GRDi245BmY2AFeIlAyucNAXpL7J3OulxE6QbvsqG6w0PkcCU1VkeDZgERCCCsLqIztpX0Drg6LlRxcgYNUF8n0K1iaLiLXNsCgO/Ae6kCd9hC7lnmdGIZTl7/LoxgH84D+oUk1xIKqtC/b1nk/zbnYzlyTzo723+Op2TG7cOCF952anFzUTieKPaWR/u4NnZwd0LwnIeTSjbkmX12RTjRUeyXZZqezjeVPObi6wrPjMkiqclJbYyGkG+SM4E8ee3I7Du6ydBpAfyNXTD6gTuUC8lvlwD8/MCcFrNEkhf7mkbb3YDGY2j86+IW+CV/MOJ12odrQjPEQJ6kMSgbz5JucVe+pUOnD4skF2Upg1LMkhRVnTsm2MZoE6aMTHFTzOri0z5SLTcxdhixbIX7lIcBYOCfAQv43KvPyblnn/3dy3LMeRG4vu+RWlGh+rWmp1k9TDMilyYqTRnJFtPcKUPHGH5m0Xu6vZpX5UTVV1k00NI+7ybs4HnPBKZzcLxVnc3Y0Ybzj6kfslNx8ACkChik1SsmccFqvxSCQSiUQmkEjovkDsqlLDrhpivpfM+pO4P97xuYpydumHk0lQjOK8tY2MPM6SX/4DmO0nb5FMDpc2a/EoskL91biYn7+foAVBLmtBfDRLsvlb75f/CHNvFqaT2S9/h9yWULhrOInDNIWH+Sw5Rl7WGKXS5B+Bnoe4M1t4wWl5Yfst2s7n708Hs/OfV2ptjHBcjVWGh0rm0WQUgpHDzaOpzilh29OwOFxOALx3CoIA5up4XuLUMOE/TytiRpcHBnjgIGj4LVjjsyQH5lwWk8hFLfYeAJMlnMzhpz7daCaui5m4ef++JOhIAO0RUIuy1f7OonQSFrNwlAxmSRGOQOC84KTz955IXLE7fwwpYECo0Wi+Qqc2VujUWIBGYXDZLkHdC/pkd2+3NMwHIXoxpjATIx6mj/99lXECdUbKzPvmEs39W22spiEWehHlU5joh+c/F0jpNMlmICOABz/kk2YBt4gmYwDwPOnTp5sYlVppFgJTY715fv7h43sPZEk/QamSh0VNTS1qji4ROXn3FYojADBJ0EsUcBbplYIv/1ibV0rR/iTJI9xnGCTHmgz1d/dglbahWyvQSguQcKRbYf2RbnmOdeh5PIunQkYvKrv/TiIqJz0XuPCkBOc4gfp1Lle63JhKsfH1+U+TcejRBehGecFTCowTS05srK+0fhTZbNDjKYQzAL6cE6Ch8irzp6H6qhOpIoi+/c4LB1mUhzy+01/+nilCCeb+HhKBrIrZTUnSJL+TvhyI18ZZVJN8e1ARcPfkYPwes+JTKHR3RXlWDkYz99bJsFVqXVuGVaSOKRt6ydgQPZrgkgLLkPqXFl5XkVuj4155dngV3fkvSxj0kudq6DSJ8wLgNVk5LlK6aHRlurgcB2rpQhvpVyLICwJAO/WadfArNw5eJfOP/zj/UHhff/vk1Soq+WDUTy9S/78ieeSChm4rEtIsKjpxSpJhEs2OaN/+vpQP8HVBI8/DHBYGEn3LVZqC/0+hypXb+8v5z/1RcorKFWjys5W6dxQW0XG4vHKbX7/YE8J9ldYGs/xSLVUEYTiAttDvF5j5l7+Piwg66p0yBqA4kzoB6u7H/zx/P0Dt/UIl+Tv0Bt7be/Z1Pfoavptqddj4newXTscOH0+Z60WlmVFEGu512kmBFsdJVmkr5RV06c2cUxzkCKwh8L3A9MQDahVhVszB+ANSfTiN6raznIuIFJzREATnq/P3mbiMVEq1ehH5KZeR1bRf8hG9mrx0H443KCPoBuiXs3EEVRZozDbpJKR/3Fc2Y+e+oSkKoxgUF9/JX3rredn4n5f90YRMc7GhGKk1iiFOozCfZ5Hc6ToF7gF20RWwCzCWm2gP7t+/e79UpxzGIQbU6ww3xkdFg0bllS73Kywzu/pVP7eq7unOpOWQUPkVu7ap9Uv0ZTifTDppchxlPdIlq/vV1OwkASbGanXSU0cv7Uv0tN3ZVXE09zA1JIfhLNV3wRxzpkLyWnJXbkQ2zYJPSO4JiINaajdR+p9AZcTtkxJZ2++uJ24iu7GXnn+Yhf0a+/mCft01zB2zX4X0JanbZ/8VWeHTvDqoXhplMUg979V3zy8kxKaxWWfPIxjdfv0U1pyopaqqSSXvDi3AY+24aOV5UCdPNaHKc3yOURqOroNiluDCdv5h8blwPJxn6Ch9GRwr0uYz05Jm8uVJ6UTzc9IT8awnp/yv7uTT0KOHYTwpVeifxEbQ0nubJ3MPi+AO52mI28c/gV59mHDONJ6C8pic5uHIAdqpLDLqydj/pAbzShogeXBdTvPzdeeuUgrz5SRRnC566TKP7nxZZ9JF5nCzKka7b4CBJ6QRwg9niVe0WV+f/3VyGDbUzj7+97RTzYeUTD/YtXB+RJcCV+zDk2gyBpX/Z+T2RXJah8yA5wwzANkbvX4yn4GlQ+nCeKcUGNZicCEMcUBM1zl0GPJ+x+ogwsXRShBMqjUS5XF0qsyqeopIFloR3Xl66c42tXCJ7pRBLEAAaDbiKkN9HBf9UQ/jUVx3wAGJ6w03Avj0g62pQv5uapgiK9AHl8Uea7XXI48G6DpE0sB8ZlLlVTPCKnERrrAEfhLSlXCuQ7kSymcm3Pn/xSAyl6ZWP0km1yQUggC96FpkkjA+g9T9NsQQWm/R9jlVO18rLkhJek3aEIjrEIYAfG7xhPoM7ocWQKNxQo4aK5AHY/XgpeNrkkiBuQ6ZFJB/JqnUxtlqMp3883rXodoqqsGnWdyNTosDXu1gdoXu4hWcXgYaZA8NCdxH/FV3WN9aWaF35I34KRRWAnQdzme/yE8vNo09sFXYG30iPwFBEM61VBWo/xnIobxuLzHVPwk5GNS1KMIgPgNRXsq3az6YDnGriIcsXPbw3OVXLhb20qSALqKDBbrXhit1rp/M8vk0GvTGoBUlRTgxukdHMNfqW01T9giPj7qDa3Yf/YSX3tOnr/788vlKXY8isPinPTqAzf8Vo7qm72DwjoXY7qIdGvnrUgeYf1nOKN5CYR9frrA59X24QNu4uNL2FAXVudrB5F5Kp65h4QEHJuYpbrlrle6+tnLxHHiKLkReriDkZN4Pzj/gWcLbCPcBx8mcVcW2FwKHvI3RVzjxpsnHf8zOf1JjwHchwqLjvcoSCZFPS4FPoJWpl6Txx/fe+Pz/DNDVmCPmxI4Glx0F9TVgjH2dnb9ve2AtMsIAZZC8RTeQQYK4RZPZsg1qy4yBQ7/4XUY8BAmn2FiRTGWDgkfk+bYYqzfj8/enQAACsBBAf/m75XBZ72YPnT6cnP80xcZzcdA+NegvL6ZXQ6Eg26WTj//bk69JgkmMeDw6zHYfUSDg3eCZNx4sP/6D8Xsbwxc7OMgqbfJWZ18Hj92Df24DecbzgXkKa9QCSFCug87t1ExJFjGFasUGTNEL3BY2nDP3116tlJhKjLhHHv+N0zgH3gzRj5m2xBdLvp0QeouP76P+CD7S8w9UptGlT3h5L/3dP9LsiNAd/zTE8w3gJgwVTbxYQhBcqaZ+yaerbYaLQFtXvIaie3noEka5egxGIAzyWJNIkeESotisrPN9Nv/4HmrogoOJaEq0BhBvxiHMC0ESlCc0iao1VuJtNzNdObWBr/5ZSwzoN4ts0EsGqYpCdKXRRzCO5eVlmoWLwdzLYzyfi95GIKVPxaAu4MeY3LO04f1yZScj12nRdc6CFCVGUCL6ZxDCXpm9RE6RfzURFlLj+fxEUE3hxa4izot4vPyXdX8aYQiUHmZcrefP0UmKxjIT/lWxvk/U4BiW+9WrbnS5TavOR8W6W7w4PO1PolCET8qiPCqE75a8E+pQYF3nzTIM644vvyRVNGjSbmQsmt3NSm8zPLI8f19EHJZeXoxpPv7Wm44nk3la0+wou5K7W1PTK1FCOMbVusE4DQuEMs8jAWjATkvKg/lTH38/yvtZnOqKTvct9J5TgaMRFXzyNe4X+ODEfMZOO2BV4nsfYLziXdtpb56BaoSqQZBFP7S8d2tZVMyzmffy8C1Mgc44WuaU05mGaXDi7eyWRbjemz8/e5JM0wQUzSI4aXm3PX/Hh38duQBn/+QA4y+3Om+TeBbc/O1NisassBtEk3AZTIEloP9lS7PoGK2MaZxHQTJmJGAqvAZ+TeYFJLU9UQdhGxBh7QPawswBHKA20glDL6fejuf/NfvrzNeawcwO2AxxEUCJVgcGcd6PgiA5fNv2MA5si5ueRGA3LAACpokKN3dutr1NjUwnHaD9NGgBOvHQC8aL/fUDbAuA7dOPAwAAHxsHiK/AADLhV9t7d2bTBYn5OJ6F2fIbfPkkSMMCLAkwAw7nw2GUtTiELUwCjCIDkJFkX8N0+Qv8DESZbcIcKAb5787Er+EQKAkJ6xjelmB2gDGehv2RHG4+0vWCE9GDPqyhnj+PZ8WDe/4Wwts/gW5gf7DxzlFUPI6P3lB+wPDBWMvmUWtbNnd7x3u47R1mUYivpCh4dzdr4L2hzHpg9yxgUHzjQQ2sZ5hXD2rTgVctrDfx5YE9bID1sB7URrWLD+t7uBKgQTQM55NiyytGWXJMLPMapMlT3OEJ/PkMlsrjmUfR90nMbOG8Ji6g12/gX8m288JgV577TnZFEd4ScyjMMuTU+WTCvChZlxKACb0AU2NiTvjzCMl5+3Ysq1+LdYnVcGJioy0mHUB788xgNMSWydtemeeqQE2Oa4JZy3wOTONrQX1YC/ThSjBr2NHZ+ctCvD5fIhrAXS0JUXAaAPoqy8LlY5KHAiso7pKZWF2TzPATf9H6730XHe4l/XFUPD3pjzC2BLDWFwWvRjsb/NjwF8e54uUvCljgZwP4vQ/S/ouUl7JciOEvYLqI1l/DCvSUJk8WtLBkPDsqppB5Z4OgjKMZLlywoH8R4xI2DCcYF/4L3G6nctweaBb8KBYWEZMyAP73zjCPwMBabGWKjgLws21eS7J5HxQQzFtDhaSjECC/a1ROwqNo36dUn5Yx0WxZZTiZ56OACAmk7lHRoBjPqjAhcc0Jl/MYwmwAS/kP8ygvgv500JaRlmtUBVIMImQDEgbIFMguydCDyt4OEBL1o9kR6ACU4DFGMBwdoRNBMuAeAZE9R22hUsraNHmIvzpDwCDYh+QDWV2gJ1AD1QLVq8Bi7XgGSmM8gG5NpyHwC2poYKhJHUI2z522OiATHZ0QRNI6ckMWj2GYw1kfwWozoyWoxZ2Jc/qr4OiN2X222lq1uwxO6+6ZR/VVXH4xP8rmtJbOaDXgOPAJznOgOwgDmNZh5oHZdxQNqIoDxnTQ4Z1BECACoEgAuFpVFGTMceuuDK7Z9kp4YsRu8GDICb8vkTwo+b+aJ8TEWW2BToqTal9wN7KYnEo4QzhXw1Hml3NRCDY5W2mKiPlBgI5J+dZNABOVlrnOWnieHKjsU8w+BXlPbbQUppYElK12yBIKWmWKEmlkBkuFXwAh4QiFNVMgaCmERHfb+NwGP/qCfSYpJAqbnRaydhf0CeDwhuaM4jtepfV3dgkU3jVdLAfBmhvyVUPQpgS6PC/agtoikfr1BWHLa4DVKbEw3NhhOpIOVO0al1JdE5UU7ZFygpoC+A2dT3D2zbNYrAt0sWMEhjT0LZ2EYD91/yfGo+y2Pf8491tlctC51fprt3PrN922/5uNrk+2Y5jG3eP8S5L9O/5tbY0wmQKopVbhAFrXeKZzSIonEhMXyxDnAFtAvlYITFJ6QmbHM0dNoyXkbFcc7FceNnSOiQY4amdGs8QA0GyYL2HdD6JFU/NE7WjRoVcydr17yMqC5LAoIpTjELfdsW65siv2MtfcbVd4NSlnVukSTR/sEdQy+jSN8hzWbCSm2R9rwrGej1ogFIVu4de2Ib6NlY4L6ssc2v1KzldWOjIuSPSLJvAPvedTZMGGvqyIfGs9oPrbehOksFYATmLg341Wh7lKrkCpQqkqsrlbqffb33qpXCLEOKIelnbyUTwkAv0AzUlE5BKg63qWKLfmrCWOdnbfVSXPJVkaIesyCMa+bcsgjRWoeMOkKqV7pVdKbQ2qS5YcOn2R6qAT2nIPH0FGLlHyoPPy1dMXSOobsiFTKIp10hyGEzV6IluNiGoOk4MTE380Y5Cvytl0xnpwXnh79GLFy3nxHYqs/bV9aXmCKETageo1Tf2DtpGhuwVZWaVnTW0u7qZquWw+GpnjIyvrMDzqsa9JSrvlVkV09oNBTueFuIZZn48x5GvL0F7sRdl1ECi2s+rvQ1Urj6euZAYmHgxx5At8nQXw5oKVJB/8tEHJ4bDSLXdQK5cuWLoq2IkhwT0Qtpj3nOJWPuG4lQZDPbTYxgGpNp03uq30JOtHHJb8oGx/Lyq+mUdly2psxkf9UclTBIHj4hlJIjCfkYZ3D8wUXC6yBWNUtow3udyzSLkUWnOh9L20Z5d1a8LKtm4GWLmGO7yVp19PsrJMN2grs3QjtzIkKTbqMjZrJIfum2iXsDw5XVRz5vNIu/2crUK2+5+V3QC+Dm5l5Jz59uUQx9jVYaTuAthdqXF0torJAblbl3Hvs8r4yvhsjI+c2dU1QCePcjZsyBIuj1YB0zHQyhSX2DRB0k+mh/gQajLrRcMhbt92Hv7+nn5EFU768wks6j28l9vjxzCTjOdP8PwPgEjby+nf9BiMbn37Jz3ucolbaPV5t6zWWrew3q1+gUpQt+vtj//QzaHU+Mjrjv8AH7nXxR/wQWZ4ftA6gMXdhRvxmolNv2h7oY4NZwM0NzLQVpBzgX7hteBPCIh1u4gVpY6PuvmmQgZx5Y/vDvTddsSpJyc/yvMACdX24llcxOFEDrnUgeL8RfgiqGT++KPHOViZft6olBHd2ry3zvQD5W2Cb+1xaDV1jAYAulbdbRthIuKTJSiGr8IsnObVcR1Kzewwot3bDWUo8JY//ugX5XcovtXBAerr97fhzyNvcx1PDujggao8D4tRhx4IDMLusFSJWY8/3sRNJOdIawMtjBlGjgDCGhdg5TsAQppukPuIeoBti55EuJfM/QjZuiakIKU73F4LxTfPl2QSdSbJUUAg1IHLfli0+8WBtDw0E80yjeUGtTS94gEuorx1BbMW5jMo+uKgk4+eB0kfZvus6Pwwj7LlnjBgvoIcfz8eHPittheE7RMyLcL9kw6kAcQThRr2qE3nl9ie0FcmEfYb33ecbcGf7i0V3FvpGltsCrTXmJPLn1il/GYO36KdifatLrS1xmocwIVvjGUdH/E33QDnz560yPjnPMVX44T+1+sjF24Je1zfES9NBlmU1CjX7pBZAB8eXgru5Y123OVS0IAKHe4lbcwAF0bDeBYNWHL80NF1OWmVaHW+9O569MxluRNT5rbwDD0Cg8hK12xfRxOb9+/T67oGhuGsBj2pTxq4Qek6xMKZA6twZqOkga3Bhwe/HivONrESiV+6EglZB2ac7cBPNuDET7FyDYJlvo5hmfqlt1GDkSpjo6SDFDhpGyy8N1QKh45xgOL3YX2untRadkYbGbhluA5UnRE0Q1ec8DIPQPlOxYAEeXiHzsgUUziLiRMEN4idmvRb+GiK1bZmeDY0rZWyW9YB7LiTRbs2UsqcdSBc5tmVLVO42qa7Kkyd8gwzCl7Q4VQgs2ivoXVL7IXz5iCNGoNXOzBSkLGIDMQWM6yGdI4eqXMLVGF4f0hY0cBL5Y6VIQ7NTSnKdwhg3LUdsONTuWVviOrVJbWU02NQPrDdrJpniug8vXi6vIYu7h/oxMtrJ4OcCwi5ZdJWkbYEswqFXQReib4u8t5dV/Ql80aumg7CHo/iSQS0xdN6xIyIRm1wJdy8NF2smsl488lNcm8qdRkN2AV04EKKENwQu4yVZzztNZuJt8oenbT4eV6lVpXcewJaYFl55bpmVUJUr9P2lno17gilUhXcHK8hPidL3tbP4kSOPLncoQMrJua2e7xIi8Z333ca/P8E2O1LTIk96DzCFZUYAnZoUWULLAf24G99KCx6E+Z5fDQLNAZo6zA0FhGbrDpvmCRt4gjcJFe2h5gZohkkQdAfHtnHnZikDjGFw6Fwr0MaDo/2x3gmIFXlI1C0JxF+5o+XL1AIjFu2K9JJR0rzBZ7A2n6KAi+U8lEGLJlFQTzAO07TFMXIsMdfIMT5BeHS4Y/sCAcqj5fPBgCjpezuOdkeExPbJ+jQQijjM6M+n55wBXyhtLECFDAqsJPuRW3wM6N6PexUczX1OilXw0/JYd9MkhCkHpIE+YUJZWbKVCig6GeWKMmqsQrYTZMokMSWFiUlgIm3uY4G++bv1sGKfyh0XjQ1ITlkQ5RTdrEMp8GHYmnIuePdu09nnoPoyCfvmXnWYY90KCyMccYJc0BWfFUUWXw4h8XDp8tlYldnliMfb3lgz+HCgt5QOu7QQmvbZ+pcBYoiXwmJRrqD/rJPlH+GhjCosj4+I+uDPosJnSL5Jj6JBnQGh7S2qiryGwWrswP3g2ha0FS6/BRID5vZjB6UvSRH88OVeqVpeIKbVihtS/NXCLgOZuB2CDnKkUDYVRVanhQRMkWCHCcR75T9TnUFBQmV7lZKD+WGxHCSgGwM6Dv/ISsCgnPLo6FM4SPYAC40s1utFm9YKaoN8wIlxxCH/9+AUdPDOi4Sb/Ai62ClWkb5BneHoiBtfRmkqJK21Livt7aAc+747v0i3hDMomkYs3YiEJQbouak1ohPK/V+ZftUl40rATA2bsvauEOa1tblkd/XQ+GWdfn6w2p1iyHuzqqq0WQSpjnZowr/OyUxDOymVEzV6AqcS1GPJMVBZnQelbW+9NZhFov0OypdCTKuao6Xdp+hdAWEDsL4izlk/VJST6z0JSy8uSj0PwBIDk+J5u0+yZGjIKd+xcELlyiz7E0vsT7zrhfAaZMYkY6CN9g75Eec+uT0+ac4L3A4CuhtHjAaiIeRHw4GgS8v21KrZ/ZCTwFQVYc+c08M5GCkkkVk42cJWiNAa93glTCL5AiXCA7silepWA8zVFlPf24CjTHy3JVr6jHxXTyA2eV4+uGANcvDYuYizuvwiEkj3ruDxrGM4ibhXAC1QTx3xH0bzTmBlNbhkdifQ7WOUDvgDVigAfK5qC1vCykm1aWDUuNJc7SwEDxdDwnRwIcoLhh/equCFxr87MSglWffvn7+J+ESXNHbhxGoy4HfRZ+qvI/ba6hCtXEfNipGyWDL89MEYK7J3VrZaQEQ5wEC7CRj3sTK0zpzj4qhmKcLL+blITCBlTKMIfxL2gtFDIvsY44YbWpGLed9MFGLSFAEFps0pIEmoh02FBQLs9ilh9SGsrSv4pPXajS1VjecYnSaFw7ipKYMRQ9FNUrlA7OxZ3jJbRp1sbMufhAMC7wC5AzTFKytJ2DQDQKE2aqkWt1B7/EXaMqREoY9PzSK014EsY6eOjmslqwDjHi3lNTQLyjFIZjEPfkAQSzellnyXG97MKfFFz2V1DNEAKlYugSQj1YBP2jiMpoQcSvTG5JwzxFGpMN3Anb4boCRMzqWeRIVcSBCHGjrd0qwCMagW1rEsdlssEp5nKQAWtl81SWdJQ1uQ80GqljQqAVopDtodR+0DG2ZxeS0CblSSkJBt0S0RbUkVksIsClQQqsmfBid4pRu9IQ0tJIQX+W8K1nSssclSiKURcqzSsigpVbTBaIJ+iuIh5FaunMYAnzk3V13VaA3myqld73fO0vza01GcWHjCMSdSBmvZRmVVX/JSKypWUVRVQNL8n5tPQvZd+ZqBtV5fdNZiIxZAfzWA10HVyNdWapY2jctffoEldrcmQuglHVrtp6Q4oFwVGRLNN0MLaHRxLMUK7cqQFMe52jeqE+o9YBmFV/X1Zo3jkblvNqn+9rJ+OBCFY0RaHuVnaHqlD/pINQDlrjcziWmHx83i65fBiXkuxOkjb0OtsyLL++0WX7imuN0gR7z8MOe02s//ijnqyb37HanMYisVll4t7FweIKFSTGnzjMLntg6OgDil4S0GUNq/4laMegyUos2+2gM5DQ6cajUOjjtCpo49rdtGJ8CsOvuyGJkrzDdqjXFcLtU0PI627FlsknVO8EgCYE56yrT0npdB7CQjlezRQ9NezEB6wwBfMwoqNf/6Ymzg88+ofMVLYpPPJXRswaVa6lzg+mOplVPPu7krGu9/4TKBTWMizi9gBbV1BOPmB3QtF3v0P98yTX55RbzzyVNKEiTU5bUyhD86pArYf5dXICNg/30W9qWEKl6AERez+/cLPdNsBeTASiL6M5tb+6TcHlGsQzUHocQWeQVtcDlmz92xZm7nO32ub8ugc7WKoLkYjlRPnimCwusgcBspkBi2tyEYMVRt6uKdGKocFNLaBAaA+n8c6Y4aP3g6lIrd1s/NZJLq6PrreiH5KghDBIiKR1v2RaLcPNNWK7lwWI5yvi9rh5qVbRPR19ckNL4mRD6Fk9x0LdyPS35jx3/YKB1qPYCyUVzKijbc5dJ8XqyRMRdhE55e0PDc63Jf5Ld7Ly2tB0GQ+ZFozMDhLev7SVvbK7fEi3hMf0m2DkaZyo3vPRY88+j6v0ongRh0ZWVhZ+b5ogHZW95ZTY3HeKtykLx6WAIww8T8D4jB/LLhHEfdzY1EFganQDL6lADp+0DAWDdAgA5FhbcBqSLWx5SwDAvoFY41Pb+BVtw8sbBHZFZco5aIESSqXUrplLFRJJRzAxvAsxLbExeilfmYil/acQCG1/JbN5tz8ZRZrWE76TDdbJhErTX3IzPPpZ1aOAlJP0kntwtzelhDisUqKWgpbowKfQ92YuMfXX4jeJOXmm9eI+WVh5ZS2kHO+hNQABHI3ERmH6gX7zsmKrETwOKIkRII1c/cNhe2+f7Fuwq75d3dNPhSbnia++t6aCwzG3PN55jk82qiVApLZ9Vkpu4am5USsqHjUTJdPOYV2Kdt0sPlrZGDsHjbR1zxTiKwQVJjzdTJUeV5L8OXMhG6u0wTTU/4n275IHpD3CibxDiDw5VtYNdR+7WWtVLQge2rTxZkbJGI779DT9wRmwey+ve+5WeaQjt7NaiI7VBAGziH8htQJgdljnMhrDxxiTYxHLR3jHciywLQA/SduBU+MuLdrBcYZVKxC1dPSjbeseCxhJnqtlK7K8DlzUL+GzWo7pp6yA1RGvcNz0NMdh2PJ43GEiyzNWMpAul04VWVKnYs9qoyS4yj5VBIpovrSJ/XVg+XLMzmiYFrQvpsgBZzi+0Vw/ND4/oyJzrjMM07MdFiGSorSGP2S9v7mlBjEA1hfQAPbiaKSZaEHQ50XXapcsOHiToQxUM5Y18PuPHS3M40rKb8FPSUnnK0C26shD/tksdhkd0Uaksp5HX1hunWpuu4bDLA/l1JO2xqBTH24Gox0icbkGLyr0insbFBWffYihRKNIGjSRahfHLvSVqs6Wuq1TMKrU7K0KzEYqPvDuETn013prV6+x6F1QRu7JS/wRaP/I20HiEr10kpXZZqFJZBAkO+Xm+cJSWgHAQBCT8JEP0EqCgDsOqXFMQHLYlOU34pLeZO7cEk4pUT1xq4CHB6H7iSifd1vFE3BtIFVdEMeAdfsGiIecWR4HiRX+DNQO3q+HQ6ayuLqVKN3WpP5i7IZr9+c5HYeJvTQ/bPnOWvwXkkLsxZLGz/Spj1+AE30832unmgSyEZ5YZH8SigK4GEsgEmxybTppOS1XDU3PGDXSLvzKeNAx5NBmFE+FkYPhGVsrLsOVUVhGfxHNru962JikvpZUI2HVWs3tklRawsbgdjRFPE/dYV7CDF84VCas0NYIYZlE+n6DouHnTHSquhCSGAJJv3y5bOlxi0ACt2H4sgjRwjhwwEUCMQsdgi7d3vD0KRkHxjp6MwuwJ7i5gJT1cGJc2+s7RjZ5hAHiQlEGO8RYGuYqooryiZIaSKj66Q4m9gmez5/FsTqg/WNdSv03Iu/MB3jJUhbT8r4mim/c4G0vLzEG4zE1/MYEAmNJckSJicNK/7Yg0WXsEkJqqY0uV+nrzU8K0CQT3pQJEdrHCDWToY6d2eQTLgfvbb95hxtnA+5s5opBBHQEbkQc3aHXScLCHG4zBZtu7uX6zdbb1m3cC2cZif9tu4AGh7mXRUZyD9OlHQX3oMtrZku5ZFDKHlBa6Rwd61Jb/0m/7G/D3md9e8x/Ax79Dwu9kwiZ8fA8Jd+HvU0y4Dx97kPAQ/j721862be2Sn6Q4MNXFf9WWutcOTtrx4ASlCu6rK5Mk0OiyIOeRkjb7QtMUM3nR8gyv6/KH+IKBfJOmUfYk5JBMvFEtrwrd/OomLrAiYffm9zdbxhY/7eJDHVlFk/Ub6rLt4AQgCW2J8+9wJqvOkH97A02x/jwPqidCJGPLTD5KRWKMo+UAgyBywB2kiAgUBBlkjz4O++MclLPIx0AoCmnEGhMQLzE/Skzu2I1ZfUX71mmTaacRqr5zSZFHDIhwRYGruZCjezHRGwbowOSzBxOw8quXe699zaYwkGhcFs1V8ezCQxEHyrzxM4iURoytE81ui98b1u9N6/fdA3nUQdv6AEuy0SPvXsvW5HzjFQoZZe/d6qTTXL+IcO01vJexRZ3AWwnK5UtcDrsBi8b6uot46gmLlrUBnK3mI5aMg6xDsanccaka/3OeEVQjW11m9KWjpmWqkTaWTXuDyZFwR6gJNIlnOMgjK3or1Jnph8XKUhSLOk5DqqTxgNYUhYxqbKxSA3rDVZxE8aqnK9XNCvXmyEF9b4tBc2eLwYXLBYBo0w6W6WTu/7//9V9qcbokTTddp1Iyxy3MSkFwwZWpf1+pQ2Ltq3YL20BRfcCTxoWv7m5aI8xqzswU6orjHW+ICJpy9LlLXf3z31AIQyNbC08nhYFCff0ToS4f/ahr27dyykhoFBvGZ5Qqk0C9btErX7egeVDZ7IlFQFwS0vWYli9ztGru8V1wtRLUT0OU6qZl9UYoLdLCurnoZp0e3kwveybvo9acAXPftytlqr5fjN83tAP7nLdjtRseoXOnlq9huPedDu0a/MxEdVvXCDksN63FPQ9ZCfevxHbzxVvF1qlmJThL2D5suYSqutRC6vfRLAE8puGsp/bl1429AvuWq77bnRelWWkDkjl5QTEb2M4VLgIaeBWjgf0QqesAQ4sZpnRDhrStoHKUikbAIiSFqDElwUlac3X7b1peptOKbtYV3ZDjhMiKuGqO+wocrgtUyRLhGzsU3Ffv6sVVKUYG1VM60J07FZqrGMVFuFDLI3zj0oh/uZUX7OfCEei8257s7m3P93yKjSrj0HGm/FkWAGEFfxyE2V5z3C/1F8u8mKfKWTukPu27Q/657iTRiV21jhbEr1XTcH27VphAV7NopFZqOBul+4K+Oi5p190kk8OeLCbhIOw3MQ6oCXVMo2rXMI6qWjKNUY8j7jVUFLFFypocFtFSEZAwnCFKzaJCRjp0uC5CrnIxYt5HrQQIi66UB+U6i2ArkQ1plpdzZg7k5QHjp3GM6szMN8opWh5jufqMcRWp1yoimtH1PJ7O+c6ojWQZGFLHbhAt4n4kVowqwWRG8idcDyIMpiC3eAwAyFarAMAQHCWAM1tyy9DDdqCApgEjv1V9tFxBBdSxaJpFKflpZNEp0gKrP10AvggrmkUYTgFVK6CxI+oDr6Fg4vRY4Hp4T1R5xjkEDFLJsWSxLtCkIdTs0oMU9LdKBM7KOa3f3K8gUq9quFWhuaYLnbWqfMnX3vDqSwP9Kgfalfss+oFt04mvhkRFNl8FmdpbOSy78e5ADh/oZkg/4Dv3DSw+LxLxjHGIZwqFeGZiwB7JjfxrtGY5MmuQ2K34knDYVVmDYugVK8JyzYy7Bktq0b3MgyviUV2lEgxeq5ZUcKXF6NMiimqjC0uhTq6IojlTLOWS/EocWBNWV0bbDBAm9t2EE4vUZjfW5ZJB4VBFXFcQN9GibsydSNmtV6J/qUN7NV5snB3Hq47YO62avgpK60rsERiFnFdX/NZaQ4MuQ5doVmNi1Ywdnxe0XZaeFpzIHIyVrLNt0UXH84hNdBQbN00tkIc5mX8XhAJwGYcu65RtGaety3ygzuR68rQLT+1uPVi/9cBp/mnWHweN193ZsUBxONEsDmQBjmW/LyMW49PyBzLSvRnGuMtpRsheVRuMD1FMVa4EV77N6XZUZZFshlOWgPnJLlr2ZZuuBkRWpQUzXY/6KxvQgJh9r6DfrWtVgiqbNSHZHe7WYCnhSEqYUEz6dOt7RGNhjWM5PN1auiqSYwRks74WlrqrpVgVVcRms7IV8LprpVpAWMwaALTw3V0txcmIKNatcVRBwbtlgrsuz2Gruj6xu0aaE4geH9kewErk5G7gnmdqvrcUbYsRyjgz8LQ5PjLxjuemsMqoCdzt3eHs2jjXpbdl4461kDMNe/htdKtWp5TlrWz0G5Racy6OGcXRLt0DIvys8srXnh0q2EFbFkDkKleHKQ6GdTxAIWbKS7YS1g6/zOCLyB5mJcuDA2HXAWECOqFgz257/okLgboKmvM67/bc5vLattMF1bbVERfS+jTKEhU8cJUlcHvNqFL++FJZhWVaa2v9EguiY9YB45bQ6tZLx0M22s64/gSew8Ctd7paOX7qA/FMK6+teTyo7AvY3k4iMuqFu/Ir2KrbZl+1J/0qLiZGUe2BlbM13vzaXnvU5VeDdx91H7/8+n/AH4wqsvv/AZ//JyxG/gAA");
-constexpr auto embedded_index_html_etag = ETagCalc(embedded_index_html);
+///Complete response of embedded asset, prepared at compile time
+/**
+ * Header and body are stored in one buffer, so the response is sent
+ * without any formatting. The header is valid for persistent HTTP/1.1
+ * connection. The object also contains complete 304 response
+ *
+ * @tparam N capacity of the body
+ */
+template<std::size_t N>
+class StaticResponse {
+public:
+    static constexpr std::size_t header_capacity = 256;
+
+    template<std::size_t M>
+    constexpr StaticResponse(const binary_data<M> &body, std::string_view content_type, std::string_view cache_control)
+        :_etag(body) {
+        std::string_view etag = _etag;
+        char len[20] = {};
+        std::size_t len_pos = sizeof(len);
+        std::size_t sz = body.size();
+        do {
+            len[--len_pos] = static_cast<char>('0' + sz % 10);
+            sz /= 10;
+        } while (sz);
+        append(_data, _hdr_len, "HTTP/1.1 200 OK\r\nContent-Type: ");
+        append(_data, _hdr_len, content_type);
+        append(_data, _hdr_len, "\r\nContent-Length: ");
+        append(_data, _hdr_len, std::string_view(len + len_pos, sizeof(len) - len_pos));
+        append(_data, _hdr_len, "\r\nContent-Encoding: gzip\r\nETag: ");
+        append(_data, _hdr_len, etag);
+        append(_data, _hdr_len, "\r\nCache-Control: ");
+        append(_data, _hdr_len, cache_control);
+        append(_data, _hdr_len, "\r\n\r\n");
+        for (auto c: body) _data[_hdr_len + _body_len++] = static_cast<char>(c);
+
+        append(_nm, _nm_len, "HTTP/1.1 304 Not Modified\r\nETag: ");
+        append(_nm, _nm_len, etag);
+        append(_nm, _nm_len, "\r\nCache-Control: ");
+        append(_nm, _nm_len, cache_control);
+        append(_nm, _nm_len, "\r\n\r\n");
+    }
+
+    ///complete response (header and body)
+    constexpr std::string_view response() const {return {_data, _hdr_len + _body_len};}
+    ///content (body)
+    constexpr std::string_view body() const {return {_data + _hdr_len, _body_len};}
+    ///complete 304 response
+    constexpr std::string_view not_modified() const {return {_nm, _nm_len};}
+    constexpr std::string_view etag() const {return _etag;}
+
+protected:
+    ETagCalc _etag;
+    char _data[header_capacity + N] = {};
+    char _nm[header_capacity] = {};
+    std::size_t _hdr_len = 0;
+    std::size_t _body_len = 0;
+    std::size_t _nm_len = 0;
+
+    static constexpr void append(char *buff, std::size_t &pos, std::string_view txt) {
+        for (char c: txt) buff[pos++] = c;
+    }
+};
+
+template<std::size_t M>
+StaticResponse(const binary_data<M> &, std::string_view, std::string_view) -> StaticResponse<binary_data<M>::buff_size>;
+
+///Web asset embedded to the firmware
+struct EmbeddedAsset {
+    ///request path
+    std::string_view path;
+    std::string_view content_type;
+    ///gzip compressed content
+    std::string_view content;
+    std::string_view etag;
+    ///Cache-Control of prebuilt response
+    std::string_view cache_control;
+    ///prebuilt response for persistent HTTP/1.1 connection
+    std::string_view response;
+    ///prebuilt 304 response
+    std::string_view not_modified;
+};
+
+constexpr auto embedded_index_html = StaticResponse(binary_data("H4sIAAAAAAACA+08y27juJb7/gq2BwN0oyq2JEt+9E1ykWflUXlUEqc72Ri0RFuKJVElUXLsL7iL6Q+46FWWtSjcxewGqN648l9zSEm2HMuO8qi+BcwEqDJNked9Dg8PKa/+uH2ydXF1uoNM5tjrq3sXR+/h/52N7fXVo52LDaSb2A8IWyu1LnZXGiVUWV9lFrPJ+iFlxF6txF9+WLUtt48sY63UxZGlU7eEfGKvlQKT+kwPGYr72NAjayXLwT1S8dxeCZk+6a6VDMzwL5Pev3VwQGrqW+ty8+RsIB2+69EN+Ds+b5k7rR60tvjXjd7Wxgf42L7W6wcV0eMcvD+ToO/w4/H+aB863lXPW2eblzs3e57RYh352Nzd6A5+0wzr11F944Ozed06Hkruh63dQ3132xoe9K1tunOyre5u9i5G749O5K0BHm3S7sb7HeX94GbLMa0tc0ut2du197bE6sRWVF0nzeboRokqldOh/e7i/APZqL05OQiHH1p0a1/+sC292e5vKdKlc24P91papWKw3ermYGdH2yRq/TegovV+56MXdkKTXvh7bxxnYzR0h1utq+r7Pe+kZXZZy1Z39i8Pfru9uHR1abN5e9bbpurZyUZwsa8Pu+TqcPRxJzJZZ2Pzneu8a12qrZrhyLV+zwze1UdKyz5r3ZrH245Gr7c7hxV773ir7h8Yzb3h/v417e++83bdi5uIXjWrlebJwYlierdXSuvSx/bW+86ZFJztXAz0ZnRhnf0a7QwqOtOs/vHeQUUj+Myv7vY3gnp0O2ThhtE9eGM4mrPdaqgd+agfDN41NKwcsY/dD/t1w7zZ2Tj7TY3ebKs9MyTh7W+bvav6x1rrw0m3QxwcjhrazrBr3gCiw5bdGx4NunSrU60q/ra7FWxZW1dKk5F983C0HRrRRbPmXe9GV1tnQ3x00pQPDi6N/VBpHl+1mmzjFBsfTgf2larVlQ/e0YmlvDF/3dms7Zxf+ZVzw+reevqpaulD1tgm5+zorGLVorPOxy693vWu9lzTr5rXrtd9s3FwRB2rtXMunV4JW9uxdy/65+EHZ2urBObvEIaRix2w7sgiAw+svoTA5BlxwXcGlsHMNYOAZ5AV8eUtslyLWdheCXRskzWZe1biRbHjsKFNApMQlnoNI7esogdB6jRiRBk6/h6tSVWj263hagylEvvv5sn21fqqYUVIt3EQrJVMgg3il4SbuoQFDLMwKMVDeF9MIDgjgc4K9CZOPvucWc7kefz/D5MRADIqzaJri771HxD8ZYnphIzxkMCneT7xXBqytk9GllOagM1AT2ZF2KcRdq14XmA5od1mxPFAKJZhEBewis/S+unJ9cnZL+icD+FTxneIEc+mDL9FHg1HBL4G7Mcff8zBYuDA7FDsGzl0e35E+oFHPSsgTvJcjAk87K5fjr8ELPTc8ecU22pFPJiOy8ASQ5xUJdFQTLXaycwM8IcTbdwhNmKKVFpXpISBR8aqMFYtOLYGY2sFxzZgbKPgWFmCwfDfI6MdfAtO0EUuIYY9sbWFw/XQLzo0pgMmxEazvrJSXik0BTve4imZr9lmcaN5vsn8v8XEFmO5/6cs5np8F9AOmEx/ma2MMB9k9WNbmXxbTHnXsu0SEgsLD99Wz2S/IOlRGXVoX0a42LBOkWFKMWhKAWhCGVwHT1cBjWxsYJ2gWV0IYUJaS2AVeqiXk8ge3xnjO+7MJr3/J4FGroY4jAR+uwuWCA69fkoNHOGvv2dpEGnzLHcPyeRDUhB5wlggH06BQxnlNgoBd34BXSyvfC4wzLmEdMcCETDqP4cL7BZh4TFKvJB73df/Ir6HDZs+g5AYwpMoWWBDA6trWW6X5tkQfzZnQaf3/7Q8esMNBy3z7XhynihmDT9f8UFgGXlOMTPIh1HP85wcZnmyGbQHlpvHMTFtYgyXsZujuNUg6qE4sy7BCuFxExYha/KVZ+Kb9HatJCEJyZKiiv9KMzBRRPzAomD3clkuzVnGrWO7PJVlzPulUhkMBuVBtUz9XkWRJKkCFORZk4eZOdfL/0AOR816o6zVG0qjhpqSVFZrcl1W7RVZapRFs5pp6lWpLFfVhlZfqTZhlsRnqY2yUlehtdJolOtNTVWamT5ZVcpyowmzsVLVyvVqkz/PNLkspBXeoSnio1qvwmj02GgxTEPFZogOVa0B5ShGpWtV4LUejwA1lGtNRavLK3IDOBQTJ5RrKxN27KksEG9qqoqrMoCDDZ2Mpq0YqaqWG9Va/B2e1VU1/YifgzDVGhcSDGyCBrT66EiTpXJT4m1UU5vlmsaljeU60CJpAu20KcwIOuRyAwbJ6sq0ifKb8QygRq2W69ChNGJ4sf4zTTFwJRf0CDlKXSorNUXYATcfDqimw4x6WdMStScDEo5X4KMRyy3u2FPhs9rk0sHzsgEaV2qgoEbDrALQJuhrAjsWZgIM8MTWhR4iADJXalKzrAo6UE2RylJVMRVZLjdrDY6z0RT2O22l0gHMtSpHtce5ju1IX9Ea5WqtAYTJUq0sacI1VCBKFXLIdE6bl0qjWpaEHHQpIxOtLIOtN8pSQ1jk5AH3KknjCnivqOCLCgeDwFJlibOGtXpZjXmctmKiQZ9CO9oK8Kk2TI1LrclVrAPdqirHQ6ekoQnp2c4M6dVaDebxdp5+ViYyQtKlXAWnENMw+IyqCKjTVuyz8F2pc3XzVlXlOturVgGdzPkFSfHQwjFjTSrXGg2UfMTo4EuzASgU3i3XQTNKs1wVmo808FlN4k2dO3q5WuWejGSQZSyiCcJJS5v2jY4UMHs14V8GOcrcGCACKtyyFSRrSlnoSTaTrmhl2gdmVodQyJUMobBeK8s1nOvrU4ntcd3W1PxhU+MzZTDVqgLtJiABIaggrBq3k8UItBooWnkUQTxsFkHqp2BtisRZKwalasI/oItH0kfoqo5KuasQz/LXSv+xK/5ExWg2xYFVbdli/7Dm42A3xDavdfnUhgUcso65XDKe762f8sfID7/+DvmNSRGd5surFW8+kWADCpkKCVBcLQpK+dlBtpYE5DyaUS9Il5dkU3MYHsl281LZx/OmlN1UYMnmM0mqRFI6hWZBmsqS2qBuEr3fobdJOQ1GtrHOrIi0u7BRiTiv03y4ImamhAgc86QEtiVElI/Px26PlBBsuyFvgk98K5IuvncknujKCKodeCDv0jznM/b0w0wFjvZdigICPKRSdzEvJLane9p8G8uyEE/nVVnUsbEOO1+eXRuYIQ/bVkQXaEE3hx2MApGFQwK8Jb5607z8xwXzgrDTTnCi0AWyyAJzzRBWQtTVbUvvr5XiKSmEso5t+ydmWsHPf+OG3Pfp19/B2D6hiNqd4UPTirUYJ9QbfRaO72y+g+AiQz9ZPZf64Q36+jsOkIs92/36Bzz9OUm4F1hSXM3GncClA27LGUOZQ3kI8uzwyixDP40mtQl0w/fO47uR4Y6/FMLW53DykM2pR4wMiG1i2OTE6PlWPe7Bb1GGis7QBvBoBIEAfLUfTmla4vDfBkvi0fy8ayV0Ldiq9GEHEctwD3bjLg3AOIfMJnnSckOnwyt/EbZD+Jp1N+GJUuKJiqalAjUToG0B9IFk5/l1iWdj5mKTGi5l2ISAcxx3je9Q0lmQnUPsYd1iOCOjsABTcgGm+gloHgyeyhLMfYSnh+ytTzfmBgZ1Ig88kcRquv/Xc/QE6UwaM7XZJTrmr5iuHMwHHZPAAUfvjL8wLmmP+i7ECLDBz4G9PMBFxO4DgCOqi2a+MOZmeT4Go+bzwmD8+f4OQSzRKY8qAWYLZsaLZ5waZLwt7l4/5eEIANj0/k/iAs1J/9zAk8OFz6ZRVLdpQHidwaCDTAwtrZ/DKv0Q+oMVqNACFJfawwLrT1KcRznr0JHlWk4So6O56n+uENPToVxw+HYKLucE6vtcrrJxw0nDxvb4k93HiPnENZbGi9ilYHPyIE7IUqH1g/mu0Y5diHsAtHIdYMnkIv6zZHpRR5oLRHu/Imz4JMCxfp2vf/gTQSXGfQ2dINaJsc9GkmXxm+qpIi5mzqKWxbfaXIBTU2U0+SNrBIOqBePZVBnLrXdRDCsy68UxbC7qzMaGNu3PhJ5M4EoD1kzUf3Lwek7cMgft6dnhc3LnyyEofWpzC+RkWwEDeMt2OXmizJPRs+WSd3FgoVxEIf1ZAjkWAESlPrM7+M43B6c0vP9z/Jmh7b2t0yIpuWHq3mPp/4aIR3nQ+KWVFJJLWNnyRGSwidsTdXstjQ/QegTJEQ5gYRChb1gEFfxzYMqz8V2Ov+gmHfHkCjJ5txB7PczIAA+fjXP7+DwJ7kWwGW7wJExzgRAbgMv3Kezzj7/+0WcEGEWjmAJInEU6Aenu/T/HdwbP3h9Nkn8FZ0Ln5/vbi8nP0KtMVge5nvLF3bEcH0/NrhdzaEwiMtyX4PFAFgPqz+Hy4hV0iNxcF4c4AmsItCPeTxFIi2GfhbD5A1F9HpFF5azcRSQNnKQLgfN0fAfb6KQglka1xSHyNZeRYtkv9XhR5FnxMv9wfEky4txMt5PgjSZMifhmdllOIvIPbbJnLGszmWKyKYbEpZRrX1nswRT52VA3bbE1TwqKZLJGxRAdgoPQJ2mlawTWA+aSTcAeoTgtotU0rapN06mczSHz8bDclfs9tiSjQrDcpOp7fJnhWzDY18LOoU/d/FQ9I5j+YKoSMb4ga0qGr4SXbmjbZY8OiN8WueR8vVqgtSkYMZ+2KHpmyfP0lLxMdbYojbM1zAyRXex62SpYjs/MiXyhuM/B8PleN0/mc3b4iuK2IRwslPYySf8FUua0vaqQM/XuxcKlKRvn3vizi/UF++dH+KrObHdm+WLpXZJFdfbvaBfuBPNKRR7xLYh66PTXo0cFocwU6x76EWhXX+zCUzJSKrJRCa2IBbifOS4q7AeL4mkmqMY+HhLbcnsvIdGnfGEbf46+FY2d0OcXpZ9C41y0+cayFJ78dFHmkvkt5cnpXCzO9G/RyedMHt3Flj1NoT8lhaAhugloiPgQXuEcYV4+/gR5dYfGTxzLgeSRjgJs5oDOTRZj0mm/9Kob5kIZoLjB9bTMr5S93DWNwgx3bJIOJ7f6bFmY8fcGHpxJMz/nmhUz11tgwLbICOFL7ohTUaxf/HybdvCS2f79v5zy/HPo8bMHuw9oXmUdagwL8rBF7D6k/F+4tUd0tIgYI/aZ2ADEfqOt09CFnY7oTzbvogfUyoxHYSQHxOJ1jiyM9P2O4iBw1CsEYVZqS4WySUaTbdViiaQmVJDc0Hsys8swPIGdjZBRBzPwTQgAmT1iEVUPLKabbYfCMv9ChQMRL1M3B/D6ys6kQqV1b2YrUkA+fFlsx1nty8STAfQSIWXAfGNRBfPbiAcjHqMVlsBXEd0UzkskN4XyjQU3/h9mh86TpaVTar9QUBwE5EUvElMK4xtE3T0cYd+64Xuf0aTyVXBBot4LZSNAvEQwAsC3Dk88n+H1UAYy6lNxUaOAeGhEfEgRXrpkT8C8REwTIH+lqCaFs2IxXdzPa79EakVSg9dZ3GeYTg54MwezBdjlr+C0fcgg23wjweuI3zXD2dJKAe7EbcTXSFgFoJdYfnwv8vXD5kwNrIh58zuRryAQDudFqQrM/wbimNy6fYKrv4o4YlAvkkgM4hsI5YSRKD7ymL0QVyQ8+HjY5ucu33lYOPcoAxb5BQt+vRYXYk6nbhA6xGj3ISuiDNsz7IkjmBfxtgDVQw33exXjhezze8JDtLNzenZyVIh1QmDH77TFAWzw3Wr1JNGqMN2YO/STg2/LKHDwKD7NCxg/Ie8Pfy7m8kCYCWzjgARt8erpa7M+h2zgW4y0sePNmtd/LpbND9nqTlzNSUqBonqVfnvS4e7l0BW/RcEeHu0WKNxd44jXDdizSnc27Vnu8w5tzz1xIo0ZAu+ksyfc04qet37x4Ck/I3f49SoUTCAEovRhjD/zc5YbwmukfRrGafRbhMF7bix+j5oih97/6Y4/TXQQvyeCWRmd+jSFGNse+BBgcRD1rPs71B//t8GvYRtW4NnYykE4LE+gXgDFnFd3fPcWwU46JhigGPSGX5ExKKeN2O7wLaR0bgwc+BrRjo/5xRCGHY6MUSdFmNhIevaf6KrVH9+NQAACQJQA/frHg8uoi19BAKY79viTw5EHySUEZ0b+6Uv7/O7DCkTfnvsL0iEt4a9wXA49+/4fCdWiXMDpWO3466vgwra9/tM+6hvD+z9j+m4saMWXP9Ipb8VN/vgeCIqvTn95C+Lph8bsCfXMLIAE48r84r9AMxVL4kILYw/48CNXOuRcz/3ep03D7iSM5Gue/295VgC2ifkdb3FcEA3jNzcwiu7viG5Cwxt/FmOWXndMbsAPS+uHwjsIf1VhhPnZD1gTRO5I2OIUQmKVE9ef2mmxgwKTDnRqkGe+opO9AZONMJNrMIYJwSCwMhGJzFyXmZjZdM61H97fwYxs4IiFOBvRloBo9TH4RSISHk+EE83PKGTb+cb07N4ldvVXLTGQJUS+0aaGN/mFpmdpn4PJWV5OPB9HRogCi59dkhsCUXqUKDWCL31xdS2j3r8XvoCVd5L2knOyiSRMGEH+CkE8XJkRTV3k3y2EKM14vr0QJqj4S2/MCpjVH/7b2HcI/3mYNn/wPM6P+AUyoUs/uXtmZWtoSy7NBaX51wDFi3+Z6fExevaVgeRgWbcJTn5ayicBYcm9tvR92ZwENu8sHnIhHoT4L8YlrVQqGWjpnjqmYvlVvOlNPH6cO75jRLxAPHlpaPnVgCxqy7ZDbwFa03/WVcBlqAtJIrk0uPCKUO7GgkMJA5IAMuILXZPb3a99NWA10H3LyyY6lRvgPu4tocDXgRpm2UH5hv8cYU3lPz2ABVPxmEIQBqQTUL1PGJAKuWsMqyrLDaOr4CfC6lgu9of89WcHs4QsqSk3SbVafSIonTqgWcvtxVDquow7nY76ZCgGiQF0a1iSNP2pZDjYchPxYqmqNZQZCirxrz1WxA+4/i9U0LNo1lUAAA=="), "text/html;charset=utf-8", "no-cache");
+constexpr auto embedded_style_css = StaticResponse(binary_data("H4sIAAAAAAACA8VaS2/jyBG+61cQMgbIDCyOSEm2HlgjkwnmEGAf2AcC7O5g0BJbFtd8gaQkywMD+QHJNUD2NrkvkEOuu4d494/sL0n1k93sIu0AQaKBxzJZXV1VXV31VXUPdnWaeO8Ha7K5uS7zfRaNNnmSl0vvLNyGJCSrgfz7uItruhps86webUkaJ6elV5GsGlW0jLerweB+MBj4B1LmB5LFwLKmt/WIJPF1tvQ2NKtpuRoUJIri7HrpBTRdIZOeaJLkRz1nSSM545HG17t66a3zRD2q4jsKjPyQsWKTn6Uk25NkAy/LPClIRplmRV7FdZyDEFUdb25OMG1eRhS4B8WtV+VJHLFHdZ2nS2+MCXU25h/C6W7ZvFwFwWYEj1aDlJTXMUxB9nW+GhzjqN4tvcX4cGSvbkfywWw8LoAYM8w9Lr5fH0H8iFagSBRXRULA6tuEApfv9qDP9jRi9MAE1CvIho4IF3014PxHsGRpxTQvab3ZrQbXpJC2VxIHwnq9k/vrPZgnY0Ls5DrMYJgHn8eGelee9wLGSQsE4/Gz1VPG+BWsCy29OCv2tTsejHE4K6sqXi7JFgwIFNoOw2idDjmRf4y3cTN4EjLrKw0mfC2UL4TKF7y6BKcuSAm81OtRnRcmyWZfstevmXtompJE8b5SfBuvK2lC6vhAu51HSbpcruk2Lynbjh2kUpNwamoShv8bTcgaBu1ZEGhsDYZO6LZechE480nBVZIaqdV5RKHgwlQomP7/FPr1T39XOl1oneZd2zaJMzpSYi8Y1YGWEGZIIinTOIoSKtZ4szutCdjCiF7e2J+zDSgjjQh45kQlY71q9n6WZyY3/y5fl+SOZsQMEOsk39wIKrFzVSx8LISwxyPKwgcPFLNChzZhZxksLK4+s9V71KrcinyQDBUtga488RdIlsIUKkrKeK7fWdGei6DTyNhX1OAXmclQkwBNaAa8sXrAzJPfZLlf0Q2T3MwVjQ5OsvCuS3KywvpkzNhxZSF/8BVjX+ycIPzIEh5U8YLDUf1GUs86IWwh+ebZkSg/8jXRP+DOKjktApEDB/4dqfJ1Ft/AwpB1KwO2l2bsXzKJhMgs+TWrbBmdG5m7pRIDrMj83ZMS3jvzuoF5+GzIbd4QbuOkA3uQxXw2W6z6RDfFNtK3PcM6vwm8fhNYo+VWHqvANLbjzGUJS9UdiwTHmSbCpPHX3CQ2xOLMIPSDEPwrZAz6mxFEtXP4ee5yCbt0Qk3yiFLzfqUky7BPq/DpWplKQRJv+Bg5nnmbCqpz4aKWhUMTuFlCOi+UGYw3WGoGYX57Q0/bkqSAP0DaU15AUM3iFOQaP/Pe5wCu4vokEcj9YLpAHs4sSv5osXAeMWJ3LNu8pj18JoDeIkwSIoS2hAsqQEjbOOPQ/N5lgMGjrx8+MIqHH268vKaHX/5Gs4cfh02OkdkDiYXcXZpgp6KvET6cFCmi7CEhEYBTNwO9fOGhQNV78XIAqbxi/lTksUi2PCdxoMHzVBSXInDDXCBgmq1sDwLeGlCwgM94wjMZfiVw4N7F3qjHymECnVkY1EzzGmyVFhD1H9l5wl05c3wbAuepmY+skkG+cyMiBwYtOBM0GwMmm+gExWnv23Ib6LLxhW+DN5MwGGoAouovN+Va63jlAXOWmdk6gKCQEAJVcmjmCiOhUrshfzqdajHO5vN550ZtieHzzI0xvLzcTsa4anY5yZgW5YHeVEVexBVNu6pXRCDHS11mV6w0y849U3AOV1zIZtfHDqsl2bBZmXhYbAWMcg4/z7GRuxyQaRMOMBdGbDjnn1loZEsB8jmSVj4v0LpwdPFG53w3rphghqGIgKEYhvj5bDMhe0Sq3TonZeSGjAaZPlIBc+c8loyc/d9mrHzYihl4ae7XtEjyVBYySNnxX8xPAtCt8GQo/mpvKP6wa7No0V042IJCFqJChvrg6u9YMOFWkGKXXVZz8aOqXcVfKvzJ+NfSSWaWR8KE2tL3rqwkLbisSNQbQo7JIgh+vQMNJYOnKCkLOankBaIiMlkdjs15DJwtJmLrooOCdK7An8gqzOE2NbldPIGXLp9cXheMl0j4IgEYrLCdocbN+2SQ1awSQufMTikAHPUaCGeImSijFArxZr8v7E3TW14IM1jJ3M7ean+K9h6Lx5JtUHk6Urc3FeRkKZXV+GmXmzKbmwPj7CkDr0tKs/akneOM0NROSla3x3T5omngzFhfzmwVjELZB3LnVjnoaZZWgdCKg9bidfSl3OAhm0Mb0RySS4jGHz4Bb0Lk0Ym1J1TzYDVgeXQLYWd0u9zFUaRMrBsPDiDogEVPBRhG50zy0F1DtIuqBekKnpiq/cx8DTsQnovtdhte4GwljW4SDPwY+G8JUpcMvw0vp69cuGDlEQM4Cy/zRlZ3R6dT/VzPCb7H53PQiHMWoDezmM5G5toR2J9y96Or1uV8eGdyJjdLI6raouf2Q7ecG7obFgV33YoGlqJNJxdsOJuZ1V7YkZRt1QxoWuY1w6XTcUSvn7fWwokD/sKpMzxOb4A0kQDQSmrUdBsf73hh9Zkd0pWwxZ5jgbaJba9oCaRrMuuECW+AY9sGx3JanH4ULyUzCs5xG723GkDc8iiQNd7YvSHL/fDuFYcN5ww9ADB67lUbkkCF4s/OveC5dowZcwwzgIo6Bc9LaoFYatH5RQ98amlkMgY3ziVQHvg7SkSIwCIzEvgmi8lmut1sjapt1pxbNI2EBtnP5rPtHD/RdE8p1UrdjeIsore8wkY64SLLjOgBBK2W4nig56CJNQUieog3tI5Tykv4nNT6nOHeIIjAbg2BgI/3ykyPRKI44ycj9maRe6+Jr5d4OJHABdsZ1laXuLF14uKtSUXZ7MI7hLiAPUDaMjfk7uix2GNAuYw1mcCSeqDRi7MoXqnn3rRaNVQj1sIbpXlE2WLUu3azsYOHaDt2W0d2G/sIRKOx55Sddx3PqpocDEDYSpA6P39CduXDh8PDh9T3fQUED6SMCfzekKJaVikBTdlX1MXRAspqIKHH+swhmYhPPgFf0/rILWB1FlvdKGd32nNd8UNrfVTcruw6IJ2yZh8IO5tfzoN5oLDR2ZZ/utpSnJ3PnCfoYyqXvMXSGh/2jeeeL772t8kafmOssv6E3mXgILydfG8KjxF/vv/5L9nDDx5k+4cP0cMH+N40IkGJxXqxlhc7TKOifczPv/r5z5/8/P3QEDIvgt4hX3z56Wc2/biX/tVXX3768asvh227dgDt2YRhbZvUZ9Ci03iv2EvCo7/30vssyR5+9A4PP97kWcuaDZ/gcT5fgFl/+Yk+gVn4OLOH7+tkn7Y4TLBx2roN3RSj+5rsyHf5Qa2+ST/D6D+F17WiHfjVfv1OHd+qc9yM8MSGZvHOptubN2+mDkt/n0GJR3n9dztqQN6EN4R0IQgBSVWCZu0P6aniGdPlKH7BiDZrCYExIa7aCqKdZ2ygOQ7L27/+9aeheabO/zUd6D7xbaFw5v9UayXX6aqlBwZiVf0xdw6b3BxhXAYIO5qG6kSSbceMMA97x9sS9d6S3+eFqpFo9G2L1qhvABsRSOw0iT4aQt4evvX8Q1XvC37xzb2H0Ts839d8/KmHgbYev7HgmLD74gBSXFjmMg+R2ndpxEUHc+lUC/k/TMQ2Pm7uoKEJuquR3dzSQErZly884wYJv5DBDvWcuyvW4V9PrSXne8c0IoAlS1dpdWsrzra55cW22JpEXUbr7Tk2cqEn+a0rJU2hI6qr0B8/F20rY1q1Zo826QOnuTIrkeOGR1rzzHb80t65BzAcbIj2JlvFpLxgSkmNyYRt6ID966u1+Aki3mVREn5Tnwr6UbZP17R8+wQDmV2SqYyOghG4BlknNHqLKqulbbAN+ywWin99SmCCuIbJNw1X/wBrymoWvO82Hzdnm5C+xlac4r6m7k523DdlgV3HZCe5yAtpwHnelzdBjwnnVjMD+PR2w53Nuq6JWMRcHZgqgZqB8mN8/s1ccn3xuDVHLTqzVofxHqGod9779imIZ7A/e/36dWtcKeG/K7cMq2YIlUcXDoM6si0vC2yuzIjHR8gu7FyyPXjH1qW5wGa2tVqUkW/HfvCD3//+dyuUIQppR2bv0C7ZTTTAd7zDFWpkblxTALGu2Am4auTZJ5nMY5McAo5zz7eV6sOOEyj+yIiDUHzybXTHHUby5nIbTXyz49+qAOUIXSm1imHj0rTkoqvGXX7cAGjt2m0mjSNQw66tsgk92H2e2A2q6JV16agdO5+nBAFC9llcv5W47dxzXzhtgb4es32eh94llF3eVttKXmu1E8F9W86PqrcaYXq6IqiGK5cyxShTlBJlmqJc8w1G+69/vMaIC5T4GUZ6c8RIb/6I0l6jtNeobt91U3vNogiY7Yn14llOL+QFrGQnX+UbDeOP/9DJWJym2IlEBFW2AZG1NkW3JG/z75J71cVUyW26EMpUyCxDEnflzu4RstOsG2Gw6/4NwyTgO2szAAA="), "text/css", "public, max-age=31536000, immutable");
+constexpr auto embedded_utils_js = StaticResponse(binary_data("H4sIAAAAAAACA6WUUW/aMBCA3/kVpzwMR0RR21UVasakdeukPm2ayl4oQia5tC6JnTkOBKH+952dsNGWVFS8APbZn++Oz/aqEqE0WsTGi3q9tJKxEUpCrOQStZkZNUuVzmeVzlDGKkGm8Y8Pm55GU2kJP+aPGJtwgevSRcKcF6yG0ef/S5p94183X1VeKInSsNqHAXgjjz73RIkzqad+1Hvyw0clJOt/6NtRbye/BDO+ZrnIMlHupCNxBT+1ykWJTC2aNEo0tyJHVRmaCqDdY+mO+Q9ZcF3iTGNJadB2g7UJoMQCRuDd6Tvp7Zxjg2FZZMIwWuGHGpMqRsbU/DGATEj0m7MzNLBYEsHOtRv6o34AZzudqkPqf858ykekwBbLycnUnkWwiRtMCUA/Tqc24TYDCtIogM3LMhK0Db0Skuv1d81zZAU3BrUMYF6lKWqLpr+3NLAU1K6Ra9o3bvhvGrJ2TeRSp55RfPPUjtKUekkTJ1GvZYYkxzWPH7Z/ebkSJn4AVrclxJz08iohzcW5d2l5k5rqsAXZw8N7NFfifuzirOEHYHSFfrQ9bjCCYQRzjXwR7fA+nnXwxi7YDTt/AaPlpxcdrBsb60ad7cmrkzUW74cN32ANu1Gnr0scdld4ECjBlFeZuQTzoNXKKXO7LvBaa6WZV8mFVCsJqcAsAUOBS3u3nQXWTuvo1tvKvLjKzQuwV9iErLQaOf241lbWKssaHbf2ugnyEJidFc5P+vpkOzoYCL+9hkfZ62yzl9Me6jfdI9r45plrNt2mw8HB2r2GPpfuLWanf3syFUdRh53Q4UHMDiP3Fv9e4vFqumeX9PK3yFY1In3Rmq+v3JvYpkXr972bdvvO80xDO/oLZ9jc4V8HAAA="), "text/javascript", "public, max-age=31536000, immutable");
+constexpr auto embedded_websocketclient_js = StaticResponse(binary_data("H4sIAAAAAAACA5VX227jNhB911cwynYhbbSynQZosakTtEAe2y6QLfrgugEtURYbiVJJKo438L93hqSudoNsXmKTM2cunDkz9hvFiNKSJ9q/9pKCKkX+ZJv7Knlk+u45yanYMvLieeeal6xq9HIxh79r73ynyJKIpijgs64UEyl8X62vvdmshi9cbIlk/zZMaUU2+/Yz4al3Xsuq5IoZALYjv9I6CAFFsGf9wBEG8Uv6/MBFVvBtruHoCo6YSJzKFxC9E0mVMmlUazCnS7j8uDDuPDIBX3wI6bwCb8yV9bUCLSFYgphZIxLNKxGE5IUc8M5ogquTS8l0IwXiGam6UflQQrECACsZkZRq6sA8sAOJbfACMTydcxV3vhVVQot7uKNbtvLNqQ/JOxg99K/XyQqwh2HCpWL6wQgH+lEco8KhdxLZ3jkIkT645wiSMo0IWNSQJIRzkWKOP9tXCoLqMSJMypAsb0CCZyTQ+5pVGQFlsoQ0Y/2IrR/aA2JdgseKmXkiNALeswJK7YS2aMoNk532H1zoH3+Wku7jDDwIVnC8btWde861WLJ/MFOmIgD0TkrItc/FEy2gjpKqLCmUZVbJkmo/BJCheRv0JID28EQQLkmDQM5acQ4vTUWCsMbzX5osYzJ02bLBcGX+dzhDY9OYJ7beGq6FG4R7IEb/xetNoXJvbmDpAI3bNykJFh8Xlz9ExGJzQTS0HMkkLZkKCRhIcmhgneOb1MU+Am1Vmc8czhMqCJWSPzFUpWJPKgm96qVVV7J9twfjg+8IGA7JBVlgALucF6wVaYkjzqkaa2G0BTOet2/nbq69JypJyeSWpSbmE0ko07hgwCA5WHUZ6Q8uAXqgHkMLBqv589U8AmvriMxP3Ju2OqXo0CMysomSkwhRmAPIynVfRDIKb7nuJC3nxshFwQolB6Y6qZ46LH1I1rKLaWjXzQZvp3o66byAWrqjSR58xd7/ulqsjd6xt0nBqGHioW9uHrTwIATHvdBggBj1L3bAtE9tGB2EIRHtTWAoaBhYRHAcmdhMdIYenfQ4PDchbmC4QOe9Ym8kviRH5l+mEjhy/ifGPt2TnnXHMDyIc9f2a+Rq1x3aRzs37to5NonKDbezpc0kXp6IzUp1sTmlLvsmdy6hDv1sWBPYV43kbmih03EuWRZjs9OEBbO/c63rWUT8nfLD/jiIP4R/zeIP72aR/24x87GnfVrz2U7dmrG09C8G42tcF5Cvbg8JwPqgbOINF1TuMZ045ClW/MYwrj8QqgTDXCO/jN5tkEy4uSaTv7c/XEaBmVJ8t8PIrCkBMEvVHvaVgD29Zt5kmz3FOGLIDbnCanYph3mNKDvKta2Kfj3pCmy8DhwFYwI6vD0k00AYEWiNYgLSV7BOYDLH8UxazpIwbkEgCmHhpwExz+3nzV6b5c9NYivej+Hbo9mLErFqNiAQAO1+H4afJhRuFi+bTYO+mq8REmmavH9vLbZ8ewN8C/7juIPJRXYczgbrqfHUgiyAvlpnLQQ4YeotuBxvE9MYwjYJQ9cvTT9jBtqNsbM0X3873KLdD9yd87Dg0HyLMLYtYTNewzXEBZmYEPfWjBkXS31iAqTgqWZWpgY320xPxku7aMxmbangYGIprv64JCgmn5iEx5EVTROqdOi5mjYDbLJBG06a0NWEipc3L8es+43NjMhD/oWqj6b8O2gCI/4KnXRd2f3GCI4T1aZqOHjBQ5ru7zXVDB+947349893v9lSLXjJNcMlr4E1Diqk+20F+5X9kRQNEw0LElElLQpiy0DZJux/T82vX531neTFEub+5fp28QnH7GgbcxuI6yqorU7pJ1dmw99wLa2ZXeV53a1pDkXlPOsIpO5uTxfqWW23Zy4ahmV5aeAkfulyiqjBMyhcXLQu2FEHww7+Dt5/3RszgvsOAAA="), "text/javascript", "public, max-age=31536000, immutable");
+constexpr auto embedded_binary_formats_js = StaticResponse(binary_data("H4sIAAAAAAACA7WWTY/bIBCG7/kVkc97qJ10m2q1p6q9VZWaQw+rCBF74qBgQDAkSn99cT5tMti59DrPyzDwMkDmHUwdWlFi9jaZlFo5nC6Ro3e/PP5x0/fpx+Qj80LhrMhephmKBhzyxmSrlx7YAFRgWctjhJYfmTag0nQjpOzQAPPXPtzVEVrzmrX1+sag0CoeCI1h2qPxyPZcehjgYTVpjVCDKc44lcE6J+7rXdxGOdFQ4XMyd9p+il/qJQWNriAKcY+aCN/siOIXB/Ue7BY4RtT4ruedAXGQx3kdastrYGHGSqiTjavbWfvJlefym1Zoteydt0V0qoiJknFnwrg4rm0Zijgto1PAEvCHh/vUN+92dbm9n7lTih2XYt0P8bVT+tCPbbyU/YgFB3Z/LmnV67NEm10XFzdLWz4J2jmZ0YdEC0p9GKCl1jI4QzJeotgDia4nhYTBdbrS617kKVAkrpZw7C2GlvcKHxSt52l82jWSn62OTj4tut9iJB5In8r74BzJ79aRuPUuVVFwgF5Ke5lY4BXbcCG9BVp2NWSWAvP/+gg8+JPvahI/PhLd7WlfCKiGEUONXMYCAGN1w8BabV0MvSHbUHK3ZVLXouSSHaxAcLTGbI9uVASWO3Ds0yDNB2kxSGeDdD5IP9M0GAGXRaUK70rycUkxLpmNS+bjkidW9Dou+TIuWYxLvj6xdWF7J5335PseFP6GUtvquZ/b+TtwNJD8S1D/peQ3KO5LbuveU9upbyn+QqgwL94m/wDeHrkYgwoAAA=="), "text/javascript", "public, max-age=31536000, immutable");
+constexpr auto embedded_computing_js = StaticResponse(binary_data("H4sIAAAAAAACA21TTW/iMBC951fM9pRQFlPUlXaV9rQ3JKq97QGhyBgbrJgksicgtOW/74wdqlLIIZ6PNzNvnpOHPmgI6K3ChzITYjGv6i18h8Np5/WhaQPCcjEX9XZFyZBy/qR2jjObtvPy0Ni6BxQNLMOA646E6tqj9rCs/3JEIUXUSTkNaPeaoKssU21DTVS7X/cBbdtU2hh4henk569n5uJ16B2CDSAV2sNQKpGKITN9o7gIlHSqdxJ1ZXrtKvSyCV3rsWJ0HvcZQ4jv7jgGhQX8y7zG3jcUEAkxeppOpzD6QqYYcd1IYQkAQtAycxEIRSqIek5GAMEOGSsiTryKVXaG7Ir7RQcufQWSo7jHPaKu2Soc07Kf2KY0TbtPlrjkIQFI7oIOScSF4NExWm9FmH2QZULJoBs6Z9ekKqP1RvsqdHTmrOQYbGPRSlcZ6xyNYWLWQG7Dm3zLb5Lv75AyXBzdbzeYYa/Z8zQJbKRza6lqOEjX68va3EB8qS2J8a2Kv/kD+yO93IfbizdM2GmEtfae9n4qoxe0428uOaTbhy0H27Qe8hgg/0dJxwvMiPDjo+SOsWQhcTfxbd9scilMwdvEJzbqjjOC3L/qTzddpLGJXGwo1yHnYvqXjpRlsTn7Ejfg2cMm9C6ztIdkYc6JFEWEKTM52GX831qnJ67d5rFFeZF4KXGscMXF/wHQe/4uEQQAAA=="), "text/javascript", "public, max-age=31536000, immutable");
+constexpr auto embedded_code_js = StaticResponse(binary_data("H4sIAAAAAAACA8Q87XLbRpL/+RQwajcCbIqi5NjJiZZSsRPv5ipOtk7OpWpVLGYIDEUsQQDBBz9sq+qe5R7tnuS6ez4wAAak5EvqnKoInOnu6enp7unuGcCtCu4UZR4FpTsZDGJeOkGaJDwoozRxrpyEb51f+fwmDVa8/H4XLFlyxz1fgkZhATDf5jnbj7I8LdNyn/FRzsMq4KOAxbEXpkG15kk5+r3i+f6Gx0A5zb+FHvc2CqeuP3Q8Ntz5V9cfB+x2N4I2oLibDHJeVnnisMngfvjxXg34Jk3KPI1jngPUx8GaJZfw5+ypI/8t0jzgs6xaZ5fOgsUFHw4WnIc8r38iSv08KzLov3SSKo6HT89gsMGgKFlZFUAYfoAwFtGdeMZ22TyD2a6jgsufgyoLWclnAnMW7IOYXzqs2CeBs6gSEqbnA6fRwvHKZVSMFGgZrXnuOwDP8vfwnFalDWAyKPM94KMMcv47Tv5+UlMDOYzEPJ0nV1dOlYR8ESU8xCEBXPYJWoDbxvnGee5cOmNB8Emr13dCWLWSt7FgYRwOYrQPcfHiBQC0OGRJD3uwDl3eALqPMZZYuGJJmyWDrOSnw5BY/362RHeTLdn4ja2RuLWwJrotDKoBrALT2tzDYN1vcli3fuOc93CkYdosmSQlT2dnQhedqHDmecrCgBUlMD3fA0HwHjzf8HwI6r5y0iSGxhTaktBh4ErWMFpoLF9RzYsgj+aA/umT8/P8X+APRhsWV7zwYHx/VKRr7u2cq2tnB5NGFnxfKj6YGAOu2JZFppca4WAzQAYapecG7tDhSZCG/HWUsHz/NmdA8R1LKhZL9/FrMUQr8tGskCkw5oAXhTQ5D8fxceL3TsDKYOl4HFkg0DSZ8TxPc88VwDgYwXaNFlgteNkwaoubGM2jJKRecIXn4/EYqaET0oLS7mrQ5POydi3EsZQSDAYjh7wtgRtC+rkqcfZyirguAD8q+TqbwUNWlTNaDOeVc4rMjLWdWcEmA1IdO4mrnvanznh03ho7Sh4ytAHVHtkkcGVvluO2mWLw2Mdw3ddGFoStuO0uExWUQW6q34EieD9V6znPPdUF67rO/KdSC4S9CMsj8hOtglKBhDoheltptIpY9qC2HV4J/ZrIzaXIJIe/REn5Ne3t3hGTQyu4PZ9qe2oQR4qjmCd35dK5dsbOF19Q0+0YNvor9E2t/fPh26faPFdRHKOZ5d2+5r5JUzsyl/c4l6kp/qLXnJQ1IWW/uTp6cWoyuEbHHIrNnzzIndi8yfNx7U5yzsIZ30Ak1lWKIkoC3nQft9PJYLuMYg7yzivqBIkVKvhA9SDNeF0tFiD3L2EUqdTsPyO+la6cl6hDzy+88dChQYYOUZtoYg9Zke9d4a0V1jrNeVdFaQ1AqSYD2MIcj6aywKU7n9DDM+d7nP1/wELm4U30AfyM1M35vuQ/kn5KyKs2qDn9wKoNBoJSiFERRwEY5wJ+WxlAcwF6psMhc2m2SO+hm8m7mHCiwQRrORnVRt4FAKV7QaeTVcUS+30Vejwh4cLOjL3SaNFKfUfG4+SGaC2FT7o1AE+d82k9Em2gSvNUGG2x6ZaaCXsl9RZIME7G8oLPUKiwCPyINzp5czKE6FhIl3g2iB0xQQGkbVAMBLsQ6JfammlOg0HbCRub8Q4II3dFCvYYp3dGqLDzJw7gt3zEUdwmKvFq4gydvYkm5kKthDIAO+xbANGsXKsMx1Z8X6gemxJM7GuGJjdPwz0sGCBDSAhOOJ2BNa5nVR6LkEyRnTzCI9/A7JGuRBIUcEKbrmog3NBxv3ABWM6GFUV0l3iGEgxNGoaa5BhWNPWjKdNerUC1QK2AnGygZOtI7yzHQjl4wYJk3ZAzNGHU/T0Llt4K417la3B60Hu7Ap+m0+g7yMJjjo/F6/1P6HpWNfpOoO9GKibZAL/+4J7Y7nKG7oPnoJo596IQfDP8Rt+1mIknMOKYHmv/x2N0f11mXu9/CIGG9tFBhfsVj5v8volhMYhpFwBc4a6VY10cRgCABkLM5sTM4TGI/QYeTuowGkZuBtoAn5WmvY1TBpsvygT1Rkiq2alaAUALsAlRy3VirgpL7mLuKXmjqmO2Qw3gWi/A/J46F1+NnTPna5kRM4iVoRnBdMs1wog2eNDKDT2nzpcvfNiG3JDfuaQRIKDRMgpDjpWeCKb/k5oa9oDb+LYsIYyrYBMBP7SPOViiW+YsKVCbL508LXGDcYGoyTwM4U9cIaDPoaIlWFOi1Yb9bldiCgdL1mQYEl339HR06kK2iw2jMn0b7XjonctVaKHqFWgA3ndNZFHxmGyDLOrxdpDND+vaAkLXx6o1gTSQ1mw3A4Gi560LZNLZjbBjBRsf6YdwDNcaw3eUq1AtiuYqJYscj77Sc0GHQtBnHWgEfcfK5WgRp+AoPXoufs9Lj+g8dWgxMfrwzkERm92+74uwRIttUZToPxaoAH8FXc3mfXq05NHdsrxE5UGkXlV5GyURIGb+N16GCZavV37sX4LunLrN9Q9YHFSxUgHYYNYsEvGK5BAWbiYjLcO0DfHTxn2Lir6faWh3arrIBxEwCmsmNvy/ynpxxdqL0UeL89VdaeAiNw/FLRerO0LVih+zrKDETk/gtJZGg701gWmMM8l07fJRprjMgp9XNdY3kCdeqvZT3T4ZKHcmcNF9NhYtTiEY2EIKlG7rVBdmCVogTan1S3s/ufkbxIplupVxIVCEkBAfawWIC1Qs6Onffpb7OUPn1a6Py+1aFMiBzpDcybUMwp7QQM4ndAEBUvsxKkpclBJmXHiCDeSj0c/C0HM/pPOcfeAJjXov9309IZgrryf0J8+kwRysVrrhbf46UUlCHBa8VaporlhNtUzvcLdwCQ9WUUx60IxwnYSBHW3A2WdxiiWCRcTjUG2wW9K/KAQzk3DLrQZ1pyLgnJeJTT7v2Z2QDnikMqXREUZrlCyqADZ4asgxAkgHV7ih+0JCFMsu7mQpHwM9Ym1KeT4ek6C+S+wwKtg8FoVoUlTTTejonmLJFhdSr/spIRtxdFQFEETuOfg4iiBYz//+/t2PgOeC7zw7o1JwwBIs+mZYtysc9J85ZL/QlTsyni8cWE5RMw6dNWcJ5RKPSAe+c/0RheiekCSe3MjUQMlN8oTWRDSxeE5gVOQusm7eICs4ZmBOTTq0BvvK63WTMR3VsbBHagpR1lFBAJlvyaU0YcvKGCkJCXx+AFDu7wISZrQ+AEvJP8IiXGuPRAvFLTJnYZT2wCSwuBSO6X5QVDrjMzTVECtO1qZLUtlBz4psxLIMVuwNrGvoIU2/09qaznvYrH/C7JCCOZz5vAFOa0NqZ7bG8y5kH2Hk29dOx3TzYcQgz54J8+dJJMy/3AtHMXTAIcinMkc9bPgPCtVM9yGQK3QdhrvlMUm34xugCQvxsCQjIkt7Ifxt9Cy3qk+xIjQjIhVsx4naK0nNuD2XulnmSfgQeLRwIK1TyG5gINwUVlaTUIN5B2MJQ3RT/+yl3wi7hY9dH2KudrEAaHenbT+vhOVL77cGSRhoYpew+2L8BfPCpVWC+LYQpfpaljMBUQuhBkG/I5IT6KCt2ogleAzmlsE2GCbc9dXhm4zNIQZ6PrYhrFlsgb52/s0KveHxqgUukyXJuJUp6rRypudL6WYPZpdFjQY56YtevBazH5tbIaCLzdFUIUqLJfGnL81QXq90Z58Tu8qhfdM0UBUO3tsIKmdneBGpfWAEoK9lvsccsBFjHMwVW5GZPZAgm0cjLQ5GI3pHILMiuzGHb1zDUIZ1i9vAVbqaHo3xBANDp1Np6tr8boRUp8LninEeYX8gjXrqj2EJFW+HsmnvhD7WMN2EbNRViyOMeGczcuSe+vChbdSDT5+UwRqOrz3uOgKf5dfA1weB2Q6BKbKnyQsd3LWDfCBEqmKaDOUNO71lxClIxqfiIa2BsqOdJSY3ycmcAalBW8tiKQlyFyyi2EQPLVf2M+ytiymX2xbAwn8y9dti3kfV1rb1LVPwEZHXNLyOZeqtOoWwIcK5ZOkWEmwsBs+wSiBtsDeV2EaL9iBmCIDdrf3/zzDq4oE5yR9szng2hLH1varGVzlmZyDfotimeWjFdVEmIwWCwhED404eLHmw4j14CShzlLl0UuyOR/SfqzSneNyO/md5FKw02f1Jrx/BJyzv5GXxa1QuPZqn6xvVJYr3gMioyGLQyJPRia7eIDHoh4gxCVXFvz4wIAfzA6QGu/pgQ7otH9dug3u4eLiW93uUxbfvGJle6H7QcSbHfQUG3dK3TJq+Com1lQKF2dYmJCsvgdhQ1KllR5t8GUYYCmTqz73WoPH08z1XYc+BeryXgWMGr3jv0YIhsxISKZ2bqbyldnrCa5WpcG2Ft9kvc75J0qKcYXBFRT96EoDUVvE4Su7oeQ6akVYCIoZRCKrWwHf/Pluh9TSotrdJAVoQoBrPDpNtUTclI3YQur8ww0Jyq/ZKRwVZmos7HR5xNsRRh0h2qFKIcCG0sTGZEOndGpXp84vxUzkS3re6gHTH0E06dMFSSLaV7q1Uhe2AR7HHyjOFDHqi+/IUzMYL8BS+7pZjs3IIVLSqhgu8+PLKeSG4AxfWJPICy6SahoC+cl4Y6ICBlvtSEhi3CEBPgw01BrTjROGf8jFCGTA4XBhnCVIvRPP59FR21qqj9wjZ1Iy+tVZpMNnUADNDZ6G+pMi4ap+vx8oH05p5bYaVujnPnDaTqssndFLVWgUtTDWxhgO76uOym6y2xpo4A/OcP9vqQMSQnbGuANAvwlYAI2RhVnePpf36aB19XiF3zePVXtp+FJYOEa7wsgIRXC7lXSL6wVl9Q08juUtoUqVWkmSj1zzAmAxu3UUVx1iwAit3p7o6ly129bYvpNEZCGGeOe7I6NbDalPoQMsuXQvW1tGBlF0KMrvYiu3YVO76etbQEIdU8qHJudYcreFSpNuLTLtS7fz/L3ShG6V3JWQKein/DW7bkNPmRYOdWSvEH+pqEkwd1dsY1YSECUxafQqRupZLcS0JfqBJXGw9Wbcb3HamZnB0dd3Lj4oJgXJzAp4qCYJ5tBJjkRKvOSuqnItL2pAdq637qnGDqZUHrDmmIbN0laSoDJawX4sY7/AjSlVwOVQoFdMIEuqxPgpX03JoelgiII4LiWGgYslrgZ+LflYv2pFIj9AO11A/sCKdJ9GqOpAnKZjPy5WO+qejyVQd34vo0fBelCnrvEQOXydH7lgmQAJztFynJW0N2b4Ed05gV92D+PkdHsNLnBXLWBCVDMXQi6GO7h+f9eml4QlEqNDu4RWxwxKTI0i57MzQdm/Nh8MUT2W8hTxZkfcGWBzh6YaeJ/xUwtR3cOZFkm5rIPG7DTVndwFsfWUNZ8i3HT2ujTFt69GGB/mbTLYXowN+Fyxxf9A8PYUR9Z2NaB2VR47T5VqiX6RijRJaR/PrOhON6eubl530SpdqBZJg8ZVzSuz0o4k6rYlz7RxBkSVaFYSCrF8555hEwtM1ilIcrNmRE55BIJWwZRomacmWWU0IF0FSwkdKSB9BCnAErc67UVLDLpWmyfdghkI7L6WSylZHvkkllgQoyChjKi4PU2pArSQtaqYn2DaUcclbzbTvn4vgwH54ubC+nHLDy7ew19avpagQolkVMfLQjy56E/dyPR+6QrPcSxCHqspQ5i7y2H+IF9VGaOG32fkwu5gqIDzBzMWRLnpoy51qqSbb5i1Qa8Zq8Gnc+PXMzL+znrQMBY+XLJaH983blx0ESAP/JYt297X0yUEL/J4smxy98ldisXDVrXWkFrQkjuCtrKWg48UbETDM6SJ87QYrLcWuWCWsvgNbxeg9Tk6Mq+sRXemDP68MSnIVoPnZs3okvL4O0DXYbTQVyyZ61JrNYVlWE6qj0ojPrpybMscEbgEq8mbJ8jdYaEAkf1KXWwV0c/J4b4+VPyQlz8FbegUHTsJC3SJ+om9bqQ7tWVy8ZiWrBj8k76KkIt5fjo3Wv6d0d/TlGHysBjL6vyORXnwpuhFadYZsXzTvoUkGIKcWiHgSLZv+eiXbFPYSKB1Cx5E6+Obwa+L0EAkxlw4RNcWuPlDKj7O6FmtYL91vf/mIHfeh81tzTaGDZgLJolhezx9lLLzBaqN3MXROxif+/eVfPkpuD4L9Zl646qqBDPtyfhcV4IQC7hnOG3Ve+h7PS1dU6FL3vsCLByJ4obd4IZ66dH92h+45/P3BHQ7cl/DwN2j4SjVcwMM/oeE5/P0eG17Aww00fA1/X7uD+0k7ygTOokQlYyps/P+qsDtDbzeMwh26Fiyz69zEM+SyoRsltWxuZcQprXnjO42L3fUP+QRL+UuW8fwNK6heKOrW6p26k29PcJ+VDdcn/zzxGxV/KuoDjkIxXP65smyYAVCSQZPoPxWdIoSG/mfnmJMFVeF1D4nI0dad4ngVhbHi+zDd4tJ5fEMSobLyBi/iUGb6mgWrAmI07uLrY5pp5BobkC9pITUnp+3BWnPFTNeanBmHExrfuq+oEwdkuBPH9bx3tuB4c8k9Y1l0hmEAxANgAGteQkwDqvyPn2/eu0Zu0WDi4ObY3Bvvj56RWFgWJaCQ68AYRyeZPZO/z1u/L1q/n0/VyQdV+YGWUqNXzpd+O6Cje4VRFhVreSVQasuDRfdxIAR36QjBDQf4/sclTQJffFAXwNRblPg+8XhsE56MLPeNkwoVJFlfPyK6ePZD+XC68nKwvxVP6gLKg/9Zjww6QI9afXX5s52yUVSWr2dhfCevKNjd9RDPdFBJHniDoS9fn5cPdqMIajkd6crGAWH7k3uJcf4QDJiNQLFLxeket3TLFthJajftn24ZHp5tGR7dMIDEkIpZzRvs7v/813/r7emRQr2wHVOpHrs7q13BkduYf3vQhOTu150WjoHOeirMxsaveYO1x531HKJp1rXKu1labvJwloZg0+mGCYOhlVslj33R0P3F9cWpbN2Nr7yBE/CAnHIHmvXxH8T6MoYNXnBuHdtt9eRc/sDXJlKRMtMra20z2OyTKgaplPR2IsR00WpPltCp+0SlV7/318+rJkiXo23vDB55lROC0IY7NbPM7svPtFHLLOfYW3y1W23CYg4qrp33nAuLyU86MJZLYYLDt1SQfSeqs8YbJMxauBWvediLUPM2Br0fYany4vWfG8hK2R3XwDP5HolCwmKWrD4frxy3DjpZHChyBO6x4dy3elb91gxF4XdJCoysWTLTdXrI/MxFbb9Wa5a/i7LOMNuUVE9R0ndjRM4rbw4Y5PV3YsQdRZo80NDfYVHzxjv4pYBUVMWXcg4Slp/FkRhrcp8UPXergev6lT0D9KIP9FytFDJLwwCn3TchGAhqgyFlzfATZNjEZslxVPpOD+HpWOj0tCNzXG+69V6yjd4k4Rk3SPwrRvlJXH9xcY74lpaa7jPHdfC3y6oyNTrVzxoAXBb8sQhmMrC8yOpu9kVZZfoiN6M53bqd75C40+HA9tYTneF1cfT3POhtKOvA/eManyHpGxaT1Q6GdVB6J9HVxyfDvnfV1LKnm5iFLDikOBAs9CmNxu5RHI1aK00DDz8ldBBRft6oxsyLIgKMZqCAghEdEirhpXytfmq51Qi9+uaR0H2MTUCweMtyWu+2SFZ6MsDL8YDRVd8lUTZTgXjFgmUs4XETXSjzk9pE62Mt25wzLmdNrwXiz8bUi2hdiRdT20ySUkB3k7uQb6KAyz2jKzDVkf6IOwLHb4eoYk+DAKrVQwjg5yRqAveTlucWL65ddb5McGjB6EqruVq2rxjoc9Is5xld3cj5B5QFotNXNZAWTzh+wgEDLHdo+9KE2EUh05kJh+vgq6j6wpzFwaCULHuWCAcOBQk9RXvwgu5lzcB9bdPmRwI6jPRHG/ZwqDLiITo4byumeKMOX4w5IMDOEXfnZRfzBPfQEbA8LEXMjnP+HGZ6X9kRzhtfLCjgAa8f0g94LtwGF38uE1EieIgSzUKUNDkQV5UPKnBjtNYNZ4OSuG78SDriCrNBpRFYPJCWzTSeN3TS+MRg8yCLlNSMqaSG98Yl9I2Nbhzzx3KKgaONTRlQPoDHe/3Wng7Vm+ElXTWxcE1cfTbbza8UygqcvNei4tnzsdo0cMOdCZ7R4fBN36JbmWqP3vkEoT7FrxdM5Gjb6KFL9tFAMzdClWPJYkEDyPpii+sPDgxoy3dJaD15Vs/iiaODoS3dMz7H1VyNB6VoEznFnMMm0kjSDspRVnAOjUB3zykHPPK9AVuGaEtRRTpjTXj/t5Kr2U0YhsF3nmLiQgsT4cRhaNuD7FABQwIxUUTRYHv62Y6dxG4C7FjHdtL8+ycfn0ExRtdI9AujeOP5bDzPG4GJDcgAh0muOzKcV1+J3YGzAM4hYPzgFdksv324XhF9852nUUc0lNKRSIMJwmxBGDMCGs66o5KJp4dsY01ety2lfUovcm2X3Xm9pcNf6sxVwEW9GjQdq7AtT5Tof+8135VqFVWxWq3J/rArtFL0SE9oLbp/XPmPaCzMOMbhccV+DV1+bo9GnkhmFgDFCIo5YIQDWSkIVKPEb7VKAZGUMFGyExG3djOODGkbB3B5KMj6ZWzE07XtFC2rRIA3mn1/AGMJWFaYwuuq/DoLC74OfYuAAA0+JcM9ya6EdDTggp7v4VBgrLdY7ovJbqKEFFNdTMJkPXCsb8GEWXabriErUZxe8FFNp9MUG4C2oyns02C3VPvXt716zaNUDesaNByRiyraE0xmWufltIOLO0ISpSNFRcftT7eDfdzzwAaH0DUu5cAwd8oAO+lNbzzvmzfiE8+YPh5isPEdOmZHiinQcRCVA9f06IlaZfjDqwKfMeIT0YUBG9d7LE3IISb0Qdg88Vmx6MK3VzjHGAtFC5kUFdRdUuInRFYL/tnkaXjNNaAkkGTpex/WxPMnzrQ7YosQwKPO/t2c2gAB+sixvhgokfjxHozdSKtfZv845DPbCKzEqK10B+hHM/2NQNz+7QFzvpW3l69yjFUs/l2m0oX8OtcO0yyMM1Tm3Gg1gmZyFDhAWFMYRDWCP0J8pnTztTi7lUCSbPCOkvGKVMMgQuiS9a2EuYexrucEdCmX7G732XPi2DQ1xn2+G0Z5wLFg+46CTz7/spcYpHklHOWBEweDP7TpBsqEYAAA"), "text/javascript", "public, max-age=31536000, immutable");
+constexpr auto embedded_main_js = StaticResponse(binary_data("H4sIAAAAAAACA1MqLU5VKC4pykwuUbLm4spNzMzT0LTmAgB1i2oCFwAAAA=="), "text/javascript", "public, max-age=31536000, immutable");
+
+constexpr EmbeddedAsset embedded_assets[] = {
+        {"/", "text/html;charset=utf-8", embedded_index_html.body(), embedded_index_html.etag(), "no-cache", embedded_index_html.response(), embedded_index_html.not_modified()},
+        {"/style.css", "text/css", embedded_style_css.body(), embedded_style_css.etag(), "public, max-age=31536000, immutable", embedded_style_css.response(), embedded_style_css.not_modified()},
+        {"/utils.js", "text/javascript", embedded_utils_js.body(), embedded_utils_js.etag(), "public, max-age=31536000, immutable", embedded_utils_js.response(), embedded_utils_js.not_modified()},
+        {"/websocketclient.js", "text/javascript", embedded_websocketclient_js.body(), embedded_websocketclient_js.etag(), "public, max-age=31536000, immutable", embedded_websocketclient_js.response(), embedded_websocketclient_js.not_modified()},
+        {"/binary_formats.js", "text/javascript", embedded_binary_formats_js.body(), embedded_binary_formats_js.etag(), "public, max-age=31536000, immutable", embedded_binary_formats_js.response(), embedded_binary_formats_js.not_modified()},
+        {"/computing.js", "text/javascript", embedded_computing_js.body(), embedded_computing_js.etag(), "public, max-age=31536000, immutable", embedded_computing_js.response(), embedded_computing_js.not_modified()},
+        {"/code.js", "text/javascript", embedded_code_js.body(), embedded_code_js.etag(), "public, max-age=31536000, immutable", embedded_code_js.response(), embedded_code_js.not_modified()},
+        {"/main.js", "text/javascript", embedded_main_js.body(), embedded_main_js.etag(), "public, max-age=31536000, immutable", embedded_main_js.response(), embedded_main_js.not_modified()},
+};
+
+///find embedded asset
+/**
+ * @param path request path without query
+ * @return pointer to asset or nullptr if not found
+ */
+constexpr const EmbeddedAsset *find_embedded_asset(std::string_view path) {
+    for (const auto &a: embedded_assets) {
+        if (a.path == path) return &a;
+    }
+    return nullptr;
+}
 
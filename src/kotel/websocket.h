@@ -1,9 +1,13 @@
 #pragma once
 
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 
@@ -75,6 +79,19 @@ public:
 };
 
 
+///Detects Buffer::alloc_back(n) - appends n bytes and returns pointer to them
+template<typename B, typename = void>
+struct has_alloc_back: std::false_type {};
+template<typename B>
+struct has_alloc_back<B, std::void_t<decltype(std::declval<B &>().alloc_back(std::size_t()))> >: std::true_type {};
+
+///Websocket frame parser
+/**
+ * @tparam Buffer buffer of the message. It must have push_back(char), size(),
+ * clear() and data(). If the buffer also has char *alloc_back(std::size_t n)
+ * (returns nullptr when there is no room), the payload is unmasked directly
+ * into the buffer several bytes at time
+ */
 template<typename Buffer>
 class Parser: public Base {
 public:
@@ -182,6 +199,15 @@ protected:
 
     constexpr  bool finalize();
 
+    ///parse whole frame header at once
+    /**
+     * @param data data at beginning of the frame
+     * @return size of the header, 0 if data don't contain complete header
+     */
+    constexpr std::size_t parse_header(std::string_view data);
+    ///append unmasked payload to the buffer
+    constexpr void unmask_payload(const char *src, std::size_t cnt);
+
 
     constexpr  void reset_state();
 };
@@ -195,6 +221,18 @@ inline constexpr bool Parser<Buffer>::push_data(std::string_view data) {
         char c = data[i];
         switch (_state) {
             case State::first_byte:
+                if (std::size_t hl = parse_header(data.substr(i))) {
+                    //complete header available, payload follows
+                    i += hl - 1;
+                    if (_payload_len) {
+                        _state_len = _payload_len;
+                        _state = State::payload;
+                        _mask_cntr = 0;
+                    } else {
+                        fin = true;             //empty frame - finalize
+                    }
+                    break;
+                }
                 _fin = (c & 0x80) != 0;
                 _type = c & 0xF;
                 _state = State::second_byte;        //first byte follows second byte
@@ -246,13 +284,16 @@ inline constexpr bool Parser<Buffer>::push_data(std::string_view data) {
                     }
                 }
                 break;
-            case State::payload:
-                _cur_message.push_back(c ^ _masking[_mask_cntr]);   //read payload
-                _mask_cntr = (_mask_cntr + 1) & 0x3;
-                if (--_state_len == 0) {        //if read all
+            case State::payload: {
+                //read all available payload at once
+                std::size_t cnt = std::min(_state_len, sz - i);
+                unmask_payload(data.data() + i, cnt);
+                i += cnt - 1;
+                _state_len -= cnt;
+                if (_state_len == 0) {          //if read all
                     fin = true;                 //finalize
                 }
-                break;
+            } break;
             case State::complete:           //in this state, nothing is read
                 _unused_data = data;        //all data are unused
                 return true;                //frame is complete
@@ -266,6 +307,58 @@ inline constexpr bool Parser<Buffer>::push_data(std::string_view data) {
     return false;
 }
 
+template<typename Buffer>
+inline constexpr std::size_t Parser<Buffer>::parse_header(std::string_view data) {
+    if (data.size() < 2) return 0;
+    unsigned char b1 = static_cast<unsigned char>(data[1]);
+    std::size_t len = b1 & 0x7F;
+    std::size_t pos = 2;
+    std::size_t len_bytes = len == 127?8:len == 126?2:0;
+    std::size_t hdr_size = pos + len_bytes + ((b1 & 0x80)?4:0);
+    if (data.size() < hdr_size) return 0;
+    if (len_bytes) {
+        len = 0;
+        for (std::size_t k = 0; k < len_bytes; ++k) {
+            len = (len << 8) + static_cast<unsigned char>(data[pos++]);
+        }
+    }
+    _fin = (data[0] & 0x80) != 0;
+    _type = data[0] & 0xF;
+    _masked = (b1 & 0x80) != 0;
+    _payload_len = len;
+    if (_masked) {
+        for (auto &m: _masking) m = data[pos++];
+    }
+    return hdr_size;
+}
+
+template<typename Buffer>
+inline constexpr void Parser<Buffer>::unmask_payload(const char *src, std::size_t cnt) {
+    std::size_t k = 0;
+    if constexpr(has_alloc_back<Buffer>::value) {
+        std::size_t words = cnt / 8;
+        char *dst = words?_cur_message.alloc_back(words * 8):nullptr;
+        if (dst) {
+            //mask repeats every 4 bytes, so it is same for every word
+            char mask_bytes[8] = {};
+            for (int b = 0; b < 8; ++b) mask_bytes[b] = _masking[(_mask_cntr + b) & 0x3];
+            std::uint64_t mask = 0;
+            std::memcpy(&mask, mask_bytes, sizeof(mask));
+            //dst can be same as src (in place), every word is loaded before it is stored
+            for (; k < words * 8; k += 8) {
+                std::uint64_t w;
+                std::memcpy(&w, src + k, sizeof(w));
+                w ^= mask;
+                std::memcpy(dst + k, &w, sizeof(w));
+            }
+        }
+    }
+    for (; k < cnt; ++k) {
+        _cur_message.push_back(src[k] ^ _masking[_mask_cntr]);
+        _mask_cntr = (_mask_cntr + 1) & 0x3;
+    }
+}
+
 template<typename Buffer>
 constexpr void Parser<Buffer>::reset_state() {
     _state = State::first_byte;
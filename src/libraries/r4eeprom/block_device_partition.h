@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+
+///Presents part of block device as standalone block device
+/**
+ * Addresses are relative to the beginning of the partition. The partition
+ * should start and end at erase block boundary
+ *
+ * @tparam BlockDevice underlying block device
+ * @tparam offset offset of the partition on the device in bytes
+ * @tparam size size of the partition in bytes
+ */
+template<typename BlockDevice, size_t offset, size_t size>
+class BlockDevicePartition {
+public:
+
+    constexpr BlockDevicePartition(BlockDevice &dev):_dev(dev) {}
+
+    auto get_erase_size() const {return _dev.get_erase_size();}
+
+    static constexpr size_t get_offset() {return offset;}
+    static constexpr size_t get_size() {return size;}
+
+    int program(const void *buffer, size_t addr, size_t sz) {
+        return _dev.program(buffer, addr + offset, sz);
+    }
+    int read(void *buffer, size_t addr, size_t sz) {
+        return _dev.read(buffer, addr + offset, sz);
+    }
+    int erase(size_t addr, size_t sz) {
+        return _dev.erase(addr + offset, sz);
+    }
+
+    ///partition of current instance of underlying device
+    static BlockDevicePartition &getInstance() {
+        static BlockDevicePartition inst(BlockDevice::getInstance());
+        return inst;
+    }
+
+protected:
+    BlockDevice &_dev;
+};
@@ -0,0 +1,362 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <stdint.h>
+#include <string.h>
+
+///Circular log of fixed-size timestamped records
+/**
+ * The region is divided into pages. Each page starts by a header containing
+ * magic, record size and sequence number of the page. Records are appended to
+ * the page with the highest sequence. When this page is full, the oldest page
+ * is erased and it becomes the newest page.
+ *
+ * The object keeps an index of pages in RAM (sequence, count of records,
+ * minimal and maximal timestamp), so queries skip pages which don't
+ * contain matching records
+ *
+ * Records created before the clock is synchronized can't be written, their
+ * timestamps would break the order of the log and the index. They are held
+ * in RAM (defer()) and written with corrected timestamps by commit_deferred()
+ *
+ * @tparam Record trivially copyable structure with member `uint32_t timestamp`
+ * @tparam page_size size of erase block
+ * @tparam region_size size of the whole region (at least two pages)
+ * @tparam BlockDevice block device (can be BlockDevicePartition)
+ * @tparam deferred_capacity count of records held before the clock is synchronized
+ */
+template<typename Record,
+         unsigned int page_size,
+         unsigned int region_size,
+         typename BlockDevice,
+         unsigned int deferred_capacity = 8>
+class EventLog {
+public:
+
+    static_assert(std::is_trivially_copyable_v<Record>);
+
+    using PageIndex = uint8_t;
+
+    struct PageHeader {
+        uint16_t magic;
+        uint16_t record_size;
+        uint32_t seq;
+    };
+
+    struct PageInfo {
+        ///sequence number of the page
+        uint32_t seq = 0;
+        ///lowest timestamp on the page
+        uint32_t min_timestamp = 0;
+        ///highest timestamp on the page
+        uint32_t max_timestamp = 0;
+        ///used slots (including damaged)
+        uint16_t used = 0;
+        ///valid records
+        uint16_t records = 0;
+        ///page has valid header
+        bool valid = false;
+        ///page is erased, it can be opened without erase
+        bool erased = false;
+    };
+
+    static constexpr uint16_t magic = 0x4C45;
+    static constexpr unsigned int page_count = region_size / page_size;
+    ///record is followed by crc8
+    static constexpr unsigned int slot_size = sizeof(Record) + 1;
+    static constexpr unsigned int records_per_page = (page_size - sizeof(PageHeader)) / slot_size;
+    ///next page is prepared when count of free slots of current page drops to this value
+    static constexpr unsigned int prepare_margin = std::min(deferred_capacity, records_per_page - 1);
+
+    static_assert(page_count >= 2, "At least two pages are needed");
+    static_assert(records_per_page > 0, "Record is too large");
+
+    ///construct object
+    /** @param dev Reference to block device
+     *
+     * @note don't forget to call begin()!
+     */
+    constexpr EventLog(BlockDevice &dev):_flash_device(dev) {}
+
+    ///construct object
+    /** uses current instance of block device
+     *
+     * @note don't forget to call begin()!
+     */
+    constexpr EventLog():EventLog(BlockDevice::getInstance()) {}
+
+    ///Mount the log, build index of pages
+    /**
+     * @retval true success
+     * @retval false region is not formatted (it is blank or contains data
+     * which doesn't belong to the log). Call format() before the log is used,
+     * or repair() if the data are damaged log pages
+     */
+    bool begin() {
+        bool ok = true;
+        _cur_page = page_count;
+        for (PageIndex p = 0; p < page_count; ++p) {
+            if (!scan_page(p)) {
+                ok = false;
+            } else if (_pages[p].valid && (_cur_page == page_count
+                    || static_cast<int32_t>(_pages[p].seq - _pages[_cur_page].seq) > 0)) {
+                _cur_page = p;
+            }
+        }
+        return ok && _cur_page != page_count;
+    }
+
+    ///Erase whole log
+    /**
+     * The first page receives header, so the region is recognized as formatted
+     */
+    void format() {
+        for (PageIndex p = 1; p < page_count; ++p) {
+            _flash_device.erase(page_addr(p), page_size);
+            _pages[p] = {};
+            _pages[p].erased = true;
+        }
+        open_page(0, 1);
+    }
+
+    ///Erase pages which don't belong to the log
+    /**
+     * Page whose erase or header was interrupted by power failure is not
+     * recognized by begin(). Only such pages are erased, records of other
+     * pages are kept. If no page of the log remains, the log is started
+     * on the first page
+     */
+    void repair() {
+        for (PageIndex p = 0; p < page_count; ++p) {
+            if (_pages[p].valid || _pages[p].erased) continue;
+            _flash_device.erase(page_addr(p), page_size);
+            _pages[p] = {};
+            _pages[p].erased = true;
+        }
+        if (_cur_page == page_count) open_page(0, 1);
+    }
+
+    ///Append record
+    /**
+     * @param rec record to append
+     *
+     * @note if the current page is full, the oldest page is erased, unless
+     * it was already erased by prepare()
+     */
+    void append(const Record &rec) {
+        if (_cur_page == page_count) {
+            open_page(0, 1);
+        } else if (_pages[_cur_page].used >= records_per_page) {
+            open_page((_cur_page + 1) % page_count, _pages[_cur_page].seq + 1);
+        }
+        PageInfo &pi = _pages[_cur_page];
+        char slot[slot_size];
+        memcpy(slot, &rec, sizeof(Record));
+        slot[sizeof(Record)] = static_cast<char>(calc_crc(slot));
+        _flash_device.program(slot, slot_addr(_cur_page, pi.used), slot_size);
+        ++pi.used;
+        update_index(pi, rec.timestamp);
+    }
+
+    ///current page is almost full and the next page is not erased yet
+    constexpr bool is_prepare_pending() const {
+        if (_cur_page == page_count) return false;
+        return _pages[_cur_page].used + prepare_margin >= records_per_page
+                && !_pages[(_cur_page + 1) % page_count].erased;
+    }
+
+    ///Erase the oldest page before it is needed
+    /**
+     * Call it when the application is idle, so append() doesn't need to
+     * wait for the erase. Records of the oldest page are dropped a little
+     * earlier
+     *
+     * @retval true page has been erased
+     * @retval false nothing to do
+     */
+    bool prepare() {
+        if (!is_prepare_pending()) return false;
+        PageIndex p = (_cur_page + 1) % page_count;
+        _flash_device.erase(page_addr(p), page_size);
+        _pages[p] = {};
+        _pages[p].erased = true;
+        return true;
+    }
+
+    ///Hold record until the clock is synchronized
+    /**
+     * @param rec record, its timestamp is relative (it is corrected by commit_deferred())
+     * @retval true record is held
+     * @retval false no space, record is dropped (counted by get_dropped_count())
+     */
+    bool defer(const Record &rec) {
+        if (_deferred_count == deferred_capacity) {
+            ++_dropped;
+            return false;
+        }
+        _deferred[_deferred_count++] = rec;
+        return true;
+    }
+
+    ///Write held records
+    /**
+     * @param offset value added to timestamps of held records
+     */
+    void commit_deferred(uint32_t offset) {
+        for (unsigned int i = 0; i < _deferred_count; ++i) {
+            Record rec = _deferred[i];
+            rec.timestamp += offset;
+            append(rec);
+        }
+        _deferred_count = 0;
+    }
+
+    ///count of records held until the clock is synchronized
+    constexpr unsigned int get_deferred_count() const {return _deferred_count;}
+    ///count of records dropped because the clock was not synchronized
+    constexpr unsigned int get_dropped_count() const {return _dropped;}
+
+    ///Read records newer than given timestamp
+    /**
+     * Records are reported from the oldest page to the newest page, in
+     * order of writing. Pages having no newer records are not read
+     *
+     * @param since only records with timestamp greater than this value are reported
+     * @param fn function bool(const Record &). Returns false to stop
+     * @return count of reported records
+     */
+    template<typename Fn>
+    unsigned int read_since(uint32_t since, Fn &&fn) {
+        static_assert(std::is_invocable_r_v<bool, Fn, const Record &>, "bool(const Record &)");
+        unsigned int cnt = 0;
+        if (_cur_page == page_count) return cnt;
+        for (unsigned int i = 1; i <= page_count; ++i) {
+            PageIndex p = (_cur_page + i) % page_count;
+            const PageInfo &pi = _pages[p];
+            if (!pi.valid || !pi.records || pi.max_timestamp <= since) continue;
+            //one slot at time, the stack is small
+            char slot[slot_size];
+            for (unsigned int k = 0; k < pi.used; ++k) {
+                _flash_device.read(slot, slot_addr(p, k), slot_size);
+                if (static_cast<uint8_t>(slot[sizeof(Record)]) != calc_crc(slot)) continue;
+                Record rec;
+                memcpy(&rec, slot, sizeof(Record));
+                if (rec.timestamp > since) {
+                    ++cnt;
+                    if (!fn(rec)) return cnt;
+                }
+            }
+        }
+        return cnt;
+    }
+
+    ///retrieve information about page
+    constexpr const PageInfo &get_page_info(unsigned int page) const {
+        return _pages[page];
+    }
+
+    ///count of valid records in the log
+    constexpr unsigned int get_record_count() const {
+        unsigned int cnt = 0;
+        for (const auto &pi: _pages) cnt += pi.valid?pi.records:0;
+        return cnt;
+    }
+
+    ///count of records which fit into the log
+    static constexpr unsigned int capacity() {
+        return records_per_page * page_count;
+    }
+
+protected:
+
+    BlockDevice &_flash_device;
+    PageInfo _pages[page_count] = {};
+    PageIndex _cur_page = page_count;
+    uint8_t _deferred_count = 0;
+    uint16_t _dropped = 0;
+    Record _deferred[deferred_capacity] = {};
+
+    static_assert(deferred_capacity < 256);
+
+    static constexpr unsigned int page_addr(PageIndex p) {
+        return static_cast<unsigned int>(p) * page_size;
+    }
+
+    static constexpr unsigned int slot_addr(PageIndex p, unsigned int k) {
+        return page_addr(p) + sizeof(PageHeader) + k * slot_size;
+    }
+
+    static constexpr bool is_blank(const char *data, unsigned int size) {
+        for (unsigned int i = 0; i < size; ++i) if (data[i] != '\xFF') return false;
+        return true;
+    }
+
+    static constexpr uint8_t calc_crc(const char *slot) {
+        uint8_t crc = 0;
+        for (unsigned int i = 0; i < sizeof(Record); ++i) {
+            uint8_t b = static_cast<uint8_t>(slot[i]);
+            for (int j = 0; j < 8; ++j) {
+                uint8_t mix = (crc ^ b) & 1;
+                crc >>= 1;
+                if (mix) crc ^= 0x8C;
+                b >>= 1;
+            }
+        }
+        return crc;
+    }
+
+    static constexpr void update_index(PageInfo &pi, uint32_t timestamp) {
+        if (!pi.records || timestamp < pi.min_timestamp) pi.min_timestamp = timestamp;
+        if (!pi.records || timestamp > pi.max_timestamp) pi.max_timestamp = timestamp;
+        ++pi.records;
+    }
+
+    ///Read page and build its index
+    /**
+     * @retval true page is blank or belongs to the log
+     * @retval false page contains foreign data
+     */
+    bool scan_page(PageIndex p) {
+        //read by small pieces, the stack is small
+        char slot[slot_size];
+        PageInfo &pi = _pages[p];
+        pi = {};
+        PageHeader hdr;
+        _flash_device.read(&hdr, page_addr(p), sizeof(hdr));
+        if (is_blank(reinterpret_cast<const char *>(&hdr), sizeof(hdr))) {
+            for (unsigned int pos = sizeof(hdr); pos < page_size; pos += slot_size) {
+                unsigned int sz = std::min(slot_size, page_size - pos);
+                _flash_device.read(slot, page_addr(p) + pos, sz);
+                if (!is_blank(slot, sz)) return false;
+            }
+            pi.erased = true;
+            return true;
+        }
+        if (hdr.magic != magic || hdr.record_size != sizeof(Record)) return false;
+        pi.seq = hdr.seq;
+        pi.valid = true;
+        for (unsigned int k = 0; k < records_per_page; ++k) {
+            _flash_device.read(slot, slot_addr(p, k), slot_size);
+            if (is_blank(slot, slot_size)) break;
+            ++pi.used;
+            if (static_cast<uint8_t>(slot[sizeof(Record)]) == calc_crc(slot)) {
+                Record rec;
+                memcpy(&rec, slot, sizeof(Record));
+                update_index(pi, rec.timestamp);
+            }
+        }
+        return true;
+    }
+
+    ///Erase page (if not erased) and start new sequence on it
+    void open_page(PageIndex p, uint32_t seq) {
+        if (!_pages[p].erased) _flash_device.erase(page_addr(p), page_size);
+        PageHeader hdr{magic, static_cast<uint16_t>(sizeof(Record)), seq};
+        _flash_device.program(&hdr, page_addr(p), sizeof(hdr));
+        _pages[p] = {};
+        _pages[p].seq = seq;
+        _pages[p].valid = true;
+        _cur_page = p;
+    }
+};
@@ -46,7 +46,52 @@ public:
 
     static constexpr SectorIndex invalid_sector = ~SectorIndex{};
 
+    ///file number reserved for checkpoint sector
+    static constexpr FileNr checkpoint_file_nr = 0x7F;
+    ///file number reserved for fragments of multi-sector files (and padding)
+    static constexpr FileNr fragment_file_nr = 0x7E;
+    ///file number reserved for sector with page erase counters
+    static constexpr FileNr wear_file_nr = 0x7D;
+    ///count of bits needed to store sector index in checkpoint
+    static constexpr unsigned int checkpoint_sector_bits = []{
+        unsigned int b = 1;
+        while ((1U << b) <= total_sectors) ++b;
+        return b;
+    }();
+    ///sector index + flag of multi-sector file
+    static constexpr unsigned int checkpoint_entry_bits = checkpoint_sector_bits + 1;
+    ///size of checkpoint data: sequence (2), free page (1), directory
+    static constexpr unsigned int checkpoint_size = 3 + (directory_size * checkpoint_entry_bits + 7) / 8;
+    ///checkpoint is written only if directory fits into one sector
+    static constexpr bool checkpoint_enabled = checkpoint_size <= sector_data_size;
+    ///count of bits of each erase counter in the wear sector (after 2 bytes of sequence)
+    static constexpr unsigned int wear_counter_bits = []{
+        unsigned int b = (sector_data_size - 2) * 8 / page_count;
+        return b < 24?b:24;
+    }();
+    ///erase counters are persisted only if they are large enough
+    static constexpr bool wear_enabled = wear_counter_bits >= 16;
+    ///checkpoint sectors reserved at the beginning of each page
+    static constexpr unsigned int checkpoint_sectors = checkpoint_enabled?1:0;
+    ///sectors reserved at the beginning of each page (checkpoint, wear)
+    static constexpr unsigned int reserved_sectors = checkpoint_sectors + (wear_enabled?1:0);
+
     static_assert(directory_size <= total_sectors - 2*sectors_per_page, "Files must be less than available sectors minus two pages (two pages are reserved)");
+    static_assert(directory_size < wear_file_nr, "The last three file numbers are reserved");
+
+    ///maximum count of fragments of multi-sector file
+    /**
+     * The marker sector contains count of fragments and index of
+     * each fragment (2 bytes). All fragments and the marker must fit into
+     * one page
+     */
+    static constexpr unsigned int max_fragments = []{
+        unsigned int n = (sector_data_size - 1) / 2;
+        unsigned int p = sectors_per_page - reserved_sectors - 1;
+        return n < p?n:p;
+    }();
+    ///maximum size of a file
+    static constexpr unsigned int max_file_size = max_fragments * sector_data_size;
 
     struct Sector {
         HeaderType header;
@@ -54,6 +99,11 @@ public:
         constexpr Sector() {
             for (char &x: data) x = '\xFF';
         }
+        constexpr bool is_blank() const {
+            if (!header.is_free_sector() || header.crc8 != 0xFF) return false;
+            for (char x: data) if (x != '\xFF') return false;
+            return true;
+        }
         template<typename T>
         operator T() const {
             static_assert(sizeof(T) <= sizeof(data));
@@ -62,8 +112,25 @@ public:
 
     };
 
+    static_assert(sizeof(Sector) == sector_size);
+
+    ///sector is valid sector of this storage (helps to recognize layout of the flash)
+    /**
+     * @return true if the sector belongs to a file, or it is a fragment,
+     * checkpoint or wear sector, and its crc is valid
+     */
+    static constexpr bool is_valid_sector(const Sector &s) {
+        if (s.header.is_free_sector()) return false;
+        FileNr fnr = s.header.get_file_nr();
+        return (fnr < directory_size || fnr >= wear_file_nr)
+                && s.header.crc8 == calc_crc_sector(s);
+    }
+
     struct FileInfo {
+        ///sector of the file (marker sector for multi-sector file)
         SectorIndex sector = invalid_sector;
+        ///file spans multiple sectors
+        bool multi = false;
     };
 
 
@@ -90,27 +157,36 @@ public:
     }
 
     ///rescan flash device and build file allocation table
+    /**
+     * Uses the newest checkpoint if available (reads first sector of each
+     * page and the page where the checkpoint is). Falls back to full scan
+     * if there is no valid checkpoint
+     */
     void rescan() {
+        if constexpr(checkpoint_enabled) {
+            if (mount_checkpoint()) return;
+        }
+        full_rescan();
+    }
 
-        PageIndex free_page = page_count;
-        //probe each page
-        for (SectorIndex i = 0; i < total_sectors; i+=sectors_per_page) {
-            FlashAddr addr = sector_2_addr(i);
-            uint8_t b = 0;
-            _flash_device.read(&b, addr, sizeof(b));
-            if (b == 0xFF) {
-                //found empty page
-                free_page = sector_2_page(i);
-                break;
-            }
+    ///rescan whole flash device and build file allocation table
+    /**
+     * Ignores directory of checkpoints, reads all pages. Sequence of the
+     * checkpoint at the beginning of a page is used only to order pages.
+     */
+    void full_rescan() {
 
-        }
+        PageIndex free_page = page_count;
         //track area of each file
         uint8_t files_area[directory_size];
+        //checkpoint sequence of the page of each file (if the page has checkpoint)
+        uint16_t files_seq[directory_size];
+        bool files_has_seq[directory_size];
         //erase directory
         for (unsigned int i = 0; i < directory_size; ++i) {
             files_area[i] = 0xFF;
-            _files[i].sector = invalid_sector;
+            files_has_seq[i] = false;
+            _files[i] = {};
         }
 
         //invalidate head pointer
@@ -120,38 +196,73 @@ public:
 
         //we starting at area 1
         uint8_t area = 1;
-
-        //scan whole EEPROM
-        for (SectorIndex i = 0; i < total_sectors; ++i) {
-            Sector s = read_sector(i);
-            //it is free sector
-            if (s.header.is_free_sector()) {
-                //if we not found head yet
-                if (head == total_sectors) {
-                    //this is our head
-                    head = i;
-                    ++area;
-                }
-            } else {
-                second_head = i + 1;
-                //check crc
-                if (s.header.crc8 == calc_crc_sector(s)) {
-                    //take file number
-                    FileNr fnr = s.header.get_file_nr();
-                    //take tombstone flag
-                    bool ts = s.header.is_tombstone();
-                    //fnr range and area, if we are in the same or better area
-                    if (fnr < directory_size && files_area[fnr] >= area) {
-                        //update area
-                        files_area[fnr] = area;
-                        //update directory
-                        _files[fnr].sector = ts?invalid_sector:i;
+        //newest checkpoint sequence
+        bool has_checkpoint = false;
+        uint16_t checkpoint_seq = 0;
+        //newest wear sector
+        bool has_wear = false;
+
+        //scan whole EEPROM, page by page
+        for (PageIndex p = 0; p < page_count; ++p) {
+            //sequence of checkpoint at the beginning of the page
+            bool page_has_seq = false;
+            uint16_t page_seq = 0;
+            scan_page(p, [&](SectorIndex i, const Sector &s) {
+                //it is free sector
+                if (s.header.is_free_sector()) {
+                    //found empty page
+                    if (i == page_2_sector(p) && free_page == page_count) {
+                        free_page = p;
+                    }
+                    //if we not found head yet
+                    if (head == total_sectors) {
+                        //this is our head
+                        head = i;
+                        ++area;
                     }
                 } else {
-                    //update crc error counter
-                    ++_crc_errors;
+                    second_head = i + 1;
+                    //check crc
+                    if (s.header.crc8 == calc_crc_sector(s)) {
+                        //take file number
+                        FileNr fnr = s.header.get_file_nr();
+                        //pages with checkpoint are ordered by its sequence (the free
+                        //page can be out of order after interrupted defragmentation)
+                        bool newer = fnr < directory_size && (page_has_seq && files_has_seq[fnr]
+                                ?static_cast<int16_t>(page_seq - files_seq[fnr]) >= 0
+                                //area, if we are in the same or better area
+                                :files_area[fnr] >= area);
+                        if (newer) {
+                            //update area
+                            files_area[fnr] = area;
+                            files_seq[fnr] = page_seq;
+                            files_has_seq[fnr] = page_has_seq;
+                            //update directory
+                            update_directory(fnr, i, s);
+                        } else if (is_checkpoint(s)) {
+                            //track sequence, so next checkpoint will be newer
+                            uint16_t seq = get_checkpoint_seq(s);
+                            if (i == page_2_sector(p)) {
+                                page_has_seq = true;
+                                page_seq = seq;
+                            }
+                            if (!has_checkpoint || static_cast<int16_t>(seq - checkpoint_seq) > 0) {
+                                checkpoint_seq = seq;
+                                has_checkpoint = true;
+                            }
+                        } else if (is_wear_sector(s)) {
+                            if (!has_wear || static_cast<int16_t>(get_checkpoint_seq(s) - _wear_seq) > 0) {
+                                load_wear_sector(s);
+                                has_wear = true;
+                            }
+                        }
+                    } else {
+                        //update crc error counter
+                        ++_crc_errors;
+                    }
                 }
-            }
+                return true;
+            });
         }
 
         //no head found (no free sector)
@@ -167,7 +278,7 @@ public:
         } else if (free_page == page_count) {
             //assume that free page was not erased (power failure?)
             //set free page as page next to head sector
-            free_page = sector_2_page(calc_write_stop(head));
+            free_page = sector_2_page(calc_write_stop(head)) % page_count;
         } else {
             //if free_page is zero, the head is zero as well.
             //if second_head is valid, then we use second head as our head
@@ -176,23 +287,57 @@ public:
             }
         }
 
-        //ensure that free page is erased
-        erase_page(free_page);
         //save  write position
         _write_pos = head;
         _free_page = free_page;
+        _checkpoint_seq = checkpoint_seq;
+        //ensure that free page is erased
+        prepare_free_page();
+    }
+
+    ///Enable deferred erase
+    /**
+     * When enabled, the page released by defragmentation is not erased
+     * immediately. The erase is postponed until flush_erase() is called,
+     * or until the page is needed (next defragmentation). This allows
+     * to move the blocking erase operation to the time, when the
+     * application is idle
+     *
+     * @param enable true to enable, false to disable (default)
+     */
+    void set_deferred_erase(bool enable) {
+        _deferred_erase = enable;
+        if (!enable) flush_erase();
+    }
+
+    ///returns true, if there is a page waiting to be erased
+    constexpr bool is_erase_pending() const {
+        return _erase_pending;
+    }
+
+    ///Perform pending erase
+    /**
+     * @retval true page has been erased
+     * @retval false nothing to erase
+     */
+    bool flush_erase() {
+        if (!_erase_pending) return false;
+        erase_page(_free_page);
+        _erase_pending = false;
+        return true;
     }
 
     ///read file
     /**
      * @param id id of file
-     * @param out_data structure into data are placed
+     * @param out_data structure into data are placed. If the structure
+     * is larger than sector, the file must be written as multi-sector file
      * @retval true success
-     * @retval false not found
+     * @retval false not found, or file was written with different size
      */
     template<typename T>
      bool read_file(unsigned int id, T &out_data) {
-        static_assert(sizeof(T) <= sector_data_size && std::is_trivially_copy_constructible_v<T>);
+        static_assert(sizeof(T) <= max_file_size && std::is_trivially_copy_constructible_v<T>);
         if (id >= total_files) return false;
         //find file in file table
         FileInfo &f = _files[id];
@@ -202,19 +347,36 @@ public:
         Sector s = read_sector(f.sector);
         if (s.header.crc8 != calc_crc_sector(s)) { //bad crc - flash is corrupted, rescan
             ++_crc_errors;
-            rescan();
+            full_rescan();
             return read_file(id, out_data);
         }
-        //extract data
-        out_data = *reinterpret_cast<const T *>(s.data);
+        if (s.header.get_file_nr() != id || is_deleted(s)) { //directory is corrupted
+            full_rescan();
+            return read_file(id, out_data);
+        }
+        if constexpr(sizeof(T) > sector_data_size) {
+            //multi-sector file, collect fragments
+            if (!is_marker(s)) return false;
+            alignas(T) char buffer[sizeof(T)];
+            if (!read_fragments(s, buffer, sizeof(T))) return false;
+            out_data = *reinterpret_cast<const T *>(buffer);
+        } else {
+            if (is_marker(s)) return false;
+            //extract data
+            out_data = *reinterpret_cast<const T *>(s.data);
+        }
         return true;
     }
 
     ///write file
     /**
      * @param id file identifier
-     * @param out_data data to write. The size of data is limited to sector size - 2.
-     * If sector_size is 32, you can write 30 bytes per file.
+     * @param out_data data to write. If the data fits into the sector
+     * (sector size - 2), the file is written as one sector. Larger data
+     * are split into fragments followed by a marker sector, which is
+     * written last. Until the marker is written, the previous revision
+     * remains valid, so the update is all-or-nothing. Size is limited
+     * by max_file_size
      *
      * @note unused space is left uninitalized
      *
@@ -223,14 +385,18 @@ public:
      */
     template<typename T>
      bool write_file(unsigned int id, const T &data) {
-        static_assert(sizeof(T) <= sector_data_size && std::is_trivially_copy_constructible_v<T>);
-        //create new sector
-        Sector s;
-        s.header.set_file_nr_and_flag(id, false);
-        //copy data
-        memcpy(s.data, &data, sizeof(T));
-        //write
-        return write_file_sector(s);
+        static_assert(sizeof(T) <= max_file_size && std::is_trivially_copy_constructible_v<T>);
+        if constexpr(sizeof(T) > sector_data_size) {
+            return write_multi_sector(id, &data, sizeof(T));
+        } else {
+            //create new sector
+            Sector s;
+            s.header.set_file_nr_and_flag(id, false);
+            //copy data
+            memcpy(s.data, &data, sizeof(T));
+            //write
+            return write_file_sector(s);
+        }
     }
 
     ///Update file
@@ -248,13 +414,24 @@ public:
 
     template<typename T>
     bool update_file(unsigned int id, const T &data) {
-        static_assert(sizeof(T) <= sector_data_size && std::is_trivially_copy_constructible_v<T>);
+        static_assert(sizeof(T) <= max_file_size && std::is_trivially_copy_constructible_v<T>);
         //id out of range
         if (id >= total_files) return false;
 
         auto cur_sector = _files[id].sector;
+        if constexpr(sizeof(T) > sector_data_size) {
+            //multi-sector file - compare all fragments
+            if (cur_sector != invalid_sector && _files[id].multi) {
+                Sector cur = read_sector(cur_sector);
+                char buffer[sizeof(T)];
+                if (cur.header.crc8 == calc_crc_sector(cur) && is_marker(cur)
+                        && read_fragments(cur, buffer, sizeof(T))
+                        && memcmp(buffer, &data, sizeof(T)) == 0) {
+                    return true;
+                }
+            }
         //file must exists
-        if (cur_sector != invalid_sector) {
+        } else if (cur_sector != invalid_sector && !_files[id].multi) {
             //read current sector
             Sector cur = read_sector(cur_sector);
             //must have valid crc
@@ -333,6 +510,36 @@ public:
         return _crc_errors;
     }
 
+    ///retrieve count of erases of given page
+    /**
+     * @param page page index
+     * @return count of erases. The counters are persisted in a reserved sector
+     * written during defragmentation, so they survive restart (erases
+     * performed after last defragmentation can be lost on power failure)
+     */
+    constexpr uint32_t get_page_erase_count(unsigned int page) const {
+        return page < page_count?_erase_counts[page]:0;
+    }
+
+    ///retrieve count of writes of given file since begin()
+    constexpr uint32_t get_file_write_count(unsigned int id) const {
+        return id < total_files?_file_writes[id]:0;
+    }
+
+    ///count of sectors requested by write operations since begin()
+    constexpr uint32_t get_logical_writes() const {
+        return _logical_writes;
+    }
+
+    ///count of sectors actually programmed since begin()
+    /**
+     * Includes defragmentation, checkpoints, padding and markers. The
+     * ratio physical/logical is the write amplification
+     */
+    constexpr uint32_t get_physical_writes() const {
+        return _physical_writes;
+    }
+
     ///Erase file - so file appears erased
     /**
      * @param id file number
@@ -384,10 +591,11 @@ public:
             erase_page(i);
         }
         for (unsigned int i = 0; i < directory_size; ++i) {
-            _files[i].sector = invalid_sector;
+            _files[i] = {};
         }
         _write_pos = 0;
         _free_page = 0;
+        _erase_pending = false;
     }
 
 protected:
@@ -398,7 +606,15 @@ protected:
     PageIndex _free_page;
 
     bool _error = false;
+    uint16_t _checkpoint_seq = 0;
+    bool _deferred_erase = false;
+    bool _erase_pending = false;
     unsigned int _crc_errors = 0;
+    uint16_t _wear_seq = 0;
+    uint32_t _erase_counts[page_count] = {};
+    uint32_t _file_writes[total_files] = {};
+    uint32_t _logical_writes = 0;
+    uint32_t _physical_writes = 0;
 
     ///Reads sector
      Sector read_sector(SectorIndex idx) {
@@ -420,7 +636,7 @@ protected:
      *
      * @return index of unused page or -1 if this process failed
      */
-     constexpr PageIndex select_unused_page() const {
+     PageIndex select_unused_page() {
          //the first strategy - mark every page which contains file/active sector
         bool page_map[page_count] = {};
         //process all files
@@ -430,13 +646,24 @@ protected:
                 PageIndex idx = f.sector / sectors_per_page;
                 //mark page
                 page_map[idx] = true;
+                //mark pages of fragments
+                if (f.multi) {
+                    Sector m = read_sector(f.sector);
+                    if (m.header.crc8 == calc_crc_sector(m) && is_marker(m)) {
+                        for (unsigned int k = 0; k < get_fragment_count(m); ++k) {
+                            SectorIndex fs = get_fragment(m, k);
+                            if (fs < total_sectors) page_map[sector_2_page(fs)] = true;
+                        }
+                    }
+                }
             }
         }
-        //find page which has no mark
+        //find page which has no mark, prefer the least worn page
+        PageIndex best = page_count;
         for (PageIndex i = 0; i < page_count; ++i) {
-            //this is our page
-            if (!page_map[i]) return i;
+            if (!page_map[i] && (best == page_count || _erase_counts[i] < _erase_counts[best])) best = i;
         }
+        if (best != page_count) return best;
         //TODO: second strategy, find page which is backed by other pages
 
         //fail save - select last page as free (something will be erased)
@@ -451,6 +678,7 @@ protected:
      void erase_page(PageIndex index) {
         FlashAddr addr = static_cast<FlashAddr>(index) * page_size;
         _flash_device.erase(addr, page_size);
+        ++_erase_counts[index];
     }
 
     ///Append sector
@@ -464,6 +692,7 @@ protected:
      SectorIndex append_sector(const Sector &s) {
          SectorIndex idx = _write_pos;
         ++_write_pos;
+        ++_physical_writes;
         write_sector(idx, s);
         return idx;
     }
@@ -500,73 +729,458 @@ protected:
         FileInfo &f = _files[id];
         //upda
         s.header.crc8 = calc_crc_sector(s);
-        //check whether current write position is at stop index
-        //if does, defragmentation is needed
-        if (_write_pos == calc_write_stop(_write_pos)) {
-            //contains next page to erase
-            auto nx_page = _free_page;
-            //contains count of files/active sectors on that page
-            unsigned int files_on_page = 0;
-            //contains index of first sector
-            SectorIndex nx_sect_beg = 0;
-            //contains index of last sector + 1
-            SectorIndex nx_sect_end = 0;
-            do {
-                files_on_page = 0;
-                //move to next page
-                nx_page = (nx_page + 1) % page_count;
-                //check whether we tested all pages - then error
-                if (nx_page == _free_page) return false;
-                //calculate beg and end
-                nx_sect_beg = page_2_sector(nx_page);
-                nx_sect_end = nx_sect_beg + sectors_per_page;
-                //enumerate all files and count how many are
-                for (FileNr x = 0; x < directory_size; ++x) if (x != id) {
-                    //take sector index
-                    SectorIndex xs = _files[x].sector;
-                    //if sector index is in range, increase counter
-                    files_on_page += (xs >= nx_sect_beg && xs < nx_sect_end)?1:0;
-                }
-                //if we filled whole page, we cannot use this page, find another
-            } while (files_on_page >= sectors_per_page);
-            //so we have selected new page
-            //we can update _write_pos
-            _write_pos = page_2_sector(_free_page);
-            //write the sector to the _free_page
+        ++_file_writes[id];
+        ++_logical_writes;
+        return write_sectors(id, 1, [&]{
             f.sector = append_sector(s);
+            f.multi = false;
+            //if tombstone writen, erase file, otherwise store its position
+            if (s.header.is_tombstone()) f.sector = invalid_sector;
+        });
+    }
 
-            if (files_on_page > 0) {
-                //copy all other files from next free page to current _free page
-                for (FileNr x = 0; x < directory_size; ++x) if (x != id) {
-                    SectorIndex &xs = _files[x].sector;
-                    if (xs >= nx_sect_beg && xs < nx_sect_end) {
-                        //read sector
-                        Sector ss = read_sector(xs);
-                        if (ss.header.crc8 != calc_crc_sector(ss)) {
-                            ++_crc_errors;
-                        } else {
-                            //copy sector
-                            xs = append_sector(ss);
-                        }
-                    }
-                }
-            }
-            //next free page is no longer needed we copied everything relevant
-            //this is now out _free_page
-            _free_page = nx_page;
-            //erase it
-            erase_page(_free_page);
-        } else {
-            //no defragmentation, just write sector
-            f.sector = append_sector(s);
-        }
+     ///write multi-sector file
+     /**
+      * Writes fragments and then the marker sector, which contains
+      * indexes of the fragments. The directory is updated when the
+      * marker is written. All sectors are written to the same page
+      *
+      * @param id file id
+      * @param data pointer to data
+      * @param size size of data
+      * @retval true success
+      * @retval false failure
+      */
+     bool write_multi_sector(unsigned int id, const void *data, unsigned int size) {
+         if (id >= total_files) return false;
+         FileInfo &f = _files[id];
+         unsigned int count = (size + sector_data_size - 1) / sector_data_size;
+         ++_file_writes[id];
+         _logical_writes += count;
+         return write_sectors(static_cast<FileNr>(id), count + 1, [&]{
+             const char *src = reinterpret_cast<const char *>(data);
+             Sector m;
+             m.header.set_file_nr_and_flag(id, true);
+             m.data[0] = static_cast<char>(count);
+             for (unsigned int k = 0; k < count; ++k) {
+                 unsigned int offset = k * sector_data_size;
+                 unsigned int sz = size - offset;
+                 if (sz > sector_data_size) sz = sector_data_size;
+                 Sector fr;
+                 fr.header.set_file_nr_and_flag(fragment_file_nr, false);
+                 memcpy(fr.data, src + offset, sz);
+                 fr.header.crc8 = calc_crc_sector(fr);
+                 set_fragment(m, k, append_sector(fr));
+             }
+             m.header.crc8 = calc_crc_sector(m);
+             //commit
+             f.sector = append_sector(m);
+             f.multi = true;
+         });
+     }
 
-        //if tombstone writen, erase file, otherwise store its position
-        if (s.header.is_tombstone()) f.sector = invalid_sector;
-        //this is success
+     ///Write sequence of sectors to the current page, defragment if needed
+     /**
+      * @param id file being written. Its current sectors are not copied
+      * during defragmentation
+      * @param count count of sectors to write
+      * @param writer function which appends sectors. It is called once
+      * there is enough space in current page
+      * @retval true success
+      * @retval false failure, no space
+      */
+     template<typename Fn>
+     bool write_sectors(FileNr id, unsigned int count, Fn &&writer) {
+        //free page can't be prepared, writing would destroy data
+        if (_error) return false;
+        SectorIndex stop = calc_write_stop(_write_pos);
+        //if there is enough space, just write sectors
+        if (_write_pos + count <= stop) {
+            writer();
+            return true;
+        }
+        //fill rest of the page, so the pages are always written continuously
+        while (_write_pos < stop) append_sector(padding_sector());
+        //defragmentation is needed
+        //contains next page to erase
+        auto nx_page = _free_page;
+        do {
+            //move to next page
+            nx_page = (nx_page + 1) % page_count;
+            //check whether we tested all pages - then error
+            if (nx_page == _free_page) return false;
+            //if we filled whole page, we cannot use this page, find another
+        } while (live_sectors_on_page(nx_page, id) + reserved_sectors + count > sectors_per_page);
+        //so we have selected new page
+        //the free page must be erased before it is written
+        flush_erase();
+        //we can update _write_pos
+        _write_pos = page_2_sector(_free_page);
+        //store directory as first sector of the page (before it changes)
+        if constexpr(checkpoint_enabled) write_checkpoint(nx_page);
+        //store erase counters
+        if constexpr(wear_enabled) write_wear_sector();
+        //write the new sectors to the _free_page
+        writer();
+        //copy all other files from next free page to current _free page
+        move_live_sectors(nx_page, id);
+        //next free page is no longer needed we copied everything relevant
+        //this is now out _free_page
+        _free_page = nx_page;
+        //erase it (now or later)
+        _erase_pending = true;
+        if (!_deferred_erase) flush_erase();
         return true;
     }
 
+     ///Calculates how many sectors must be moved when page is released
+     /**
+      * @param page page index
+      * @param skip file which is not counted
+      * @return count of sectors. Multi-sector file having any sector on the
+      * page is counted whole (it is moved whole)
+      */
+     unsigned int live_sectors_on_page(PageIndex page, FileNr skip) {
+         SectorIndex beg = page_2_sector(page);
+         SectorIndex end = beg + sectors_per_page;
+         unsigned int cnt = 0;
+         for (FileNr x = 0; x < directory_size; ++x) if (x != skip) {
+             SectorIndex xs = _files[x].sector;
+             bool touch = xs >= beg && xs < end;
+             if (_files[x].multi && xs != invalid_sector) {
+                 Sector m = read_sector(xs);
+                 if (m.header.crc8 == calc_crc_sector(m) && is_marker(m)) {
+                     unsigned int n = get_fragment_count(m);
+                     for (unsigned int k = 0; k < n; ++k) {
+                         SectorIndex fs = get_fragment(m, k);
+                         touch = touch || (fs >= beg && fs < end);
+                     }
+                     if (touch) cnt += n;
+                 }
+             }
+             cnt += touch?1:0;
+         }
+         return cnt;
+     }
+
+     ///Moves all active sectors from the page to the write position
+     /**
+      * @param page page index
+      * @param skip file which is not moved
+      * @param stop files which would be written beyond this sector are not moved
+      */
+     void move_live_sectors(PageIndex page, FileNr skip, SectorIndex stop = total_sectors) {
+         SectorIndex beg = page_2_sector(page);
+         SectorIndex end = beg + sectors_per_page;
+         for (FileNr x = 0; x < directory_size; ++x) if (x != skip) {
+             SectorIndex &xs = _files[x].sector;
+             bool touch = xs >= beg && xs < end;
+             if (xs == invalid_sector || (!touch && !_files[x].multi)) continue;
+             Sector ss = read_sector(xs);
+             if (ss.header.crc8 != calc_crc_sector(ss)) {
+                 if (touch) ++_crc_errors;
+                 continue;
+             }
+             if (_files[x].multi && is_marker(ss)) {
+                 unsigned int n = get_fragment_count(ss);
+                 for (unsigned int k = 0; k < n && !touch; ++k) {
+                     SectorIndex fs = get_fragment(ss, k);
+                     touch = fs >= beg && fs < end;
+                 }
+                 if (!touch || _write_pos + n + 1 > stop) continue;
+                 //move fragments, then write new marker
+                 for (unsigned int k = 0; k < n; ++k) {
+                     set_fragment(ss, k, append_sector(read_sector(get_fragment(ss, k))));
+                 }
+                 ss.header.crc8 = calc_crc_sector(ss);
+                 xs = append_sector(ss);
+             } else if (touch && _write_pos < stop) {
+                 //copy sector
+                 xs = append_sector(ss);
+             }
+         }
+     }
+
+     ///Reads content of multi-sector file
+     /**
+      * @param marker marker sector
+      * @param buffer output buffer
+      * @param size size of the buffer, must match to count of fragments
+      * @retval true success
+      * @retval false size doesn't match or fragment is corrupted
+      */
+     bool read_fragments(const Sector &marker, char *buffer, unsigned int size) {
+         unsigned int n = get_fragment_count(marker);
+         if (n != (size + sector_data_size - 1) / sector_data_size) return false;
+         Sector fragments[max_fragments];
+         unsigned int k = 0;
+         while (k < n) {
+             //fragments are usually written continuously, read them in one operation
+             SectorIndex first = get_fragment(marker, k);
+             unsigned int run = 1;
+             while (k + run < n && get_fragment(marker, k + run) == first + run
+                     && sector_2_page(first + run) == sector_2_page(first)) ++run;
+             _flash_device.read(fragments + k, sector_2_addr(first), run * sector_size);
+             k += run;
+         }
+         for (k = 0; k < n; ++k) {
+             const Sector &fr = fragments[k];
+             if (fr.header.crc8 != calc_crc_sector(fr) || fr.header.file_nr_flag != fragment_file_nr) {
+                 ++_crc_errors;
+                 return false;
+             }
+             unsigned int offset = k * sector_data_size;
+             unsigned int sz = size - offset;
+             if (sz > sector_data_size) sz = sector_data_size;
+             memcpy(buffer + offset, fr.data, sz);
+         }
+         return true;
+     }
+
+     ///Update directory from valid sector
+     void update_directory(FileNr fnr, SectorIndex idx, const Sector &s) {
+         _files[fnr].sector = is_deleted(s)?invalid_sector:idx;
+         _files[fnr].multi = is_marker(s);
+     }
+
+     ///Marker of multi-sector file has tombstone flag and count of fragments
+     static constexpr bool is_marker(const Sector &s) {
+         return s.header.is_tombstone() && static_cast<uint8_t>(s.data[0]) != 0xFF;
+     }
+
+     ///Deleted file - tombstone without fragments
+     static constexpr bool is_deleted(const Sector &s) {
+         return s.header.is_tombstone() && static_cast<uint8_t>(s.data[0]) == 0xFF;
+     }
+
+     static constexpr unsigned int get_fragment_count(const Sector &s) {
+         unsigned int n = static_cast<uint8_t>(s.data[0]);
+         return n < max_fragments?n:max_fragments;
+     }
+
+     static constexpr SectorIndex get_fragment(const Sector &s, unsigned int k) {
+         return static_cast<SectorIndex>(static_cast<uint8_t>(s.data[1 + 2 * k])
+                 | (static_cast<uint8_t>(s.data[2 + 2 * k]) << 8));
+     }
+
+     static constexpr void set_fragment(Sector &s, unsigned int k, SectorIndex idx) {
+         s.data[1 + 2 * k] = static_cast<char>(idx & 0xFF);
+         s.data[2 + 2 * k] = static_cast<char>(idx >> 8);
+     }
+
+     ///Sector which fills unused space of a page
+     static constexpr Sector padding_sector() {
+         Sector s;
+         s.header.set_file_nr_and_flag(fragment_file_nr, false);
+         s.header.crc8 = calc_crc_sector(s);
+         return s;
+     }
+
+
+     ///Read whole page in one operation
+     /**
+      * @param page page index
+      * @param fn function called for each sector (SectorIndex, const Sector &).
+      * Function returns false to stop
+      */
+     template<typename Fn>
+     void scan_page(PageIndex page, Fn &&fn) {
+         alignas(Sector) char buffer[sectors_per_page * sector_size];
+         SectorIndex first = page_2_sector(page);
+         _flash_device.read(buffer, sector_2_addr(first), sizeof(buffer));
+         const Sector *sectors = reinterpret_cast<const Sector *>(buffer);
+         for (SectorIndex i = 0; i < sectors_per_page; ++i) {
+             if (!fn(static_cast<SectorIndex>(first + i), sectors[i])) break;
+         }
+     }
+
+     ///Checks whether free page is erased, if not, schedules erase
+     /**
+      * If the defragmentation was interrupted (power failure), the free page
+      * can still contain active sectors. They are moved to the current page
+      * before the free page is erased. Files which don't fit to the current
+      * page stay where they are, and other page without active sectors
+      * becomes the free page. The page is never erased while it holds the
+      * only copy of a file
+      */
+     void prepare_free_page() {
+         bool blank = is_page_blank(_free_page);
+         if (!blank) {
+             move_live_sectors(_free_page, directory_size, calc_write_stop(_write_pos));
+             if (live_sectors_on_page(_free_page, directory_size)) {
+                 PageIndex p = select_released_page();
+                 if (p == page_count) {
+                     //nothing can be erased safely, refuse to write
+                     _error = true;
+                     _erase_pending = false;
+                     return;
+                 }
+                 _free_page = p;
+                 blank = is_page_blank(p);
+             }
+         }
+         _erase_pending = !blank;
+         if (!_deferred_erase) flush_erase();
+     }
+
+     bool is_page_blank(PageIndex page) {
+         bool blank = true;
+         scan_page(page, [&](SectorIndex, const Sector &s) {
+             blank = s.is_blank();
+             return blank;
+         });
+         return blank;
+     }
+
+     ///Find page which holds no active sector, following the free page
+     /**
+      * The page of the last written sector is never selected
+      * @return index of page, or page_count if there is no such page
+      */
+     PageIndex select_released_page() {
+         PageIndex cur = sector_2_page((_write_pos + total_sectors - 1) % total_sectors);
+         for (PageIndex i = 1; i < page_count; ++i) {
+             PageIndex p = (_free_page + i) % page_count;
+             if (p != cur && !live_sectors_on_page(p, directory_size)) return p;
+         }
+         return page_count;
+     }
+
+     static constexpr bool is_checkpoint(const Sector &s) {
+         return s.header.file_nr_flag == checkpoint_file_nr;
+     }
+
+     static constexpr bool is_wear_sector(const Sector &s) {
+         return s.header.file_nr_flag == wear_file_nr;
+     }
+
+     ///Write sector with erase counters
+     void write_wear_sector() {
+         Sector s;
+         s.header.set_file_nr_and_flag(wear_file_nr, false);
+         ++_wear_seq;
+         s.data[0] = static_cast<char>(_wear_seq & 0xFF);
+         s.data[1] = static_cast<char>(_wear_seq >> 8);
+         for (unsigned int i = 2; i < sector_data_size; ++i) s.data[i] = 0;
+         constexpr uint32_t max_value = (1UL << wear_counter_bits) - 1;
+         for (unsigned int p = 0; p < page_count; ++p) {
+             uint32_t v = _erase_counts[p] < max_value?_erase_counts[p]:max_value;
+             unsigned int bitpos = 16 + p * wear_counter_bits;
+             for (unsigned int b = 0; b < wear_counter_bits; ++b, ++bitpos) {
+                 if (v & (1UL << b)) s.data[bitpos >> 3] |= static_cast<char>(1 << (bitpos & 7));
+             }
+         }
+         s.header.crc8 = calc_crc_sector(s);
+         append_sector(s);
+     }
+
+     ///Load erase counters from wear sector
+     void load_wear_sector(const Sector &s) {
+         _wear_seq = get_checkpoint_seq(s);
+         for (unsigned int p = 0; p < page_count; ++p) {
+             uint32_t v = 0;
+             unsigned int bitpos = 16 + p * wear_counter_bits;
+             for (unsigned int b = 0; b < wear_counter_bits; ++b, ++bitpos) {
+                 if (s.data[bitpos >> 3] & (1 << (bitpos & 7))) v |= 1UL << b;
+             }
+             //keep erases counted since begin() (prepare_free_page)
+             if (v > _erase_counts[p]) _erase_counts[p] = v;
+         }
+     }
+
+     static constexpr uint16_t get_checkpoint_seq(const Sector &s) {
+         return static_cast<uint8_t>(s.data[0]) | (static_cast<uint8_t>(s.data[1]) << 8);
+     }
+
+     ///Write checkpoint sector
+     /**
+      * Checkpoint contains directory and index of page which will be free
+      * after current defragmentation. It is always the first sector of a page
+      *
+      * @param next_free index of next free page
+      */
+     void write_checkpoint(PageIndex next_free) {
+         Sector s;
+         s.header.set_file_nr_and_flag(checkpoint_file_nr, false);
+         ++_checkpoint_seq;
+         s.data[0] = static_cast<char>(_checkpoint_seq & 0xFF);
+         s.data[1] = static_cast<char>(_checkpoint_seq >> 8);
+         s.data[2] = static_cast<char>(next_free);
+         for (unsigned int i = 3; i < checkpoint_size; ++i) s.data[i] = 0;
+         for (unsigned int i = 0; i < directory_size; ++i) {
+             const FileInfo &f = _files[i];
+             unsigned int v = f.sector == invalid_sector?(1U << checkpoint_entry_bits) - 1
+                     :f.sector | (f.multi?1U << checkpoint_sector_bits:0);
+             unsigned int bitpos = 24 + i * checkpoint_entry_bits;
+             for (unsigned int b = 0; b < checkpoint_entry_bits; ++b, ++bitpos) {
+                 if (v & (1U << b)) s.data[bitpos >> 3] |= static_cast<char>(1 << (bitpos & 7));
+             }
+         }
+         s.header.crc8 = calc_crc_sector(s);
+         append_sector(s);
+     }
+
+     ///Mount using newest checkpoint
+     /**
+      * @retval true success
+      * @retval false no valid checkpoint, full scan is needed
+      */
+     bool mount_checkpoint() {
+         //checkpoint is always first sector of the page
+         PageIndex cp_page = page_count;
+         uint16_t cp_seq = 0;
+         Sector cp;
+         for (PageIndex p = 0; p < page_count; ++p) {
+             Sector s = read_sector(page_2_sector(p));
+             if (is_checkpoint(s) && s.header.crc8 == calc_crc_sector(s)) {
+                 uint16_t seq = get_checkpoint_seq(s);
+                 if (cp_page == page_count || static_cast<int16_t>(seq - cp_seq) > 0) {
+                     cp_page = p;
+                     cp_seq = seq;
+                     cp = s;
+                 }
+             }
+         }
+         if (cp_page == page_count) return false;
+         PageIndex free_page = static_cast<uint8_t>(cp.data[2]);
+         if (free_page >= page_count || free_page == cp_page) return false;
+         //load directory
+         for (unsigned int i = 0; i < directory_size; ++i) {
+             unsigned int v = 0;
+             unsigned int bitpos = 24 + i * checkpoint_entry_bits;
+             for (unsigned int b = 0; b < checkpoint_entry_bits; ++b, ++bitpos) {
+                 if (cp.data[bitpos >> 3] & (1 << (bitpos & 7))) v |= 1U << b;
+             }
+             unsigned int sect = v & ((1U << checkpoint_sector_bits) - 1);
+             if (sect < total_sectors) {
+                 _files[i].sector = static_cast<SectorIndex>(sect);
+                 _files[i].multi = (v >> checkpoint_sector_bits) != 0;
+             } else {
+                 _files[i] = {};
+             }
+         }
+         //replay sectors written after the checkpoint
+         SectorIndex head = page_2_sector(cp_page) + sectors_per_page;
+         scan_page(cp_page, [&](SectorIndex i, const Sector &s) {
+             if (s.header.is_free_sector()) {
+                 head = i;
+                 return false;
+             }
+             if (s.header.crc8 != calc_crc_sector(s)) {
+                 ++_crc_errors;
+             } else {
+                 FileNr fnr = s.header.get_file_nr();
+                 if (fnr < directory_size) update_directory(fnr, i, s);
+                 else if (is_wear_sector(s)) load_wear_sector(s);
+             }
+             return true;
+         });
+         _write_pos = head;
+         _free_page = free_page;
+         _checkpoint_seq = cp_seq;
+         prepare_free_page();
+         return true;
+     }
 
      static constexpr FlashAddr sector_2_addr(SectorIndex idx) {
          if constexpr(sector_size * sectors_per_page == page_size) {
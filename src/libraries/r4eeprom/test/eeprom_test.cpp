@@ -2,6 +2,10 @@
 #include "constexpr_check.h"
 #include "../generic_eeprom.h"
 
+#include <chrono>
+#include <cstring>
+#include <string_view>
+
 
 
 
@@ -16,6 +20,16 @@ public:
 
     int program(const void *buffer, std::size_t addr, std::size_t size) {
         CHECK_LESS_EQUAL(addr+size, sizeof(_data));
+        //simulate power failure - nothing is written after power is lost
+        if (_power_lost) return 0;
+        if (_power_budget >= 0 && static_cast<std::size_t>(_power_budget) < size) {
+            //torn write - only part of data reaches the flash
+            size = _power_budget;
+            _power_lost = true;
+        }
+        if (_power_budget >= 0) _power_budget -= size;
+        ++_programs;
+        _programmed_bytes += size;
         std::copy(reinterpret_cast<const char *>(buffer),
                 reinterpret_cast<const char *>(buffer)+size,
                 reinterpret_cast<char *>(_data)+addr);
@@ -23,6 +37,8 @@ public:
     }
     int read(void *buffer, std::size_t addr, std::size_t size) {
         CHECK_LESS_EQUAL(addr+size, sizeof(_data));
+        ++_reads;
+        _read_bytes += size;
         std::copy(_data+addr, _data+addr+size, reinterpret_cast<char *>(buffer));
         return 0;
     }
@@ -32,6 +48,13 @@ public:
         CHECK_EQUAL(size%1024,0);
         CHECK_GREATER(size,0);
         CHECK_LESS_EQUAL(addr+size, sizeof(_data));
+        if (_power_lost) return 0;
+        ++_erases;
+        if (_erase_cut >= 0 && _erase_cut-- == 0) {
+            //interrupted erase - only part of block is erased
+            size /= 2;
+            _power_lost = true;
+        }
         std::fill(reinterpret_cast<char *>(_data+addr),
                 reinterpret_cast<char *>(_data+addr)+size,
                 '\xFF');
@@ -40,6 +63,23 @@ public:
     }
 
     char _data[8192];
+    unsigned long _reads = 0;
+    unsigned long _read_bytes = 0;
+    unsigned long _programs = 0;
+    unsigned long _programmed_bytes = 0;
+    unsigned long _erases = 0;
+
+    ///count of bytes which can be programmed before power is lost (-1 unlimited)
+    long _power_budget = -1;
+    ///count of erases before erase is interrupted by power loss (-1 never)
+    long _erase_cut = -1;
+    bool _power_lost = false;
+
+    void power_on() {
+        _power_lost = false;
+        _power_budget = -1;
+        _erase_cut = -1;
+    }
 };
 
 template<unsigned int sector_size>
@@ -97,12 +137,12 @@ void test_3_files() {
         CHECK_EQUAL(c,canary);
 
         if constexpr(sector_size == 30) {
-            eeprom.list_revisions(2, [ctx = 9854](int x) mutable {
+            eeprom.list_revisions(2, [ctx = 9872](int x) mutable {
                 CHECK_EQUAL(ctx, x);
                 ctx = ctx + 2;
             });
         } else if constexpr(sector_size == 22) {
-            eeprom.list_revisions(2, [ctx = 9822](int x) mutable {
+            eeprom.list_revisions(2, [ctx = 9832](int x) mutable {
                 CHECK_EQUAL(ctx, x);
                 ctx = ctx + 2;
             });
@@ -118,13 +158,445 @@ void test_3_files() {
     }
 }
 
+template<unsigned int sector_size>
+void test_deferred_erase() {
+    EmulBlockDevice flash;
+    int erases_pending = 0;
+    for (int i = 0; i < 2000; i+=100) {
+        //remount every 100 writes, sometimes with pending erase
+        TestableEEProm<sector_size> eeprom(flash);
+        eeprom.begin();
+        eeprom.set_deferred_erase(true);
+        if (i) {
+            int x;
+            CHECK(eeprom.read_file(1, x));
+            CHECK_EQUAL(x, i-1);
+            CHECK(eeprom.read_file(2, x));
+            CHECK_EQUAL(x, -(i-1));
+        }
+        for (int j = i; j < i+100; ++j) {
+            eeprom.write_file(1, j);
+            eeprom.write_file(2, -j);
+            //erase while idle only sometimes, let the next defragmentation to erase
+            if (eeprom.is_erase_pending() && (j % 37) == 0) eeprom.flush_erase();
+        }
+        erases_pending += eeprom.is_erase_pending()?1:0;
+    }
+    CHECK_GREATER(erases_pending, 0);
+}
+
+template<unsigned int sector_size>
+void test_checkpoint_mount() {
+    EmulBlockDevice flash;
+    {
+        TestableEEProm<sector_size> eeprom(flash);
+        eeprom.begin();
+        for (int i = 0; i < 5000; ++i) {
+            int f = (i * 7) % 15;
+            if (f == 3 && (i % 2)) eeprom.erase_file(f);
+            else eeprom.write_file(f, i);
+        }
+    }
+    TestableEEProm<sector_size> cp(flash);
+    auto r1 = flash._reads;
+    auto b1 = flash._read_bytes;
+    cp.begin();
+    auto cp_reads = flash._reads - r1;
+    auto cp_bytes = flash._read_bytes - b1;
+
+    TestableEEProm<sector_size> full(flash);
+    r1 = flash._reads;
+    b1 = flash._read_bytes;
+    full.full_rescan();
+    auto full_reads = flash._reads - r1;
+    auto full_bytes = flash._read_bytes - b1;
+
+    //both must see same content
+    for (unsigned int f = 0; f < 15; ++f) {
+        int a = -1, b = -1;
+        bool ba = cp.read_file(f, a);
+        bool bb = full.read_file(f, b);
+        CHECK_EQUAL(ba, bb);
+        CHECK_EQUAL(a, b);
+    }
+
+    std::cout << "Benchmark mount (sector " << sector_size << "): checkpoint "
+            << cp_reads << " reads/" << cp_bytes << " bytes, full scan "
+            << full_reads << " reads/" << full_bytes << " bytes" << std::endl;
+    CHECK_LESS(cp_bytes, full_bytes);
+}
+
+struct BigFile {
+    int values[20];
+
+    BigFile(int v = 0) {
+        for (int &x: values) x = v;
+    }
+    bool is_consistent() const {
+        for (int x: values) if (x != values[0]) return false;
+        return true;
+    }
+};
+
+template<unsigned int sector_size>
+void test_multi_sector() {
+    EmulBlockDevice flash;
+    {
+        TestableEEProm<sector_size> eeprom(flash);
+        eeprom.begin();
+        for (int i = 0; i < 1000; ++i) {
+            eeprom.write_file(5, BigFile(i));
+            eeprom.write_file(1, i);
+            if (i % 3 == 0) eeprom.write_file(7, BigFile(-i));
+            if (i % 5 == 0) eeprom.write_file(2, -i);
+        }
+        BigFile bf;
+        CHECK(eeprom.read_file(5, bf));
+        CHECK(bf.is_consistent());
+        CHECK_EQUAL(bf.values[0], 999);
+        //file written as multi-sector can't be read as one sector
+        int x;
+        CHECK(!eeprom.read_file(5, x));
+        //same content, no write
+        CHECK(eeprom.update_file(5, BigFile(999)));
+    }
+    for (int m = 0; m < 2; ++m) {
+        TestableEEProm<sector_size> eeprom(flash);
+        if (m) eeprom.full_rescan(); else eeprom.begin();
+        BigFile bf;
+        CHECK(eeprom.read_file(5, bf));
+        CHECK(bf.is_consistent());
+        CHECK_EQUAL(bf.values[0], 999);
+        CHECK(eeprom.read_file(7, bf));
+        CHECK(bf.is_consistent());
+        CHECK_EQUAL(bf.values[0], -999);
+        int x;
+        CHECK(eeprom.read_file(1, x));
+        CHECK_EQUAL(x, 999);
+        CHECK(eeprom.read_file(2, x));
+        CHECK_EQUAL(x, -995);
+    }
+    //power failure during update - old or new revision must be read
+    for (int i = 1000; i < 1200; ++i) {
+        EmulBlockDevice copy = flash;
+        copy._power_budget = (i % 7) * (sector_size + 2) + (i % 3) * 5;
+        {
+            TestableEEProm<sector_size> eeprom(copy);
+            eeprom.begin();
+            eeprom.write_file(5, BigFile(i));
+        }
+        copy.power_on();
+        TestableEEProm<sector_size> eeprom(copy);
+        if (i & 1) eeprom.full_rescan(); else eeprom.begin();
+        BigFile bf;
+        CHECK(eeprom.read_file(5, bf));
+        CHECK(bf.is_consistent());
+        CHECK(bf.values[0] == i - 1 || bf.values[0] == i);
+        CHECK(eeprom.read_file(7, bf));
+        CHECK_EQUAL(bf.values[0], -999);
+        //continue with complete write
+        TestableEEProm<sector_size> ok(flash);
+        ok.begin();
+        ok.write_file(5, BigFile(i));
+    }
+}
+
+template<unsigned int sector_size>
+void test_wear_counters() {
+    EmulBlockDevice flash;
+    using EE = TestableEEProm<sector_size>;
+    uint32_t counts[EE::page_count];
+    {
+        EE eeprom(flash);
+        eeprom.begin();
+        for (int i = 0; i < 3000; ++i) {
+            eeprom.write_file(1, i);
+            if (i % 10 == 0) eeprom.write_file(2, BigFile(i));
+        }
+        CHECK_EQUAL(eeprom.get_file_write_count(1), 3000U);
+        CHECK_EQUAL(eeprom.get_file_write_count(2), 300U);
+        CHECK_GREATER_EQUAL(eeprom.get_physical_writes(), eeprom.get_logical_writes());
+        uint32_t mn = ~uint32_t{}, mx = 0;
+        for (unsigned int p = 0; p < EE::page_count; ++p) {
+            counts[p] = eeprom.get_page_erase_count(p);
+            mn = std::min(mn, counts[p]);
+            mx = std::max(mx, counts[p]);
+        }
+        CHECK_GREATER(mn, 0U);
+        CHECK_LESS_EQUAL(mx - mn, 1U);
+        std::cout << "Wear (sector " << sector_size << "): erases " << mn << "-" << mx
+                << " per page, write amplification "
+                << static_cast<double>(eeprom.get_physical_writes()) / eeprom.get_logical_writes()
+                << std::endl;
+    }
+    //counters are persisted, only erase after last defragmentation can be lost
+    for (int m = 0; m < 2; ++m) {
+        EE eeprom(flash);
+        if (m) eeprom.full_rescan(); else eeprom.begin();
+        uint32_t lost = 0;
+        for (unsigned int p = 0; p < EE::page_count; ++p) {
+            CHECK_LESS_EQUAL(eeprom.get_page_erase_count(p), counts[p]);
+            lost += counts[p] - eeprom.get_page_erase_count(p);
+        }
+        CHECK_LESS_EQUAL(lost, 1U);
+    }
+}
 
+///Cut power at many points of a workload, remount and verify
+/**
+ * Every file must contain either the last value written before power was
+ * lost, or the value being written when power was lost. The store must
+ * remain usable after recovery
+ */
+template<unsigned int sector_size>
+void test_power_failure() {
+    using EE = TestableEEProm<sector_size>;
+    constexpr int files = 5;
+    auto step = [](EE &eeprom, int s) {
+        int f = s % files;
+        if (f == files - 1) eeprom.write_file(f, BigFile(s));
+        else eeprom.write_file(f, s);
+    };
+    auto check_files = [](EE &eeprom, const int *committed, int inflight) {
+        for (int f = 0; f < files; ++f) {
+            int v = -1;
+            if (f == files - 1) {
+                BigFile bf;
+                CHECK(eeprom.read_file(f, bf));
+                CHECK(bf.is_consistent());
+                v = bf.values[0];
+            } else {
+                CHECK(eeprom.read_file(f, v));
+            }
+            CHECK(v == committed[f] || (inflight % files == f && v == inflight));
+        }
+    };
 
+    //prepare store, so defragmentation happens during test
+    EmulBlockDevice base;
+    int base_committed[files];
+    {
+        EE eeprom(base);
+        eeprom.begin();
+        for (int s = 0; s < 200; ++s) {
+            step(eeprom, s);
+            base_committed[s % files] = s;
+        }
+    }
 
-int main() {
+    int cuts = 0;
+    for (int trial = 0; trial < 400; ++trial) {
+        EmulBlockDevice flash = base;
+        if (trial % 4 == 3) flash._erase_cut = (trial / 4) % 3;
+        else flash._power_budget = trial * 29;
+        int committed[files];
+        std::copy(std::begin(base_committed), std::end(base_committed), committed);
+        int inflight = -1;
+        {
+            EE eeprom(flash);
+            eeprom.begin();
+            for (int s = 200; s < 400 && !flash._power_lost; ++s) {
+                step(eeprom, s);
+                if (flash._power_lost) inflight = s;
+                else committed[s % files] = s;
+            }
+        }
+        if (!flash._power_lost) continue;
+        ++cuts;
+        flash.power_on();
+        {
+            EmulBlockDevice copy = flash;
+            EE eeprom(copy);
+            eeprom.full_rescan();
+            check_files(eeprom, committed, inflight);
+        }
+        EE eeprom(flash);
+        eeprom.begin();
+        check_files(eeprom, committed, inflight);
+        //continue writing after recovery
+        for (int s = 400; s < 500; ++s) {
+            step(eeprom, s);
+            committed[s % files] = s;
+        }
+        EE remounted(flash);
+        remounted.begin();
+        check_files(remounted, committed, -1);
+    }
+    CHECK_GREATER(cuts, 300);
+}
+
+///Power failure during defragmentation of a full page
+/**
+ * The released page contains so many files that the rest of them doesn't
+ * fit to the current page, when copying of a multi-sector file was
+ * interrupted. The released page must not be erased until all its files
+ * are copied
+ */
+template<unsigned int sector_size>
+void test_interrupted_defragmentation() {
+    using EE = TestableEEProm<sector_size>;
+    constexpr int big_files = 5;
+    constexpr int files = 12;
+    constexpr int churn = 14;
+    auto check_files = [](EE &eeprom, int committed, int inflight) {
+        for (int f = 0; f < files; ++f) {
+            int v = -1;
+            if (f < big_files) {
+                BigFile bf;
+                CHECK(eeprom.read_file(f, bf));
+                CHECK(bf.is_consistent());
+                v = bf.values[0];
+            } else {
+                CHECK(eeprom.read_file(f, v));
+            }
+            CHECK_EQUAL(v, f + 1000);
+        }
+        int v = -1;
+        CHECK(eeprom.read_file(churn, v));
+        CHECK(v == committed || v == inflight);
+    };
+    //files which are never updated take 27 sectors - with checkpoint, wear sector
+    //and the written file, they exactly fill the page during defragmentation
+    EmulBlockDevice base;
+    {
+        EE eeprom(base);
+        eeprom.begin();
+        for (int f = 0; f < files; ++f) {
+            if (f < big_files) eeprom.write_file(f, BigFile(f + 1000));
+            else eeprom.write_file(f, f + 1000);
+        }
+        eeprom.write_file(churn, 0);
+    }
+    constexpr int steps = EE::total_sectors + EE::sectors_per_page;
+    int cuts = 0;
+    for (long budget = 0; budget < static_cast<long>(steps * sector_size); budget += 11) {
+        EmulBlockDevice flash = base;
+        flash._power_budget = budget;
+        int committed = 0;
+        int inflight = -1;
+        {
+            EE eeprom(flash);
+            eeprom.begin();
+            for (int s = 1; s < steps && !flash._power_lost; ++s) {
+                eeprom.write_file(churn, s);
+                if (flash._power_lost) inflight = s;
+                else committed = s;
+            }
+        }
+        if (!flash._power_lost) continue;
+        ++cuts;
+        //recovery is interrupted again
+        for (int r = 0; r < 3; ++r) {
+            flash.power_on();
+            flash._power_budget = static_cast<long>(sector_size) * (r + 2) + 3;
+            EE eeprom(flash);
+            eeprom.begin();
+        }
+        flash.power_on();
+        {
+            EmulBlockDevice copy = flash;
+            EE eeprom(copy);
+            eeprom.full_rescan();
+            check_files(eeprom, committed, inflight);
+        }
+        {
+            EE eeprom(flash);
+            eeprom.begin();
+            CHECK(!eeprom.is_error());
+            check_files(eeprom, committed, inflight);
+            for (int s = steps; s < 2 * steps; ++s) {
+                eeprom.write_file(churn, s);
+                committed = s;
+            }
+        }
+        EE remounted(flash);
+        remounted.begin();
+        check_files(remounted, committed, -1);
+    }
+    CHECK_GREATER(cuts, 0);
+}
+
+///Simulates traffic of the controller's Storage
+/**
+ * 11 files, 20 bytes each, 6 pages. Runtime counters are updated
+ * every minute, other files less often. Pending erase is flushed when
+ * idle (as Storage::commit_step() does)
+ *
+ * @param minutes simulated minutes
+ */
+void benchmark_storage_traffic(unsigned int minutes) {
+    struct File20 {
+        uint32_t v[5] = {};
+    };
+    using StorageEEProm = EEPROM<20, 11, 1024, 6144, EmulBlockDevice>;
+    EmulBlockDevice flash;
+    StorageEEProm eeprom(flash);
+    eeprom.begin();
+    eeprom.set_deferred_erase(true);
+    File20 files[11];
+    for (unsigned int i = 0; i < 11; ++i) eeprom.write_file(i, files[i]);
+    auto programs = flash._programmed_bytes;
+    auto erases = flash._erases;
+    auto logical = eeprom.get_logical_writes();
+    unsigned long updates = 0;
+    auto update = [&](unsigned int id, uint32_t minute) {
+        files[id].v[minute % 5] += 1;
+        eeprom.update_file(id, files[id]);
+        ++updates;
+    };
+    //device checks would print for every access, mute them while measuring
+    auto *out = std::cout.rdbuf(nullptr);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t m = 0; m < minutes; ++m) {
+        update(2, m);                       //runtime
+        update(4, m);                       //runtime2
+        if (m % 3 == 0) update(1, m);       //tray
+        if (m % 7 == 0) update(3, m);       //counters1
+        if (m % 30 == 0) update(9, m);      //counters2
+        if (m % 1440 == 0) update(0, m);    //config
+        eeprom.flush_erase();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout.rdbuf(out);
+    std::cout.clear();
+    auto prog_bytes = flash._programmed_bytes - programs;
+    auto erase_cnt = flash._erases - erases;
+    auto logical_writes = eeprom.get_logical_writes() - logical;
+    uint32_t mx = 0;
+    for (unsigned int p = 0; p < StorageEEProm::page_count; ++p) mx = std::max(mx, eeprom.get_page_erase_count(p));
+
+    std::cout << "Benchmark storage traffic (" << minutes << " minutes): "
+            << updates << " updates, "
+            << static_cast<unsigned long>(updates / (elapsed > 0?elapsed:1e-9)) << " ops/s, "
+            << static_cast<double>(prog_bytes) / logical_writes << " bytes programmed per logical write, "
+            << erase_cnt * 1000.0 / updates << " erases per 1000 updates, "
+            << "max page erases " << mx << std::endl;
+    CHECK_GREATER(updates, 0UL);
+    CHECK_GREATER_EQUAL(prog_bytes, logical_writes * StorageEEProm::sector_size);
+}
+
+
+int main(int argc, char **argv) {
+    if (argc > 1 && std::string_view(argv[1]) == "bench") {
+        //one year of traffic
+        benchmark_storage_traffic(365*24*60);
+        return 0;
+    }
     test_3_files<32>();
     test_3_files<30>();
     test_3_files<22>();
+    test_deferred_erase<22>();
+    test_checkpoint_mount<32>();
+    test_checkpoint_mount<30>();
+    test_checkpoint_mount<22>();
+    test_multi_sector<32>();
+    test_multi_sector<22>();
+    test_wear_counters<32>();
+    test_wear_counters<22>();
+    test_power_failure<32>();
+    test_power_failure<22>();
+    test_interrupted_defragmentation<32>();
+    benchmark_storage_traffic(7*24*60);
 
 
 
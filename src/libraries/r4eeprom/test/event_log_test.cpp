@@ -0,0 +1,240 @@
+#include "check.h"
+#include "../event_log.h"
+#include "../block_device_partition.h"
+
+#include <algorithm>
+
+
+class EmulBlockDevice {
+public:
+
+    EmulBlockDevice() {
+        std::fill(std::begin(_data), std::end(_data), '\xFF');
+    }
+
+    static constexpr std::size_t get_erase_size() {return 1024;}
+
+    int program(const void *buffer, std::size_t addr, std::size_t size) {
+        CHECK_LESS_EQUAL(addr+size, sizeof(_data));
+        std::copy(reinterpret_cast<const char *>(buffer),
+                reinterpret_cast<const char *>(buffer)+size,
+                reinterpret_cast<char *>(_data)+addr);
+        return 0;
+    }
+    int read(void *buffer, std::size_t addr, std::size_t size) {
+        CHECK_LESS_EQUAL(addr+size, sizeof(_data));
+        ++_reads;
+        std::copy(_data+addr, _data+addr+size, reinterpret_cast<char *>(buffer));
+        return 0;
+    }
+
+    int erase(std::size_t addr, std::size_t size) {
+        CHECK_EQUAL(addr%1024,0);
+        CHECK_EQUAL(size%1024,0);
+        CHECK_LESS_EQUAL(addr+size, sizeof(_data));
+        std::fill(_data+addr, _data+addr+size, '\xFF');
+        ++_erases;
+        return 0;
+    }
+
+    char _data[8192];
+    unsigned long _reads = 0;
+    unsigned long _erases = 0;
+};
+
+struct TestRecord {
+    uint32_t timestamp;
+    uint32_t value;
+};
+
+using Partition = BlockDevicePartition<EmulBlockDevice, 6144, 2048>;
+using TestLog = EventLog<TestRecord, 1024, 2048, Partition>;
+
+void test_format() {
+    EmulBlockDevice flash;
+    Partition part(flash);
+    {
+        TestLog log(part);
+        //blank region is not formatted
+        CHECK(!log.begin());
+        log.format();
+    }
+    {
+        TestLog log(part);
+        CHECK(log.begin());
+        CHECK_EQUAL(log.get_record_count(), 0U);
+    }
+    //foreign data in the region
+    flash._data[6144+1024] = 0x12;
+    {
+        TestLog log(part);
+        CHECK(!log.begin());
+    }
+    //nothing written outside of the partition
+    CHECK(std::all_of(flash._data, flash._data+6144, [](char c){return c == '\xFF';}));
+}
+
+void test_append_and_query() {
+    EmulBlockDevice flash;
+    Partition part(flash);
+    constexpr unsigned int total = 500;
+    {
+        TestLog log(part);
+        log.begin();
+        log.format();
+        for (unsigned int i = 0; i < total; ++i) {
+            log.append({i / 3 + 1, i});
+        }
+    }
+    TestLog log(part);
+    CHECK(log.begin());
+    unsigned int cnt = log.get_record_count();
+    CHECK_GREATER(cnt, TestLog::records_per_page);
+    CHECK_LESS_EQUAL(cnt, TestLog::capacity());
+
+    //all records, ordered
+    uint32_t expected = total - cnt;
+    log.read_since(0, [&](const TestRecord &r) {
+        CHECK_EQUAL(r.value, expected);
+        CHECK_EQUAL(r.timestamp, r.value / 3 + 1);
+        ++expected;
+        return true;
+    });
+    CHECK_EQUAL(expected, total);
+
+    //only newer records, only the newest page is read
+    uint32_t since = (total - 10) / 3;
+    auto r1 = flash._reads;
+    unsigned int found = log.read_since(since, [&](const TestRecord &r) {
+        CHECK_GREATER(r.timestamp, since);
+        return true;
+    });
+    CHECK_LESS_EQUAL(flash._reads - r1, static_cast<unsigned long>(TestLog::records_per_page));
+    CHECK_EQUAL(found, total - (since * 3));
+
+    //nothing newer - no read
+    r1 = flash._reads;
+    CHECK_EQUAL(log.read_since(total, [](const TestRecord &) {return true;}), 0U);
+    CHECK_EQUAL(flash._reads - r1, 0UL);
+
+    //stop early
+    found = log.read_since(0, [n = 0](const TestRecord &) mutable {return ++n < 5;});
+    CHECK_EQUAL(found, 5U);
+}
+
+void test_deferred() {
+    EmulBlockDevice flash;
+    Partition part(flash);
+    TestLog log(part);
+    log.begin();
+    log.format();
+    //clock is not synchronized yet, timestamps are uptime
+    CHECK(log.defer({2, 1}));
+    CHECK(log.defer({5, 2}));
+    CHECK_EQUAL(log.get_deferred_count(), 2U);
+    CHECK_EQUAL(log.get_record_count(), 0U);
+    CHECK_EQUAL(log.read_since(0, [](const TestRecord &) {return true;}), 0U);
+    //clock is synchronized
+    constexpr uint32_t offset = 1000000;
+    log.commit_deferred(offset);
+    CHECK_EQUAL(log.get_deferred_count(), 0U);
+    log.append({offset + 10, 3});
+    uint32_t expected = 1;
+    log.read_since(0, [&](const TestRecord &r) {
+        CHECK_EQUAL(r.value, expected);
+        CHECK_GREATER(r.timestamp, offset);
+        ++expected;
+        return true;
+    });
+    CHECK_EQUAL(expected, 4U);
+    //index is not spoiled by uptime timestamps
+    CHECK_EQUAL(log.get_page_info(0).min_timestamp, offset + 2);
+    CHECK_EQUAL(log.read_since(offset + 4, [](const TestRecord &) {return true;}), 2U);
+    //queue is limited
+    for (unsigned int i = 0; i < 8; ++i) CHECK(log.defer({i, i}));
+    CHECK(!log.defer({9, 9}));
+    CHECK_EQUAL(log.get_dropped_count(), 1U);
+}
+
+void test_prepare() {
+    EmulBlockDevice flash;
+    Partition part(flash);
+    uint32_t n = 0;
+    auto append = [&](TestLog &log) {
+        log.append({n + 1, n});
+        ++n;
+    };
+    {
+        TestLog log(part);
+        log.begin();
+        log.format();
+        //page is prepared when the application is idle, append never erases
+        while (n < 3 * TestLog::capacity() || !log.is_prepare_pending()) {
+            auto e = flash._erases;
+            append(log);
+            CHECK_EQUAL(flash._erases, e);
+            if (log.is_prepare_pending() && n < 3 * TestLog::capacity()) {
+                CHECK(log.prepare());
+                CHECK(!log.is_prepare_pending());
+            }
+        }
+        CHECK(log.prepare());
+        CHECK(!log.prepare());
+        //oldest page was dropped before the current page is full
+        CHECK_EQUAL(log.get_record_count(), TestLog::records_per_page - TestLog::prepare_margin);
+    }
+    //erased page is recognized after restart, it is opened without erase
+    TestLog log(part);
+    CHECK(log.begin());
+    CHECK(!log.is_prepare_pending());
+    auto e = flash._erases;
+    for (unsigned int i = 0; i < TestLog::records_per_page; ++i) append(log);
+    CHECK_EQUAL(flash._erases, e);
+    uint32_t expected = n - log.get_record_count();
+    log.read_since(0, [&](const TestRecord &r) {
+        CHECK_EQUAL(r.value, expected);
+        ++expected;
+        return true;
+    });
+    CHECK_EQUAL(expected, n);
+}
+
+void test_repair() {
+    EmulBlockDevice flash;
+    Partition part(flash);
+    uint32_t n = TestLog::records_per_page + 5;
+    {
+        TestLog log(part);
+        log.begin();
+        log.format();
+        for (uint32_t i = 0; i < n; ++i) log.append({i + 1, i});
+    }
+    //header of the second page was torn by power failure
+    flash._data[6144+1024+1] = 0x00;
+    TestLog log(part);
+    CHECK(!log.begin());
+    log.repair();
+    CHECK(log.get_page_info(1).erased);
+    //records of the first page are kept
+    CHECK_EQUAL(log.get_record_count(), TestLog::records_per_page);
+    log.append({n + 1, n});
+    TestLog log2(part);
+    CHECK(log2.begin());
+    CHECK_EQUAL(log2.get_record_count(), TestLog::records_per_page + 1);
+    //nothing usable, log is started again
+    std::fill(flash._data+6144, flash._data+6144+2048, '\x12');
+    TestLog log3(part);
+    CHECK(!log3.begin());
+    log3.repair();
+    CHECK(log3.begin());
+    CHECK_EQUAL(log3.get_record_count(), 0U);
+}
+
+int main() {
+    test_format();
+    test_append_and_query();
+    test_deferred();
+    test_prepare();
+    test_repair();
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "../r4ext/ModemBatch.h"
+
+#include "../r4ext/WifiTCP.h"
+
+#include "Modem.h"
+
+#include <cstdio>
+
+unsigned long ModemBatch::_round_trips = 0;
+
+ModemBatch::ModemBatch() {
+    modem.begin();
+}
+
+bool ModemBatch::command(const char *prompt, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    bool r = add(Reply::text, prompt, fmt, args);
+    va_end(args);
+    return r;
+}
+
+bool ModemBatch::binary_command(const char *prompt, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    bool r = add(Reply::binary, prompt, fmt, args);
+    va_end(args);
+    return r;
+}
+
+bool ModemBatch::add(Reply reply, const char *prompt, const char *fmt, va_list args) {
+    if (_sent || _count >= max_commands) return false;
+    va_list tmp;
+    va_copy(tmp, args);
+    int len = vsnprintf(_tx + _tx_len, tx_buffer_size - _tx_len, fmt, tmp);
+    va_end(tmp);
+    if (len < 0) return false;
+    if (static_cast<unsigned int>(len) >= tx_buffer_size - _tx_len) {
+        //doesn't fit, send commands already formatted and try again
+        if (_tx_len == 0) return false;
+        flush();
+        return add(reply, prompt, fmt, args);
+    }
+    _tx_len += len;
+    _commands[_count++] = {prompt, reply};
+    return true;
+}
+
+bool ModemBatch::data(const void *data, std::size_t size) {
+    if (_sent || _count == 0) return false;
+    //reply of send command has no prompt
+    _commands[_count-1].reply = Reply::status;
+    flush();
+    Serial2.write(reinterpret_cast<const uint8_t *>(data), size);
+    return true;
+}
+
+void ModemBatch::flush() {
+    if (_tx_len) {
+        Serial2.write(reinterpret_cast<const uint8_t *>(_tx), _tx_len);
+        _tx_len = 0;
+    }
+}
+
+bool ModemBatch::reply(std::string &res) {
+    res.clear();
+    if (!_sent) {
+        flush();
+        _sent = true;
+        ++_round_trips;
+    }
+    if (_next >= _count) return false;
+    const Command &cmd = _commands[_next++];
+    switch (cmd.reply) {
+        case Reply::status:
+            //nothing to send, waits for OK
+            return modem.passthrough(nullptr, 0);
+        case Reply::binary:
+            /* important - it works one shot */
+            modem.avoid_trim_results();
+            modem.read_using_size();
+            break;
+        default:
+            break;
+    }
+    //empty command - only reads the reply
+    return modem.write(WiFiUtils::modem_cmd(cmd.prompt), res, "");
+}
+
+bool ModemBatch::reply() {
+    return reply(WiFiUtils::modem_res());
+}
+
+void ModemBatch::reset() {
+    _tx_len = 0;
+    _count = 0;
+    _next = 0;
+    _sent = false;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdarg>
+#include <cstddef>
+#include <string>
+
+///Batch of AT commands sent to the modem in one exchange
+/**
+ * Commands are formatted to a fixed buffer and written to the UART
+ * together. Replies are then read one by one in order of commands,
+ * so the batch costs one round trip instead of one per command.
+ *
+ * @code
+ * ModemBatch batch;
+ * batch.binary_command(PROMPT(_CLIENTRECEIVE), "%s%d,%d\r\n", CMD_WRITE(_CLIENTRECEIVE), sock, size);
+ * batch.command(PROMPT(_AVAILABLE), "%s%d\r\n", CMD_WRITE(_AVAILABLE), sock);
+ * batch.reply(res);    //received data
+ * batch.reply(res);    //available after receive
+ * @endcode
+ *
+ * Every command must have its reply read before the batch is reset or
+ * destroyed, otherwise the reply would be read by next exchange
+ */
+class ModemBatch {
+public:
+
+    ///size of buffer for formatted commands
+    static constexpr unsigned int tx_buffer_size = 160;
+    ///max commands in one batch
+    static constexpr unsigned int max_commands = 4;
+
+    ModemBatch();
+    ModemBatch(const ModemBatch &) = delete;
+    ModemBatch &operator=(const ModemBatch &) = delete;
+
+    ///add command with text reply
+    /**
+     * @param prompt prompt of the reply
+     * @param fmt format of the command (printf)
+     * @retval true added
+     * @retval false batch is full
+     */
+    bool command(const char *prompt, const char *fmt, ...);
+    ///add command with binary reply (data prefixed by size)
+    bool binary_command(const char *prompt, const char *fmt, ...);
+    ///add raw data (payload of preceding send command)
+    /**
+     * The reply of the send command is only OK or ERROR
+     */
+    bool data(const void *data, std::size_t size);
+
+    ///read reply of next command
+    /**
+     * First call sends the commands
+     * @param res reply (without prompt)
+     * @retval true OK
+     * @retval false ERROR, timeout or no more commands
+     */
+    bool reply(std::string &res);
+    ///read reply of next command, only status
+    bool reply();
+
+    ///start new batch, all replies must be read
+    void reset();
+
+    ///count of exchanges (round trips) since start
+    static unsigned long round_trips() {return _round_trips;}
+
+protected:
+
+    enum class Reply: unsigned char {
+        text,
+        binary,
+        status
+    };
+
+    struct Command {
+        const char *prompt;
+        Reply reply;
+    };
+
+    char _tx[tx_buffer_size];
+    unsigned int _tx_len = 0;
+    Command _commands[max_commands] = {};
+    unsigned int _count = 0;
+    unsigned int _next = 0;
+    bool _sent = false;
+
+    static unsigned long _round_trips;
+
+    bool add(Reply reply, const char *prompt, const char *fmt, va_list args);
+    ///write formatted commands to the UART
+    void flush();
+};
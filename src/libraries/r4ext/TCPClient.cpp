@@ -1,5 +1,6 @@
 #include "../r4ext/TCPClient.h"
 
+#include "../r4ext/ModemBatch.h"
 #include "../r4ext/TCPServer.h"
 #include "../r4ext/WifiTCP.h"
 
@@ -13,9 +14,10 @@ using namespace std;
 
 
 TCPClient::TCPClient(TCPClient &&c) :
-        _sock(c._sock), _size(c._size - c._rdpos) {
+        _sock(c._sock), _size(c._size - c._rdpos), _pending(c._pending) {
     std::copy(c._buffer + c._rdpos, c._buffer + c._size, _buffer);
     c._sock = -1;
+    c._pending = 0;
     c.clear_buffer();
 }
 
@@ -25,7 +27,9 @@ TCPClient& TCPClient::operator=(TCPClient &&c) {
         _rdpos = 0;
         _size = c._size - c._rdpos;
         std::copy(c._buffer + c._rdpos, c._buffer + c._size, _buffer);
+        _pending = c._pending;
         c._size = c._rdpos = 0;
+        c._pending = 0;
         c._sock = -1;
     }
     return *this;
@@ -40,10 +44,11 @@ void TCPClient::getSocket() {
 
     if (_sock == -1) {
         string &res = WiFiUtils::modem_res();
-        modem.begin();
-        if (modem.write(WiFiUtils::modem_cmd(PROMPT(_BEGINCLIENT)), res, "%s",
-                CMD(_BEGINCLIENT))) {
+        ModemBatch batch;
+        batch.command(PROMPT(_BEGINCLIENT), "%s", CMD(_BEGINCLIENT));
+        if (batch.reply(res)) {
             _sock = atoi(res.c_str());
+            _pending = 0;
         }
     }
 }
@@ -53,29 +58,33 @@ int TCPClient::read_nb() {
     return -1;
 }
 
-int TCPClient::connect(IPAddress ip, uint16_t port) {
+int TCPClient::read_nb(uint8_t *buf, size_t size) {
+    size = std::min<std::size_t>(_size - _rdpos, size);
+    std::copy(_buffer + _rdpos, _buffer + _rdpos + size, buf);
+    _rdpos += size;
+    return size;
+}
 
-    return connect(ip.toString().c_str(), port);
+int TCPClient::connect(IPAddress ip, uint16_t port) {
+    char host[16];
+    snprintf(host, sizeof(host), "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
+    return connect(host, port);
 }
 
 int TCPClient::connect(const char *host, uint16_t port) {
     getSocket();
     if (_sock >= 0) {
-        string &res = WiFiUtils::modem_res();
-        modem.begin();
+        ModemBatch batch;
         if (connect_timeout) {
-            if (modem.write(WiFiUtils::modem_cmd(PROMPT(_CLIENTCONNECT)), res,
+            batch.command(PROMPT(_CLIENTCONNECT),
                     "%s%d,%s,%d,%d\r\n", CMD_WRITE(_CLIENTCONNECT), _sock, host,
-                    port, connect_timeout)) {
-                return 1;
-            }
+                    port, connect_timeout);
         } else {
-            if (modem.write(WiFiUtils::WiFiUtils::modem_cmd(PROMPT(_CLIENTCONNECTNAME)), res,
+            batch.command(PROMPT(_CLIENTCONNECTNAME),
                     "%s%d,%s,%d\r\n", CMD_WRITE(_CLIENTCONNECTNAME), _sock,
-                    host, port)) {
-                return 1;
-            }
+                    host, port);
         }
+        if (batch.reply()) return 1;
     }
     return 0;
 }
@@ -88,11 +97,11 @@ size_t TCPClient::write(uint8_t b) {
 size_t TCPClient::write(const uint8_t *buf, size_t size) {
 
     if (_sock >= 0) {
-        string &res = WiFiUtils::modem_res();
-        modem.begin();
-        modem.write_nowait(WiFiUtils::modem_cmd(PROMPT(_CLIENTSEND)), res, "%s%d,%d\r\n",
+        ModemBatch batch;
+        batch.command(PROMPT(_CLIENTSEND), "%s%d,%d\r\n",
                 CMD_WRITE(_CLIENTSEND), _sock, size);
-        if (modem.passthrough(buf, size)) {
+        batch.data(buf, size);
+        if (batch.reply()) {
             return size;
         } else {
             return 0;
@@ -102,6 +111,37 @@ size_t TCPClient::write(const uint8_t *buf, size_t size) {
 
 }
 
+unsigned int TCPClient::receive(uint8_t *buf, unsigned int size) {
+
+    string &res = WiFiUtils::modem_res();
+    ModemBatch batch;
+
+    if (_pending == 0) {
+        batch.command(PROMPT(_AVAILABLE), "%s%d\r\n", CMD_WRITE(_AVAILABLE), _sock);
+        if (!batch.reply(res)) return 0;
+        int rv = atoi(res.c_str());
+        if (rv <= 0) return 0;
+        _pending = rv;
+        batch.reset();
+    }
+
+    //receive what is waiting and ask for the rest in the same exchange
+    batch.binary_command(PROMPT(_CLIENTRECEIVE), "%s%d,%d\r\n",
+            CMD_WRITE(_CLIENTRECEIVE), _sock, std::min(_pending, size));
+    batch.command(PROMPT(_AVAILABLE), "%s%d\r\n", CMD_WRITE(_AVAILABLE), _sock);
+    unsigned int sz = 0;
+    if (batch.reply(res)) {
+        sz = std::min<std::size_t>(res.size(), size);
+        std::copy(res.begin(), res.begin() + sz, buf);
+    }
+    _pending = 0;
+    if (batch.reply(res)) {
+        int rv = atoi(res.c_str());
+        if (rv > 0) _pending = rv;
+    }
+    return sz;
+}
+
 int TCPClient::available() {
 
     if (_size > _rdpos)
@@ -109,27 +149,7 @@ int TCPClient::available() {
     if (_sock < 0)
         return 0;
     clear_buffer();
-
-    string &res = WiFiUtils::modem_res();
-    modem.begin();
-
-    if(modem.write(string(PROMPT(_AVAILABLE)),res, "%s%d\r\n" , CMD_WRITE(_AVAILABLE),_sock)) {
-       int rv = atoi(res.c_str());
-       if (rv <=0) {
-          return 0;
-       }
-    }
-
-
-    /* important - it works one shot */
-    modem.avoid_trim_results();
-    modem.read_using_size();
-    if (modem.write(WiFiUtils::modem_cmd(PROMPT(_CLIENTRECEIVE)), res, "%s%d,%d\r\n",
-            CMD_WRITE(_CLIENTRECEIVE), _sock, buffer_size)) {
-        std::copy(res.begin(), res.end(), _buffer);
-        _size = res.size();
-    }
-
+    _size = receive(reinterpret_cast<uint8_t *>(_buffer), buffer_size);
     return _size - _rdpos;
 }
 
@@ -143,6 +163,11 @@ int TCPClient::read() {
 }
 
 int TCPClient::read(uint8_t *buf, size_t size) {
+    if (_size == _rdpos && size >= buffer_size && _sock >= 0) {
+        //large read - receive directly to the caller's buffer
+        clear_buffer();
+        return receive(buf, std::min<std::size_t>(size, receive_ahead_size));
+    }
     size = std::min<std::size_t>(TCPClient::available(), size);
     if (size)
         std::copy(_buffer + _rdpos, _buffer + _rdpos + size, buf);
@@ -156,9 +181,9 @@ int TCPClient::peek() {
     int rv = -1;
     if (_sock >= 0) {
         string &res = WiFiUtils::modem_res();
-        modem.begin();
-        if (modem.write(WiFiUtils::modem_cmd(PROMPT(_PEEK)), res, "%s%d\r\n",
-                CMD_WRITE(_PEEK), _sock)) {
+        ModemBatch batch;
+        batch.command(PROMPT(_PEEK), "%s%d\r\n", CMD_WRITE(_PEEK), _sock);
+        if (batch.reply(res)) {
             rv = atoi(res.c_str());
         }
     }
@@ -168,36 +193,42 @@ int TCPClient::peek() {
 void TCPClient::flush() {
 
     if (_sock >= 0) {
-        string &res = WiFiUtils::modem_res();
-        modem.begin();
-        modem.write(WiFiUtils::modem_cmd(PROMPT(_CLIENTFLUSH)), res, "%s%d\r\n",
-                CMD_WRITE(_CLIENTFLUSH), _sock);
+        ModemBatch batch;
+        batch.command(PROMPT(_CLIENTFLUSH), "%s%d\r\n", CMD_WRITE(_CLIENTFLUSH), _sock);
+        batch.reply();
     }
 }
 
 void TCPClient::stop() {
 
     if (_sock >= 0) {
-        string &res = WiFiUtils::modem_res();
-        modem.begin();
-        modem.write(WiFiUtils::modem_cmd(PROMPT(_CLIENTCLOSE)), res, "%s%d\r\n",
-                CMD_WRITE(_CLIENTCLOSE), _sock);
+        ModemBatch batch;
+        batch.command(PROMPT(_CLIENTCLOSE), "%s%d\r\n", CMD_WRITE(_CLIENTCLOSE), _sock);
+        batch.reply();
         _sock = -1;
     }
+    _pending = 0;
     clear_buffer();
 }
 
 uint8_t TCPClient::connected() {
     uint8_t rv = 0;
-    if (available() > 0)
+    if (_size > _rdpos || _pending > 0)
         return 1;
     if (_sock >= 0) {
+        //both queries in one exchange
         string &res = WiFiUtils::modem_res();
-        modem.begin();
-        if (modem.write(WiFiUtils::modem_cmd(PROMPT(_CLIENTCONNECTED)), res, "%s%d\r\n",
-                CMD_WRITE(_CLIENTCONNECTED), _sock)) {
+        ModemBatch batch;
+        batch.command(PROMPT(_AVAILABLE), "%s%d\r\n", CMD_WRITE(_AVAILABLE), _sock);
+        batch.command(PROMPT(_CLIENTCONNECTED), "%s%d\r\n", CMD_WRITE(_CLIENTCONNECTED), _sock);
+        if (batch.reply(res)) {
+            int av = atoi(res.c_str());
+            if (av > 0) _pending = av;
+        }
+        if (batch.reply(res)) {
             rv = atoi(res.c_str());
         }
+        if (_pending) rv = 1;
     }
 
     return rv;
@@ -214,9 +245,9 @@ IPAddress TCPClient::remoteIP() {
     IPAddress ip;
     if (_sock >= 0) {
         string &res = WiFiUtils::modem_res();
-        modem.begin();
-        if (modem.write(WiFiUtils::modem_cmd(PROMPT(_REMOTEIP)), res, "%s%d\r\n",
-                CMD_WRITE(_REMOTEIP), _sock)) {
+        ModemBatch batch;
+        batch.command(PROMPT(_REMOTEIP), "%s%d\r\n", CMD_WRITE(_REMOTEIP), _sock);
+        if (batch.reply(res)) {
             ip.fromString(res.c_str());
             return ip;
         }
@@ -229,9 +260,9 @@ uint16_t TCPClient::remotePort() {
     uint16_t rv = 0;
     if (_sock >= 0) {
         string &res = WiFiUtils::modem_res();
-        modem.begin();
-        if (modem.write(WiFiUtils::modem_cmd(PROMPT(_REMOTEPORT)), res, "%s%d\r\n",
-                CMD_WRITE(_REMOTEPORT), _sock)) {
+        ModemBatch batch;
+        batch.command(PROMPT(_REMOTEPORT), "%s%d\r\n", CMD_WRITE(_REMOTEPORT), _sock);
+        if (batch.reply(res)) {
             rv = atoi(res.c_str());
             return rv;
         }
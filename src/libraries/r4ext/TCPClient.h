@@ -8,6 +8,8 @@
 class TCPClient : public arduino::Client {
 public:
     static constexpr unsigned int buffer_size = 256;
+    ///max size of data received directly to the caller's buffer (by read(buf, size))
+    static constexpr unsigned int receive_ahead_size = 1024;
 
   TCPClient() = default;
   TCPClient(int s):_sock(s) {}
@@ -34,6 +36,8 @@ public:
   uint16_t remotePort();
 
   int read_nb();
+  ///read only data already in the buffer, never asks the modem
+  int read_nb(uint8_t *buf, size_t size);
 
   static int connect_timeout;
 
@@ -41,7 +45,7 @@ public:
 
   using Print::write;
   void clear_buffer() {_size = 0;_rdpos = 0;}
-  void detach() {_sock = -1; clear_buffer();}
+  void detach() {_sock = -1; _pending = 0; clear_buffer();}
   bool empty_buffer() const {return _size == _rdpos;}
 
 protected:
@@ -49,8 +53,17 @@ protected:
   char _buffer[buffer_size] = {};
   unsigned int _size = 0;
   unsigned int _rdpos = 0;
+  ///bytes waiting in the modem (reported by last receive)
+  unsigned int _pending = 0;
 
   void getSocket();
+  ///receive data from the modem
+  /**
+   * If the modem is known to have data, receive and query for remaining
+   * data are sent in one exchange. Otherwise the modem is asked first
+   * @return count of received bytes
+   */
+  unsigned int receive(uint8_t *buf, unsigned int size);
 
 
 };
@@ -1,5 +1,6 @@
 #include "../r4ext/TCPServer.h"
 
+#include "../r4ext/ModemBatch.h"
 #include "../r4ext/WifiTCP.h"
 
 #include "WiFiCommands.h"
@@ -27,9 +28,10 @@ bool TCPServer::available(TCPClient &cl) {
 
    if(_sock != -1) {
       string &res = WiFiUtils::modem_res();
-      modem.begin();
+      ModemBatch batch;
       /* call the server available on esp so that the accept is performed */
-      if(modem.write(WiFiUtils::modem_cmd(PROMPT(_SERVERAVAILABLE)),res, "%s%d\r\n" , CMD_WRITE(_SERVERAVAILABLE), _sock)) {
+      batch.command(PROMPT(_SERVERAVAILABLE), "%s%d\r\n", CMD_WRITE(_SERVERAVAILABLE), _sock);
+      if(batch.reply(res)) {
          int client_sock = atoi(res.c_str());
          cl._sock = client_sock;
          return cl._sock >=0;
@@ -42,13 +44,15 @@ bool TCPServer::available(TCPClient &cl) {
 bool TCPServer::accept(TCPClient &cl) {
 /* -------------------------------------------------------------------------- */
    if(_sock != -1) {
-       string &res = WiFiUtils::modem_res();
-      modem.begin();
+      string &res = WiFiUtils::modem_res();
+      ModemBatch batch;
       /* call the server accept on esp so that the accept is performed */
-      if(modem.write(WiFiUtils::modem_cmd(PROMPT(_SERVERACCEPT)),res, "%s%d\r\n" , CMD_WRITE(_SERVERACCEPT), _sock)) {
+      batch.command(PROMPT(_SERVERACCEPT), "%s%d\r\n", CMD_WRITE(_SERVERACCEPT), _sock);
+      if(batch.reply(res)) {
           int client_sock = atoi(res.c_str());
           if (client_sock >= 0) {
               cl._sock = client_sock;
+              cl._pending = 0;
               cl.clear_buffer();
               return true;
           } else {
@@ -63,9 +67,10 @@ bool TCPServer::accept(TCPClient &cl) {
 void TCPServer::begin(int port) {
 /* -------------------------------------------------------------------------- */
    if(_sock == -1) {
-       string &res = WiFiUtils::modem_res();
-      modem.begin();
-      if(modem.write(WiFiUtils::modem_cmd(PROMPT(_BEGINSERVER)),res, "%s%d\r\n" , CMD_WRITE(_BEGINSERVER), port)) {
+      string &res = WiFiUtils::modem_res();
+      ModemBatch batch;
+      batch.command(PROMPT(_BEGINSERVER), "%s%d\r\n", CMD_WRITE(_BEGINSERVER), port);
+      if(batch.reply(res)) {
          _sock = atoi(res.c_str());
       }
    }
@@ -89,10 +94,10 @@ size_t TCPServer::write(uint8_t b){
 size_t TCPServer::write(const uint8_t *buf, size_t size) {
 /* -------------------------------------------------------------------------- */
    if(_sock >= 0) {
-       string &res = WiFiUtils::modem_res();
-      modem.begin();
-      modem.write_nowait(WiFiUtils::modem_cmd(PROMPT(_SERVERWRITE)),res, "%s%d,%d\r\n" , CMD_WRITE(_SERVERWRITE), _sock, size);
-      if(modem.passthrough(buf,size)) {
+      ModemBatch batch;
+      batch.command(PROMPT(_SERVERWRITE), "%s%d,%d\r\n", CMD_WRITE(_SERVERWRITE), _sock, size);
+      batch.data(buf, size);
+      if(batch.reply()) {
          return size;
       }
 
@@ -104,9 +109,9 @@ size_t TCPServer::write(const uint8_t *buf, size_t size) {
 void TCPServer::end() {
 /* -------------------------------------------------------------------------- */
    if(_sock != -1) {
-       string &res = WiFiUtils::modem_res();
-      modem.begin();
-      modem.write(WiFiUtils::modem_cmd(PROMPT(_SERVEREND)),res, "%s%d\r\n" , CMD_WRITE(_SERVEREND), _sock);
+      ModemBatch batch;
+      batch.command(PROMPT(_SERVEREND), "%s%d\r\n", CMD_WRITE(_SERVEREND), _sock);
+      batch.reply();
       _sock = -1;
    }
 }
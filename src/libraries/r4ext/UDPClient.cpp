@@ -1,11 +1,13 @@
 #include "../r4ext/UDPClient.h"
 
+#include "../r4ext/ModemBatch.h"
 #include "../r4ext/WifiTCP.h"
 
 #include "WiFiCommands.h"
 #include "WiFiTypes.h"
 #include "Modem.h"
 
+#include <algorithm>
 
 
 using namespace std;
@@ -14,8 +16,9 @@ using namespace std;
 int UDPClientBase::open(uint16_t p) {
    if(_sock == -1) {
       string &res = WiFiUtils::modem_res();
-      modem.begin();
-      if(modem.write(WiFiUtils::modem_cmd(PROMPT(_UDPBEGIN)),res, "%s%d\r\n" , CMD_WRITE(_UDPBEGIN),p)) {
+      ModemBatch batch;
+      batch.command(PROMPT(_UDPBEGIN), "%s%d\r\n", CMD_WRITE(_UDPBEGIN),p);
+      if(batch.reply(res)) {
          _sock = atoi(res.c_str());
          return 0;
       }
@@ -26,36 +29,55 @@ int UDPClientBase::open(uint16_t p) {
 void UDPClientBase::close() {
     if(_sock >= 0) {
        string &res = WiFiUtils::modem_res();
-       modem.begin();
-       modem.write(WiFiUtils::modem_cmd(PROMPT(_UDPSTOP)),res, "%s%d\r\n" , CMD_WRITE(_UDPSTOP), _sock);
+       ModemBatch batch;
+       batch.command(PROMPT(_UDPSTOP), "%s%d\r\n", CMD_WRITE(_UDPSTOP), _sock);
+       batch.reply(res);
        _sock = -1;
     }
 
 }
 
 int UDPClientBase::send(IPAddress ip, uint16_t port, const std::string_view &data) {
-    if (!beginPacket(ip, port)) return -1;
-    if (write(reinterpret_cast<const unsigned char *>(data.data()), data.size()) != data.size()) return -2;
-    if (!endPacket()) return -3;
-    return data.size();
+    if (_sock < 0) return -1;
+    ModemBatch batch;
+    batch.command(PROMPT(_UDPBEGINPACKETIP), "%s%d,%d,%d.%d.%d.%d\r\n", CMD_WRITE(_UDPBEGINPACKETIP),
+            _sock, port, ip[0], ip[1], ip[2], ip[3]);
+    return send_packet(batch, data);
 }
 int UDPClientBase::send(const char *host, uint16_t port, const std::string_view &data) {
-    if (!beginPacket(host, port)) return -1;
-    if (write(reinterpret_cast<const unsigned char *>(data.data()), data.size()) != data.size()) return -2;
-    if (!endPacket()) return -3;
+    if (_sock < 0) return -1;
+    ModemBatch batch;
+    batch.command(PROMPT(_UDPBEGINPACKETNAME), "%s%d,%d,%s\r\n", CMD_WRITE(_UDPBEGINPACKETNAME),
+            _sock, port, host);
+    return send_packet(batch, data);
+}
+int UDPClientBase::send_packet(ModemBatch &batch, const std::string_view &data) {
+    //begin, write and end of the packet in one exchange
+    batch.command(PROMPT(_UDPWRITE), "%s%d,%d\r\n", CMD_WRITE(_UDPWRITE), _sock, data.size());
+    batch.data(data.data(), data.size());
+    batch.command(PROMPT(_UDPENDPACKET), "%s%d\r\n", CMD_WRITE(_UDPENDPACKET), _sock);
+    bool b = batch.reply();
+    bool w = batch.reply();
+    bool e = batch.reply();
+    if (!b) return -1;
+    if (!w) return -2;
+    if (!e) return -3;
     return data.size();
 }
 std::size_t UDPClientBase::receive(char *buffer, std::size_t buffer_size) {
-    if (!parsePacket()) return 0;
-    return read(buffer, buffer_size);
+    int sz = parsePacket();
+    if (sz <= 0) return 0;
+    int r = read(buffer, std::min<std::size_t>(sz, buffer_size));
+    return r > 0?r:0;
 }
 
 
 int UDPClientBase::beginPacket(IPAddress ip, uint16_t p) {
    if(_sock >= 0) {
       string &res = WiFiUtils::modem_res();
-      modem.begin();
-      if(modem.write(WiFiUtils::modem_cmd(PROMPT(_UDPBEGINPACKETIP)),res, "%s%d,%d,%s\r\n" , CMD_WRITE(_UDPBEGINPACKETIP),_sock,p,ip.toString().c_str())) {
+      ModemBatch batch;
+      batch.command(PROMPT(_UDPBEGINPACKETIP), "%s%d,%d,%d.%d.%d.%d\r\n", CMD_WRITE(_UDPBEGINPACKETIP),_sock,p,ip[0],ip[1],ip[2],ip[3]);
+      if(batch.reply(res)) {
          return 1;
       }
    }
@@ -65,8 +87,9 @@ int UDPClientBase::beginPacket(IPAddress ip, uint16_t p) {
 int UDPClientBase::beginPacket(const char *host, uint16_t p) {
    if(_sock >= 0) {
       string &res = WiFiUtils::modem_res();
-      modem.begin();
-      if(modem.write(WiFiUtils::modem_cmd(PROMPT(_UDPBEGINPACKETNAME)),res, "%s%d,%d,%s\r\n" , CMD_WRITE(_UDPBEGINPACKETNAME),_sock,p,host)) {
+      ModemBatch batch;
+      batch.command(PROMPT(_UDPBEGINPACKETNAME), "%s%d,%d,%s\r\n", CMD_WRITE(_UDPBEGINPACKETNAME),_sock,p,host);
+      if(batch.reply(res)) {
          return 1;
       }
    }
@@ -77,8 +100,9 @@ int UDPClientBase::beginPacket(const char *host, uint16_t p) {
 int UDPClientBase::endPacket() {
    if(_sock >= 0) {
       string &res = WiFiUtils::modem_res();
-      modem.begin();
-      if(modem.write(WiFiUtils::modem_cmd(PROMPT(_UDPENDPACKET)),res, "%s%d\r\n" , CMD_WRITE(_UDPENDPACKET), _sock)) {
+      ModemBatch batch;
+      batch.command(PROMPT(_UDPENDPACKET), "%s%d\r\n", CMD_WRITE(_UDPENDPACKET), _sock);
+      if(batch.reply(res)) {
          return 1;
       }
    }
@@ -88,10 +112,10 @@ int UDPClientBase::endPacket() {
 
 size_t UDPClientBase::write(const uint8_t *buf, size_t size) {
    if(_sock >= 0) {
-      string &res = WiFiUtils::modem_res();
-      modem.begin();
-      modem.write_nowait(WiFiUtils::modem_cmd(PROMPT(_UDPWRITE)),res, "%s%d,%d\r\n" , CMD_WRITE(_UDPWRITE), _sock, size);
-      if(modem.passthrough(buf,size)) {
+      ModemBatch batch;
+      batch.command(PROMPT(_UDPWRITE), "%s%d,%d\r\n", CMD_WRITE(_UDPWRITE), _sock, size);
+      batch.data(buf, size);
+      if(batch.reply()) {
          return size;
       }
 
@@ -102,8 +126,9 @@ size_t UDPClientBase::write(const uint8_t *buf, size_t size) {
 int UDPClientBase::parsePacket() {
    if(_sock >= 0) {
       string &res = WiFiUtils::modem_res();
-      modem.begin();
-      if(modem.write(WiFiUtils::modem_cmd(PROMPT(_UDPPARSE)),res, "%s%d\r\n" , CMD_WRITE(_UDPPARSE), _sock)) {
+      ModemBatch batch;
+      batch.command(PROMPT(_UDPPARSE), "%s%d\r\n", CMD_WRITE(_UDPPARSE), _sock);
+      if(batch.reply(res)) {
          return atoi(res.c_str());
       }
    }
@@ -115,12 +140,9 @@ int UDPClientBase::read(char *buffer, std::size_t size) {
    int rv = -1;
    if(_sock >= 0) {
       string &res = WiFiUtils::modem_res();
-      modem.begin();
-
-      /* important - it works one shot */
-      modem.avoid_trim_results();
-      modem.read_using_size();
-      if(modem.write(WiFiUtils::modem_cmd(PROMPT(_UDPREAD)),res, "%s%d,%d\r\n" , CMD_WRITE(_UDPREAD), _sock, size)) {
+      ModemBatch batch;
+      batch.binary_command(PROMPT(_UDPREAD), "%s%d,%d\r\n", CMD_WRITE(_UDPREAD), _sock, size);
+      if(batch.reply(res)) {
          if(res.size() > 0) {
             for(std::size_t i = 0; i < size && i < res.size(); i++) {
                 buffer[i] = res[i];
@@ -138,8 +160,9 @@ int UDPClientBase::read(char *buffer, std::size_t size) {
 void UDPClientBase::flush() {
    if(_sock >= 0) {
       string &res = WiFiUtils::modem_res();
-      modem.begin();
-      modem.write(WiFiUtils::modem_cmd(PROMPT(_UDPFLUSH)),res, "%s%d\r\n" , CMD_WRITE(_UDPFLUSH), _sock);
+      ModemBatch batch;
+      batch.command(PROMPT(_UDPFLUSH), "%s%d\r\n", CMD_WRITE(_UDPFLUSH), _sock);
+      batch.reply(res);
    }
 }
 
@@ -2,6 +2,8 @@
 #include <string_view>
 #include "api/IPAddress.h"
 
+class ModemBatch;
+
 class UDPClientBase {
 public:
     int open(uint16_t port);
@@ -14,6 +16,8 @@ protected:
     int _sock = -1;
 
 
+    ///add write and end of packet to the batch which begins packet, sends all at once
+    int send_packet(ModemBatch &batch, const std::string_view &data);
     int beginPacket(IPAddress ip, uint16_t p);
     int beginPacket(const char *host, uint16_t p);
     int endPacket();
@@ -5,6 +5,11 @@
 #include "WiFiS3.h"
 
 #include <vector>
+
+///UART connected to the modem (used by asynchronous driver)
+using ModemUart = UART;
+inline ModemUart &modem_uart() {return Serial2;}
+
 struct WiFiUtils {
 
     static std::string &modem_cmd(const char *prompt);
@@ -0,0 +1,67 @@
+#pragma once
+//stand-in of the WiFiS3 core - the modem UART and the AT parser
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+///UART connected to the modem, it executes TCP and UDP commands
+/**
+ * One socket of each kind is simulated. Data received from the network
+ * are put to tcp_inbox / udp_inbox, sent data are collected. Every time
+ * the host starts reading after it has written something counts as one
+ * exchange (round trip)
+ */
+class UART {
+public:
+    int available();
+    int read();
+    std::size_t write(const uint8_t *data, std::size_t size);
+    std::size_t write(uint8_t c) {return write(&c, 1);}
+
+    ///data waiting in the modem for TCPClient
+    std::string tcp_inbox;
+    ///data sent by TCPClient
+    std::string tcp_sent;
+    ///datagram waiting in the modem
+    std::string udp_inbox;
+    ///sent datagrams (content only)
+    std::string udp_sent;
+    ///count of exchanges
+    unsigned long exchanges = 0;
+    ///count of executed commands
+    unsigned long commands = 0;
+
+protected:
+    std::string _rx;
+    std::size_t _rx_pos = 0;
+    std::string _line;
+    std::string _udp_packet;
+    std::string _udp_cur;
+    std::size_t _raw_remain = 0;
+    bool _raw_udp = false;
+    bool _written = false;
+
+    void execute(std::string_view line);
+    void reply(std::string_view prompt, std::string_view value);
+};
+
+///AT parser of the WiFiS3 core, same contract as ModemClass of the core
+class ModemClass {
+public:
+    void begin() {}
+    void timeout(std::size_t) {}
+    bool write(const std::string &prompt, std::string &res, const char *fmt, ...);
+    bool passthrough(const uint8_t *data, std::size_t size);
+    void avoid_trim_results() {_trim = false;}
+    void read_using_size() {_read_by_size = true;}
+
+protected:
+    bool _trim = true;
+    bool _read_by_size = false;
+
+    bool read_reply(const std::string &prompt, std::string &res);
+};
+
+extern UART Serial2;
+extern ModemClass modem;
@@ -0,0 +1,32 @@
+#pragma once
+//AT commands of the WiFiS3 core used by r4ext (subset)
+
+#define _AT                       "AT"
+#define _ENDL                     "\r\n"
+
+#define _BEGINCLIENT              "+BEGCLIENT"
+#define _CLIENTCONNECT            "+CLIENTCONNECT"
+#define _CLIENTCONNECTNAME        "+CLIENTCONNECTNAME"
+#define _CLIENTSEND               "+CLIENTSEND"
+#define _AVAILABLE                "+AVAILABLE"
+#define _CLIENTRECEIVE            "+CLIENTRECEIVE"
+#define _PEEK                     "+PEEK"
+#define _CLIENTFLUSH              "+CLIENTFLUSH"
+#define _CLIENTCLOSE              "+CLIENTCLOSE"
+#define _CLIENTCONNECTED          "+CLIENTCONNECTED"
+#define _REMOTEIP                 "+REMOTEIP"
+#define _REMOTEPORT               "+REMOTEPORT"
+#define _UDPBEGIN                 "+UDPBEGIN"
+#define _UDPSTOP                  "+UDPSTOP"
+#define _UDPBEGINPACKETIP         "+UDPBEGINPACKETIP"
+#define _UDPBEGINPACKETNAME       "+UDPBEGINPACKETNAME"
+#define _UDPENDPACKET             "+UDPENDPACKET"
+#define _UDPWRITE                 "+UDPWRITE"
+#define _UDPPARSE                 "+UDPPARSE"
+#define _UDPREAD                  "+UDPREAD"
+#define _UDPFLUSH                 "+UDPFLUSH"
+
+#define CMD(x)                    _AT x _ENDL
+#define CMD_WRITE(x)              _AT x "="
+#define CMD_READ(x)               _AT x "?" _ENDL
+#define PROMPT(x)                 x ":"
@@ -0,0 +1,13 @@
+#pragma once
+//stand-in of the WiFiS3 core
+#include "Modem.h"
+
+#include <string>
+
+struct CAccessPoint {
+    std::string ssid;
+    std::string bssid;
+    std::string rssi;
+    std::string channel;
+    std::string encryption_mode;
+};
@@ -0,0 +1,2 @@
+#pragma once
+//stand-in of the WiFiS3 core, r4ext uses no type of it
@@ -0,0 +1,348 @@
+//Test of batching of modem commands
+//
+//r4ext is compiled against stand-ins of the WiFiS3 core (directory core).
+//The UART executes TCP and UDP commands and counts exchanges - every time
+//the host starts to read replies after it has written commands. Tests check
+//the count of exchanges of the TCP and UDP calls and integrity of the data
+
+#include "check.h"
+#include "../ModemBatch.h"
+#include "../WifiTCP.h"
+
+#include "Modem.h"
+#include "WiFiCommands.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+
+UART Serial2;
+ModemClass modem;
+
+//the modem replies immediately, timeouts of Stream are never reached
+unsigned long millis() {return 0;}
+
+int UART::available() {
+    if (_written) {
+        ++exchanges;
+        _written = false;
+    }
+    return static_cast<int>(_rx.size() - _rx_pos);
+}
+
+int UART::read() {
+    if (!available()) return -1;
+    return static_cast<unsigned char>(_rx[_rx_pos++]);
+}
+
+std::size_t UART::write(const uint8_t *data, std::size_t size) {
+    if (size) _written = true;
+    for (std::size_t i = 0; i < size; ++i) {
+        char c = static_cast<char>(data[i]);
+        if (_raw_remain) {
+            (_raw_udp?_udp_packet:tcp_sent).push_back(c);
+            if (--_raw_remain == 0) _rx.append("OK\r\n");
+            continue;
+        }
+        _line.push_back(c);
+        if (c == '\n') {
+            execute(_line);
+            _line.clear();
+        }
+    }
+    return size;
+}
+
+void UART::reply(std::string_view prompt, std::string_view value) {
+    _rx.append(prompt);
+    _rx.append(" ");
+    _rx.append(value);
+    _rx.append("\r\nOK\r\n");
+}
+
+void UART::execute(std::string_view line) {
+    ++commands;
+    line = line.substr(0, line.find('\r'));
+    auto eq = line.find('=');
+    auto cmd = line.substr(0, eq);
+    auto args = eq == line.npos?std::string_view():line.substr(eq+1);
+    auto comma = args.rfind(',');
+    auto last_arg = [&]{return std::stoul(std::string(args.substr(comma+1)));};
+    auto prompt = std::string(cmd.substr(2)) + ":";
+    if (cmd == "AT" _BEGINCLIENT || cmd == "AT" _UDPBEGIN) {
+        reply(prompt, "0");
+    } else if (cmd == "AT" _AVAILABLE) {
+        reply(prompt, std::to_string(tcp_inbox.size()));
+    } else if (cmd == "AT" _CLIENTCONNECTED) {
+        reply(prompt, "1");
+    } else if (cmd == "AT" _CLIENTRECEIVE) {
+        auto d = tcp_inbox.substr(0, last_arg());
+        tcp_inbox.erase(0, d.size());
+        reply(prompt, std::to_string(d.size()) + "|" + d);
+    } else if (cmd == "AT" _UDPPARSE) {
+        _udp_cur = udp_inbox;
+        udp_inbox.clear();
+        reply(prompt, std::to_string(_udp_cur.size()));
+    } else if (cmd == "AT" _UDPREAD) {
+        auto d = _udp_cur.substr(0, last_arg());
+        reply(prompt, std::to_string(d.size()) + "|" + d);
+    } else if (cmd == "AT" _CLIENTSEND || cmd == "AT" _UDPWRITE) {
+        _raw_remain = last_arg();
+        _raw_udp = cmd == "AT" _UDPWRITE;
+    } else if (cmd == "AT" _UDPBEGINPACKETIP) {
+        _udp_packet.clear();
+        _rx.append("OK\r\n");
+    } else if (cmd == "AT" _UDPENDPACKET) {
+        udp_sent = _udp_packet;
+        _rx.append("OK\r\n");
+    } else if (cmd == "AT" _CLIENTCONNECT || cmd == "AT" _CLIENTCLOSE || cmd == "AT" _UDPSTOP) {
+        _rx.append("OK\r\n");
+    } else {
+        _rx.append("ERROR\r\n");
+    }
+}
+
+bool ModemClass::write(const std::string &prompt, std::string &res, const char *fmt, ...) {
+    char buff[256];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buff, sizeof(buff), fmt, args);
+    va_end(args);
+    res.clear();
+    if (len > 0) Serial2.write(reinterpret_cast<const uint8_t *>(buff), len);
+    return read_reply(prompt, res);
+}
+
+bool ModemClass::passthrough(const uint8_t *data, std::size_t size) {
+    std::string res;
+    if (data && size) Serial2.write(data, size);
+    return read_reply({}, res);
+}
+
+bool ModemClass::read_reply(const std::string &prompt, std::string &res) {
+    bool by_size = _read_by_size;
+    bool trim = _trim;
+    _read_by_size = false;
+    _trim = true;
+    std::string line;
+    int c;
+    while ((c = Serial2.read()) >= 0) {
+        line.push_back(static_cast<char>(c));
+        if (!prompt.empty() && line == prompt) {
+            if (by_size) {
+                std::size_t sz = 0;
+                while ((c = Serial2.read()) >= 0 && c != '|') {
+                    if (c >= '0' && c <= '9') sz = sz * 10 + (c - '0');
+                }
+                for (std::size_t i = 0; i < sz && (c = Serial2.read()) >= 0; ++i) {
+                    res.push_back(static_cast<char>(c));
+                }
+            } else {
+                while ((c = Serial2.read()) >= 0 && c != '\n') res.push_back(static_cast<char>(c));
+                if (!res.empty() && res.back() == '\r') res.pop_back();
+                if (trim) {
+                    res.erase(0, res.find_first_not_of(' '));
+                    res.erase(res.find_last_not_of(' ') + 1);
+                }
+            }
+            line.clear();
+        } else if (line.size() >= 2 && line.compare(line.size() - 2, 2, "\r\n") == 0) {
+            if (line == "OK\r\n") return true;
+            if (line == "ERROR\r\n") return false;
+            line.clear();
+        }
+    }
+    //timeout
+    return false;
+}
+
+std::string& WiFiUtils::modem_cmd(const char *prompt) {
+    static std::string str;
+    str.clear();
+    str.append(prompt);
+    return str;
+}
+
+std::string& WiFiUtils::modem_res() {
+    static std::string str;
+    str.clear();
+    return str;
+}
+
+///counts exchanges from construction, checks the counter of ModemBatch
+class Exchanges {
+public:
+    Exchanges():_uart(Serial2.exchanges), _batch(ModemBatch::round_trips()) {}
+    unsigned long count() const {
+        unsigned long n = Serial2.exchanges - _uart;
+        unsigned long b = ModemBatch::round_trips() - _batch;
+        CHECK_EQUAL(b, n);
+        return n;
+    }
+protected:
+    unsigned long _uart;
+    unsigned long _batch;
+};
+
+static std::string make_data(std::size_t sz) {
+    std::string s;
+    //contains the end of reply, the binary reply must be read by size
+    for (std::size_t i = 0; s.size() < sz; ++i) {
+        s.append(i % 7 == 3?"\r\nOK\r\n":"GET /index.html HTTP/1.1\r\n");
+    }
+    s.resize(sz);
+    return s;
+}
+
+static void connect(TCPClient &client) {
+    int r = client.connect(IPAddress(192,168,1,2), 80);
+    CHECK_EQUAL(r, 1);
+}
+
+static void test_receive_request() {
+    TCPClient client;
+    connect(client);
+    Serial2.tcp_inbox = make_data(400);
+    auto expected = Serial2.tcp_inbox;
+    char buff[4096];
+    Exchanges ex;
+    //available and receive with query of remaining data
+    int r = client.read(reinterpret_cast<uint8_t *>(buff), sizeof(buff));
+    CHECK_EQUAL(r, 400);
+    CHECK(expected == std::string_view(buff, r));
+    CHECK_EQUAL(ex.count(), 2UL);
+    //the modem reported no more data, the next read asks again
+    r = client.read(reinterpret_cast<uint8_t *>(buff), sizeof(buff));
+    CHECK_EQUAL(r, 0);
+    CHECK_EQUAL(ex.count(), 3UL);
+    client.stop();
+}
+
+static void test_receive_large_body() {
+    TCPClient client;
+    connect(client);
+    Serial2.tcp_inbox = make_data(1536);
+    auto expected = Serial2.tcp_inbox;
+    std::string got;
+    char buff[4096];
+    Exchanges ex;
+    while (got.size() < expected.size()) {
+        int r = client.read(reinterpret_cast<uint8_t *>(buff), sizeof(buff));
+        CHECK_GREATER(r, 0);
+        got.append(buff, r);
+    }
+    CHECK(got == expected);
+    //1024 bytes at once, the remainder is already known
+    CHECK_EQUAL(ex.count(), 3UL);
+    client.stop();
+}
+
+static void test_receive_by_bytes() {
+    TCPClient client;
+    connect(client);
+    Serial2.tcp_inbox = make_data(300);
+    auto expected = Serial2.tcp_inbox;
+    std::string got;
+    Exchanges ex;
+    while (client.available()) got.push_back(static_cast<char>(client.read()));
+    CHECK(got == expected);
+    //first exchange asks for available data, then the buffer (256 bytes)
+    //and the remainder are received, the last one finds no data
+    CHECK_EQUAL(ex.count(), 4UL);
+    client.stop();
+}
+
+static void test_connected() {
+    TCPClient client;
+    connect(client);
+    {
+        Exchanges ex;
+        auto c = client.connected();
+        CHECK_EQUAL(c, 1);
+        CHECK_EQUAL(ex.count(), 1UL);
+    }
+    Serial2.tcp_inbox = make_data(300);
+    char buff[100];
+    int r = client.read(reinterpret_cast<uint8_t *>(buff), sizeof(buff));
+    CHECK_EQUAL(r, 100);
+    {
+        //data are waiting in the buffer, the modem is not asked
+        Exchanges ex;
+        auto c = client.connected();
+        CHECK_EQUAL(c, 1);
+        CHECK_EQUAL(ex.count(), 0UL);
+    }
+    client.stop();
+    Serial2.tcp_inbox.clear();
+}
+
+static void test_send() {
+    TCPClient client;
+    connect(client);
+    Serial2.tcp_sent.clear();
+    auto data = make_data(700);
+    Exchanges ex;
+    auto r = client.write(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+    CHECK_EQUAL(r, data.size());
+    CHECK_EQUAL(ex.count(), 1UL);
+    CHECK(Serial2.tcp_sent == data);
+    client.stop();
+}
+
+static void test_udp() {
+    UDPClient<512> udp;
+    int r = udp.open(123);
+    CHECK_EQUAL(r, 0);
+    std::string query(48, '\0');
+    query[0] = 0x1B;
+    query[20] = '\n';
+    {
+        //begin, write and end of the packet in one exchange
+        Exchanges ex;
+        r = udp.send(IPAddress(162,159,200,1), 123, query);
+        CHECK_EQUAL(r, 48);
+        CHECK_EQUAL(ex.count(), 1UL);
+        CHECK(Serial2.udp_sent == query);
+    }
+    Serial2.udp_inbox = make_data(48);
+    {
+        Exchanges ex;
+        auto d = udp.receive();
+        CHECK(d == make_data(48));
+        CHECK_EQUAL(ex.count(), 2UL);
+    }
+    udp.close();
+}
+
+static void test_batch_overflow() {
+    Serial2.tcp_inbox = "abc";
+    ModemBatch batch;
+    //commands don't fit to the buffer together, they are written in parts
+    for (int i = 0; i < 3; ++i) {
+        CHECK(batch.command(PROMPT(_AVAILABLE), "%s%070d\r\n", CMD_WRITE(_AVAILABLE), i));
+    }
+    CHECK(batch.command(PROMPT(_CLIENTCONNECTED), "%s%d\r\n", CMD_WRITE(_CLIENTCONNECTED), 0));
+    CHECK(!batch.command(PROMPT(_AVAILABLE), "%s%d\r\n", CMD_WRITE(_AVAILABLE), 0));
+    Exchanges ex;
+    std::string res;
+    for (int i = 0; i < 3; ++i) {
+        CHECK(batch.reply(res));
+        CHECK_EQUAL(res, "3");
+    }
+    CHECK(batch.reply(res));
+    CHECK_EQUAL(res, "1");
+    CHECK(!batch.reply(res));
+    CHECK_EQUAL(ex.count(), 1UL);
+    Serial2.tcp_inbox.clear();
+}
+
+int main() {
+    test_receive_request();
+    test_receive_large_body();
+    test_receive_by_bytes();
+    test_connected();
+    test_send();
+    test_udp();
+    test_batch_overflow();
+    return 0;
+}
@@ -0,0 +1,211 @@
+//Test of non-blocking AT modem driver
+//
+//The modem is simulated by a scripted UART. Tests check parsing of text,
+//binary and status replies split to any pieces, pipelining of commands,
+//errors, timeouts with resynchronization and releasing of tickets
+
+#include "check.h"
+#include <kotel/at_modem.h>
+
+#include <random>
+#include <string>
+
+using namespace kotel;
+
+class ScriptUart {
+public:
+    int available() const {return static_cast<int>(_rx.size() - _rx_pos);}
+    int read() {
+        if (_rx_pos >= _rx.size()) return -1;
+        return static_cast<unsigned char>(_rx[_rx_pos++]);
+    }
+    std::size_t write(const uint8_t *data, std::size_t size) {
+        _tx.append(reinterpret_cast<const char *>(data), size);
+        return size;
+    }
+    void feed(std::string_view data) {_rx.append(data);}
+    std::string take_sent() {
+        std::string r;
+        std::swap(r, _tx);
+        return r;
+    }
+protected:
+    std::string _rx;
+    std::size_t _rx_pos = 0;
+    std::string _tx;
+};
+
+class TestTask: public AbstractTask {
+public:
+    virtual void run(TimeStampMs) override {}
+};
+
+using Modem = AtModem<ScriptUart, 8>;
+
+static void test_text() {
+    ScriptUart uart;
+    Modem modem(uart);
+    auto t = modem.command("+GETSTATUS:", AtReply::text, "AT+GETSTATUS?\r\n");
+    CHECK(t != no_at_ticket);
+    CHECK(modem.get_status(t) == AtStatus::queued);
+    modem.pump(0);
+    CHECK_EQUAL(uart.take_sent(), "AT+GETSTATUS?\r\n");
+    CHECK(modem.get_status(t) == AtStatus::sent);
+    for (char c: std::string_view("+GETSTATUS: 3\r\nOK\r\n")) {
+        CHECK(!modem.is_done(t));
+        uart.feed({&c, 1});
+        modem.pump(1);
+    }
+    CHECK(modem.get_status(t) == AtStatus::ok);
+    CHECK_EQUAL(modem.get_result(t), "3");
+    CHECK_EQUAL(modem.get_int_result(t), 3);
+    CHECK(modem.is_idle());
+    modem.release(t);
+    CHECK(t == no_at_ticket);
+    CHECK_EQUAL(modem.get_free_slots(), 8U);
+    //too long command
+    CHECK(modem.command("+X:", AtReply::text, "AT+X=%0100d\r\n", 1) == no_at_ticket);
+    CHECK_EQUAL(modem.get_free_slots(), 8U);
+}
+
+static void test_pipeline() {
+    ScriptUart uart;
+    Modem modem(uart);
+    AtTicket t[5];
+    for (int i = 0; i < 5; ++i) {
+        t[i] = modem.command("+V:", AtReply::text, "AT+V=%d\r\n", i);
+    }
+    modem.pump(0);
+    //only max_in_flight commands are sent
+    CHECK_EQUAL(uart.take_sent(), "AT+V=0\r\nAT+V=1\r\nAT+V=2\r\nAT+V=3\r\n");
+    uart.feed("+V: 10\r\nOK\r\n+V: 11\r\nOK\r\n");
+    modem.pump(1);
+    CHECK_EQUAL(modem.get_int_result(t[0]), 10);
+    CHECK_EQUAL(modem.get_int_result(t[1]), 11);
+    CHECK(!modem.is_done(t[2]));
+    CHECK_EQUAL(uart.take_sent(), "AT+V=4\r\n");
+    uart.feed("+V: 12\r\nOK\r\nERROR\r\n+V: 14\r\nOK\r\n");
+    modem.pump(2);
+    CHECK_EQUAL(modem.get_int_result(t[2]), 12);
+    CHECK(modem.get_status(t[3]) == AtStatus::error);
+    CHECK_EQUAL(modem.get_int_result(t[4]), 14);
+    CHECK(modem.is_idle());
+}
+
+static void test_binary() {
+    ScriptUart uart;
+    Modem modem(uart);
+    std::string payload("ab|c\r\nOK\r\nERROR\r\nxyz");
+    char buffer[64];
+    auto t = modem.command("+UDPREAD:", AtReply::binary, "AT+UDPREAD=0,%d\r\n", 64);
+    modem.set_output(t, buffer, sizeof(buffer));
+    auto z = modem.command("+UDPREAD:", AtReply::binary, "AT+UDPREAD=0,%d\r\n", 64);
+    auto s = modem.command("+UDPWRITE:", AtReply::status, "AT+UDPWRITE=0,%d\r\n", 3);
+    modem.set_payload(s, "XYZ", 3);
+    modem.pump(0);
+    CHECK_EQUAL(uart.take_sent(), "AT+UDPREAD=0,64\r\nAT+UDPREAD=0,64\r\nAT+UDPWRITE=0,3\r\nXYZ");
+    std::string reply = "+UDPREAD: " + std::to_string(payload.size()) + "|" + payload + "\r\nOK\r\n"
+                      + "+UDPREAD: 0|\r\nOK\r\n"
+                      + "OK\r\n";
+    std::mt19937 rnd(1);
+    std::size_t pos = 0;
+    while (pos < reply.size()) {
+        std::size_t n = std::min<std::size_t>(rnd() % 5 + 1, reply.size() - pos);
+        uart.feed(std::string_view(reply).substr(pos, n));
+        pos += n;
+        modem.pump(1);
+    }
+    CHECK(modem.get_status(t) == AtStatus::ok);
+    CHECK_EQUAL(modem.get_result(t), payload);
+    CHECK(modem.get_status(z) == AtStatus::ok);
+    CHECK(modem.get_result(z).empty());
+    CHECK(modem.get_status(s) == AtStatus::ok);
+}
+
+static void test_timeout() {
+    ScriptUart uart;
+    Modem modem(uart);
+    auto a = modem.command("+A:", AtReply::text, "AT+A\r\n");
+    auto b = modem.command("+B:", AtReply::text, "AT+B\r\n");
+    modem.pump(0);
+    uart.take_sent();
+    modem.pump(Modem::default_timeout);
+    CHECK(!modem.is_done(a));
+    modem.pump(Modem::default_timeout + 1);
+    CHECK(modem.get_status(a) == AtStatus::timeout);
+    CHECK(modem.get_status(b) == AtStatus::timeout);
+    //late replies may come, the UART is not free for direct use
+    CHECK(!modem.is_idle());
+    //late replies must not be taken as replies of next commands
+    auto c = modem.command("+C:", AtReply::text, "AT+C\r\n");
+    uart.feed("+A: 1\r\nOK\r\n");
+    modem.pump(3000);
+    uart.feed("+B: 2\r\nOK\r\n");
+    modem.pump(3050);
+    CHECK(uart.take_sent().empty());
+    modem.pump(3050 + Modem::resync_quiet);
+    CHECK_EQUAL(uart.take_sent(), "AT+C\r\n");
+    uart.feed("+C: 3\r\nOK\r\n");
+    modem.pump(3200);
+    CHECK_EQUAL(modem.get_int_result(c), 3);
+}
+
+static void test_late_reply() {
+    ScriptUart uart;
+    Modem modem(uart);
+    auto a = modem.command("+A:", AtReply::text, "AT+A\r\n");
+    modem.pump(0);
+    uart.take_sent();
+    modem.pump(Modem::default_timeout + 1);
+    CHECK(modem.get_status(a) == AtStatus::timeout);
+    //nothing is pending, but the reply can still come
+    CHECK(!modem.is_idle());
+    modem.pump(Modem::default_timeout + 50);
+    CHECK(!modem.is_idle());
+    uart.feed("+A: 1\r\nOK\r\n");
+    modem.pump(Modem::default_timeout + 60);
+    CHECK(!modem.is_idle());
+    //the late reply was consumed by the driver, the line is quiet
+    modem.pump(Modem::default_timeout + 60 + Modem::resync_quiet);
+    CHECK(modem.is_idle());
+    CHECK_EQUAL(uart.available(), 0);
+}
+
+static void test_release() {
+    ScriptUart uart;
+    Modem modem(uart);
+    TestTask task;
+    task.resume_at(1000);
+    AtTicket t[8];
+    for (auto &x: t) {
+        x = modem.command("+X:", AtReply::text, "AT+X\r\n");
+        CHECK(x != no_at_ticket);
+    }
+    //queue is full
+    CHECK(modem.command("+X:", AtReply::text, "AT+X\r\n") == no_at_ticket);
+    modem.set_notify(t[1], &task);
+    AtTicket first = t[0];
+    modem.release(t[0]);
+    CHECK(modem.get_status(first) == AtStatus::invalid);
+    modem.pump(0);
+    uart.feed("+X: 0\r\nOK\r\n+X: 1\r\nOK\r\n");
+    modem.pump(1);
+    CHECK_EQUAL(modem.get_int_result(t[1]), 1);
+    CHECK_EQUAL(task.get_scheduled_time(), 0U);
+    //slot of released command was freed when its reply came
+    CHECK_EQUAL(modem.get_free_slots(), 1U);
+    //stale ticket doesn't match new command in reused slot
+    auto n = modem.command("+X:", AtReply::text, "AT+X\r\n");
+    CHECK(n != first);
+    CHECK(modem.get_status(first) == AtStatus::invalid);
+}
+
+int main() {
+    test_text();
+    test_pipeline();
+    test_binary();
+    test_timeout();
+    test_late_reply();
+    test_release();
+    return 0;
+}
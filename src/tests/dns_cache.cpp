@@ -0,0 +1,295 @@
+//Test of DNS resolver cache
+//
+//The modem is simulated by an UART which executes UDP commands. DNS servers
+//are scripted: replies are generated for queries, or the queries are
+//dropped. Tests check caching with TTL, parsing of more answers, rotation,
+//fallback to the secondary server and concurrent queries
+
+#include "check.h"
+#include <kotel/simple_dns.h>
+
+#include <string>
+#include <vector>
+
+using namespace kotel;
+
+class FakeEsp {
+public:
+
+    struct Datagram {
+        std::string server;
+        std::string data;
+    };
+
+    int available() const {return static_cast<int>(_rx.size() - _rx_pos);}
+    int read() {
+        if (_rx_pos >= _rx.size()) return -1;
+        return static_cast<unsigned char>(_rx[_rx_pos++]);
+    }
+    std::size_t write(const uint8_t *data, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            char c = static_cast<char>(data[i]);
+            if (_raw_remain) {
+                _packet.push_back(c);
+                if (--_raw_remain == 0) _rx.append("OK\r\n");
+                continue;
+            }
+            _line.push_back(c);
+            if (c == '\n') {
+                execute(_line);
+                _line.clear();
+            }
+        }
+        return size;
+    }
+
+    ///count of executed commands
+    unsigned int commands = 0;
+    ///sent datagrams
+    std::vector<Datagram> sent;
+    ///datagrams to receive
+    std::vector<std::string> inbox;
+    ///reply of UDPBEGIN is held until release_begin() (slow modem)
+    bool hold_begin = false;
+
+    void release_begin() {
+        hold_begin = false;
+        _rx.append(_held);
+        _held.clear();
+    }
+
+protected:
+    std::string _rx;
+    std::size_t _rx_pos = 0;
+    std::string _line;
+    std::string _packet;
+    std::string _server;
+    std::size_t _raw_remain = 0;
+    std::string _cur;
+    std::string _held;
+
+    void execute(std::string_view line) {
+        ++commands;
+        auto eq = line.find('=');
+        auto cmd = line.substr(0, eq);
+        auto args = line.substr(eq+1);
+        auto comma = args.find(',');
+        if (cmd == "AT+UDPBEGIN") {
+            (hold_begin?_held:_rx).append("+UDPBEGIN: 0\r\nOK\r\n");
+        } else if (cmd == "AT+UDPBEGINPACKETIP") {
+            _server = std::string(args.substr(args.rfind(',')+1));
+            while (!_server.empty() && (_server.back() == '\n' || _server.back() == '\r')) _server.pop_back();
+            _packet.clear();
+            _rx.append("OK\r\n");
+        } else if (cmd == "AT+UDPWRITE") {
+            _raw_remain = std::stoi(std::string(args.substr(comma+1)));
+        } else if (cmd == "AT+UDPENDPACKET") {
+            sent.push_back({_server, _packet});
+            _rx.append("OK\r\n");
+        } else if (cmd == "AT+UDPPARSE") {
+            if (inbox.empty()) {
+                _cur.clear();
+            } else {
+                _cur = inbox.front();
+                inbox.erase(inbox.begin());
+            }
+            _rx.append("+UDPPARSE: " + std::to_string(_cur.size()) + "\r\nOK\r\n");
+        } else if (cmd == "AT+UDPREAD") {
+            std::size_t sz = std::stoi(std::string(args.substr(comma+1)));
+            auto d = _cur.substr(0, sz);
+            _rx.append("+UDPREAD: " + std::to_string(d.size()) + "|" + d + "\r\nOK\r\n");
+        } else {
+            _rx.append("ERROR\r\n");
+        }
+    }
+};
+
+using Modem = AtModem<FakeEsp>;
+using DNS = SimpleDNSClient<Modem>;
+
+static void put16(std::string &s, uint16_t v) {
+    s.push_back(static_cast<char>(v >> 8));
+    s.push_back(static_cast<char>(v & 0xFF));
+}
+
+///build reply to the query with A records
+static std::string make_reply(const std::string &query, const std::vector<std::string> &addrs,
+                              uint32_t ttl, uint16_t rcode = 0) {
+    std::string r = query.substr(0, 2);
+    put16(r, 0x8180 | rcode);
+    put16(r, 1);
+    put16(r, static_cast<uint16_t>(addrs.size()));
+    put16(r, 0);
+    put16(r, 0);
+    r.append(query.substr(12));
+    for (const auto &a: addrs) {
+        put16(r, 0xC00C);
+        put16(r, 1);
+        put16(r, 1);
+        put16(r, static_cast<uint16_t>(ttl >> 16));
+        put16(r, static_cast<uint16_t>(ttl & 0xFFFF));
+        put16(r, 4);
+        IPAddress ip;
+        ip.fromString(a.c_str());
+        for (int i = 0; i < 4; ++i) r.push_back(static_cast<char>(ip[i]));
+    }
+    return r;
+}
+
+///run lookup until it is not pending
+static DNS::Status run_lookup(DNS &dns, Modem &modem, const char *host, IPAddress &addr,
+                              TimeStampMs &now, FakeEsp &esp,
+                              const std::vector<std::string> &addrs, uint32_t ttl) {
+    std::size_t answered = esp.sent.size();
+    for (int i = 0; i < 100; ++i) {
+        auto st = dns.lookup(host, addr, now);
+        if (st != DNS::Status::pending) return st;
+        modem.pump(now);
+        while (answered < esp.sent.size()) {
+            esp.inbox.push_back(make_reply(esp.sent[answered].data, addrs, ttl));
+            ++answered;
+        }
+        now += 10;
+    }
+    return DNS::Status::pending;
+}
+
+static void test_cache() {
+    FakeEsp esp;
+    Modem modem(esp);
+    DNS dns(modem);
+    TimeStampMs now = 1000;
+    IPAddress addr;
+    dns.set_servers(IPAddress(10,0,0,1), IPAddress(10,0,0,2));
+    auto st = run_lookup(dns, modem, "pool.ntp.org", addr, now, esp,
+            {"1.1.1.1","2.2.2.2","3.3.3.3"}, 60);
+    CHECK(st == DNS::Status::found);
+    CHECK(addr == IPAddress(1,1,1,1));
+    CHECK_EQUAL(esp.sent.size(), 1U);
+    CHECK_EQUAL(esp.sent[0].server, "10.0.0.1");
+    //repeated lookup costs no traffic
+    unsigned int cmds = esp.commands;
+    for (int i = 0; i < 10; ++i) {
+        CHECK(dns.lookup("pool.ntp.org", addr, now) == DNS::Status::found);
+        modem.pump(now);
+    }
+    CHECK_EQUAL(esp.commands, cmds);
+    //rotation through all addresses
+    CHECK(dns.rotate("pool.ntp.org"));
+    CHECK(dns.lookup("pool.ntp.org", addr, now) == DNS::Status::found);
+    CHECK(addr == IPAddress(2,2,2,2));
+    CHECK(dns.rotate("pool.ntp.org"));
+    CHECK(dns.lookup("pool.ntp.org", addr, now) == DNS::Status::found);
+    CHECK(addr == IPAddress(3,3,3,3));
+    CHECK(!dns.rotate("pool.ntp.org"));
+    //all were tried, host is resolved again
+    st = run_lookup(dns, modem, "pool.ntp.org", addr, now, esp, {"4.4.4.4"}, 60);
+    CHECK(st == DNS::Status::found);
+    CHECK(addr == IPAddress(4,4,4,4));
+    CHECK_EQUAL(esp.sent.size(), 2U);
+    //TTL expires
+    now += 59000;
+    CHECK(dns.lookup("pool.ntp.org", addr, now) == DNS::Status::found);
+    now += 2000;
+    st = run_lookup(dns, modem, "pool.ntp.org", addr, now, esp, {"5.5.5.5"}, 60);
+    CHECK(st == DNS::Status::found);
+    CHECK(addr == IPAddress(5,5,5,5));
+    CHECK_EQUAL(esp.sent.size(), 3U);
+}
+
+static void test_fallback() {
+    FakeEsp esp;
+    Modem modem(esp);
+    DNS dns(modem);
+    TimeStampMs now = 1000;
+    IPAddress addr;
+    dns.set_servers(IPAddress(10,0,0,1), IPAddress(10,0,0,2));
+    //primary doesn't answer
+    for (int i = 0; i < 20; ++i) {
+        CHECK(dns.lookup("example.com", addr, now) == DNS::Status::pending);
+        modem.pump(now);
+        now += 100;
+    }
+    CHECK_EQUAL(esp.sent.size(), 2U);
+    CHECK_EQUAL(esp.sent[1].server, "10.0.0.2");
+    //secondary answers, reply to the query of primary has same id
+    esp.inbox.push_back(make_reply(esp.sent[1].data, {"7.7.7.7"}, 300));
+    auto st = run_lookup(dns, modem, "example.com", addr, now, esp, {}, 0);
+    CHECK(st == DNS::Status::found);
+    CHECK(addr == IPAddress(7,7,7,7));
+    //nobody answers
+    DNS dns2(modem);
+    dns2.set_servers(IPAddress(10,0,0,1), IPAddress(10,0,0,2));
+    DNS::Status s2 = DNS::Status::pending;
+    for (int i = 0; i < 50 && s2 == DNS::Status::pending; ++i) {
+        s2 = dns2.lookup("example.org", addr, now);
+        modem.pump(now);
+        now += 100;
+    }
+    CHECK(s2 == DNS::Status::failed);
+    //no server known
+    DNS dns3(modem);
+    CHECK(dns3.lookup("example.org", addr, now) == DNS::Status::failed);
+}
+
+static void test_concurrent() {
+    FakeEsp esp;
+    Modem modem(esp);
+    DNS dns(modem);
+    TimeStampMs now = 1000;
+    IPAddress a, b;
+    dns.set_servers(IPAddress(10,0,0,1), IPAddress());
+    CHECK(dns.lookup("a.example", a, now) == DNS::Status::pending);
+    CHECK(dns.lookup("b.example", b, now) == DNS::Status::pending);
+    for (int i = 0; i < 20; ++i) {
+        dns.lookup("a.example", a, now);
+        modem.pump(now);
+        now += 10;
+    }
+    //both queries are outstanding
+    CHECK_EQUAL(esp.sent.size(), 2U);
+    CHECK(esp.sent[0].data.substr(0, 2) != esp.sent[1].data.substr(0, 2));
+    //replies in reverse order, NXDOMAIN for the first one
+    esp.inbox.push_back(make_reply(esp.sent[1].data, {"8.8.4.4"}, 100));
+    esp.inbox.push_back(make_reply(esp.sent[0].data, {}, 100, 3));
+    DNS::Status sa = DNS::Status::pending, sb = DNS::Status::pending;
+    for (int i = 0; i < 50 && (sa == DNS::Status::pending || sb == DNS::Status::pending); ++i) {
+        if (sa == DNS::Status::pending) sa = dns.lookup("a.example", a, now);
+        if (sb == DNS::Status::pending) sb = dns.lookup("b.example", b, now);
+        modem.pump(now);
+        now += 10;
+    }
+    CHECK(sa == DNS::Status::failed);
+    CHECK(sb == DNS::Status::found);
+    CHECK(b == IPAddress(8,8,4,4));
+}
+
+static void test_slow_open() {
+    FakeEsp esp;
+    Modem modem(esp);
+    DNS dns(modem);
+    TimeStampMs now = 1000;
+    IPAddress addr;
+    dns.set_servers(IPAddress(10,0,0,1), IPAddress(10,0,0,2));
+    //socket is opened later than the query times out
+    esp.hold_begin = true;
+    while (now < 1000 + DNS::query_timeout + 100) {
+        CHECK(dns.lookup("slow.example", addr, now) == DNS::Status::pending);
+        modem.pump(now);
+        now += 10;
+    }
+    CHECK(esp.sent.empty());
+    esp.release_begin();
+    auto st = run_lookup(dns, modem, "slow.example", addr, now, esp, {"9.9.9.9"}, 60);
+    CHECK(st == DNS::Status::found);
+    CHECK(addr == IPAddress(9,9,9,9));
+    CHECK(!esp.sent.empty());
+}
+
+int main() {
+    test_cache();
+    test_fallback();
+    test_concurrent();
+    test_slow_open();
+    return 0;
+}
@@ -0,0 +1,100 @@
+//Test and benchmark of HMAC with cached midstate
+//
+//Checks SHA256 and HMAC-SHA1/HMAC-SHA256 against RFC test vectors, then
+//measures signing of a token (20 bytes) with the midstate computed from
+//scratch and with the cached midstate
+//
+//usage: test_hmac [bench]
+
+#include "check.h"
+#include <kotel/hmac.h>
+#include <kotel/sha1.h>
+#include <kotel/sha256.h>
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <string>
+
+template<typename Digest>
+static std::string to_hex(const Digest &d) {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string out;
+    for (unsigned char c: d) {
+        out.push_back(digits[c >> 4]);
+        out.push_back(digits[c & 0xF]);
+    }
+    return out;
+}
+
+static void test_vectors() {
+    CHECK_EQUAL(to_hex(SHA256(std::string_view("")).final()),
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    CHECK_EQUAL(to_hex(SHA256(std::string_view("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")).final()),
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    std::string million(1000000, 'a');
+    CHECK_EQUAL(to_hex(SHA256(million).final()),
+            "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+    std::string key1(20, '\x0b');
+    std::string key6(131, '\xaa');
+    std::string key6_sha1(80, '\xaa');
+    const char *data6 = "Test Using Larger Than Block-Size Key - Hash Key First";
+    //RFC 2202
+    CHECK_EQUAL(to_hex(HmacKey<SHA1>(key1).sign("Hi There")),
+            "b617318655057264e28bc0b6fb378c8ef146be00");
+    CHECK_EQUAL(to_hex(HmacKey<SHA1>("Jefe").sign("what do ya want for nothing?")),
+            "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79");
+    CHECK_EQUAL(to_hex(HmacKey<SHA1>(key6_sha1).sign(data6)),
+            "aa4ae5e15272d00e95705637ce8a3b55ed402112");
+    //RFC 4231
+    CHECK_EQUAL(to_hex(HmacKey<SHA256>(key1).sign("Hi There")),
+            "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+    CHECK_EQUAL(to_hex(HmacKey<SHA256>("Jefe").sign("what do ya want for nothing?")),
+            "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+    CHECK_EQUAL(to_hex(HmacKey<SHA256>(key6).sign(data6)),
+            "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+
+    CHECK(digest_equal("abc", "abc"));
+    CHECK(!digest_equal("abc", "abd"));
+    CHECK(!digest_equal("abc", "ab"));
+}
+
+template<typename Fn>
+static double ops_per_sec(unsigned int count, Fn &&fn) {
+    unsigned char sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < count; ++i) sink ^= fn(i);
+    auto end = std::chrono::steady_clock::now();
+    volatile unsigned char keep = sink;
+    (void)keep;
+    return count / std::chrono::duration<double>(end - start).count();
+}
+
+template<typename Hash>
+static void benchmark_hash(const char *name, unsigned int count) {
+    const char secret[20] = "pair secret 0123456";
+    char token[20] = "ABCDEFGHIJKLMNOPQRS";
+    std::string_view key(secret, sizeof(secret));
+    HmacKey<Hash> cached(key);
+    double scratch = ops_per_sec(count, [&](unsigned int i){
+        token[0] = static_cast<char>(i);
+        return HmacKey<Hash>(key).sign(std::string_view(token, sizeof(token)))[0];
+    });
+    double midstate = ops_per_sec(count, [&](unsigned int i){
+        token[0] = static_cast<char>(i);
+        return cached.sign(std::string_view(token, sizeof(token)))[0];
+    });
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << name << ": from scratch " << scratch << " ops/s, cached midstate "
+              << midstate << " ops/s" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    bool full = argc > 1 && std::strcmp(argv[1], "bench") == 0;
+    test_vectors();
+    unsigned int count = full?200000:5000;
+    benchmark_hash<SHA1>("HMAC-SHA1", count);
+    benchmark_hash<SHA256>("HMAC-SHA256", count);
+    return 0;
+}
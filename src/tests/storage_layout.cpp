@@ -0,0 +1,73 @@
+//Test of recognition of the flash layout
+//
+//Older firmware used whole flash for files, the storage converts it to
+//smaller file storage and event log. A log page damaged by power failure
+//must be repaired without the conversion (which erases everything)
+
+#include "check.h"
+#include <kotel/nonv_storage.h>
+
+using namespace kotel;
+
+static DataFlashBlockDevice &flash() {
+    return DataFlashBlockDevice::getInstance();
+}
+
+static void test_legacy_conversion() {
+    flash().erase(0, FLASH_TOTAL_SIZE);
+    {
+        //layout of older firmware, files reach the region of the event log
+        EEPROM<sizeof(StorageSector),file_directory_len> legacy;
+        legacy.begin();
+        Config cfg;
+        cfg.bag_kg = 33;
+        legacy.write_file(file_config, cfg);
+        Tray tray;
+        for (uint32_t i = 0; i < 400; ++i) {
+            tray.tray_open_time = i;
+            legacy.write_file(file_tray, tray);
+        }
+    }
+    Storage st;
+    st.begin();
+    CHECK_EQUAL(st.config.bag_kg, 33);
+    CHECK_EQUAL(st.tray.tray_open_time, 399U);
+    CHECK_EQUAL(st.get_event_log().get_record_count(), 0U);
+    Storage st2;
+    st2.begin();
+    CHECK_EQUAL(st2.config.bag_kg, 33);
+}
+
+static void test_torn_log_page() {
+    constexpr unsigned int per_page = Storage::EventLogType::records_per_page;
+    {
+        Storage st;
+        st.begin();
+        st.config.bag_kg = 44;
+        st.save(st.config);
+        st.commit();
+        for (uint32_t i = 0; i < per_page + 3; ++i) {
+            EventRecord rec;
+            rec.timestamp = 1000 + i;
+            st.log_event(rec);
+        }
+    }
+    //header of the second page of the log was torn by power failure
+    const char zero = 0;
+    flash().program(&zero, file_storage_size + FLASH_BLOCK_SIZE, 1);
+    Storage st;
+    st.begin();
+    //no conversion, files and the first page of the log are kept
+    CHECK_EQUAL(st.config.bag_kg, 44);
+    CHECK_EQUAL(st.get_event_log().get_record_count(), per_page);
+    Storage st2;
+    st2.begin();
+    CHECK_EQUAL(st2.config.bag_kg, 44);
+    CHECK_EQUAL(st2.get_event_log().get_record_count(), per_page);
+}
+
+int main() {
+    test_legacy_conversion();
+    test_torn_log_page();
+    return 0;
+}
@@ -0,0 +1,159 @@
+//Test and benchmark of websocket frame parser
+//
+//Checks that payload unmasked by the word-wise fast path (buffer with
+//alloc_back) matches payload unmasked byte by byte, for any split of
+//the input. Then measures throughput of the parser in MB/s for small
+//control frames and for large payloads
+//
+//usage: test_ws_parser [bench]
+
+#include "check.h"
+#include <kotel/websocket.h>
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+///Fixed buffer with alloc_back (same interface as connection slot of the server)
+class FlatBuffer {
+public:
+    explicit FlatBuffer(std::size_t capacity):_data(capacity) {}
+    void push_back(char c) {
+        if (_size < _data.size()) _data[_size++] = c;
+    }
+    char *alloc_back(std::size_t n) {
+        if (n > _data.size() - _size) return nullptr;
+        char *p = _data.data() + _size;
+        _size += n;
+        return p;
+    }
+    std::size_t size() const {return _size;}
+    void clear() {_size = 0;}
+    const char *data() const {return _data.data();}
+protected:
+    std::vector<char> _data;
+    std::size_t _size = 0;
+};
+
+static_assert(ws::has_alloc_back<FlatBuffer>::value);
+static_assert(!ws::has_alloc_back<std::vector<char> >::value);
+
+static std::string make_frame(const ws::Message &msg, std::uint8_t *mask) {
+    std::string out;
+    ws::build(msg, [&](char c){out.push_back(c);}, mask);
+    return out;
+}
+
+static std::string make_payload(std::size_t sz, std::mt19937 &rnd) {
+    std::string s(sz, 0);
+    for (auto &c: s) c = static_cast<char>(rnd());
+    return s;
+}
+
+///parse stream split to pieces of given size, returns payloads of messages
+template<typename Buffer>
+static std::vector<std::string> parse_stream(Buffer &buffer, std::string_view stream, std::size_t piece) {
+    std::vector<std::string> out;
+    ws::Parser<Buffer> parser(buffer);
+    while (!stream.empty()) {
+        auto p = stream.substr(0, piece);
+        stream = stream.substr(p.size());
+        bool done = parser.push_data(p);
+        while (done) {
+            auto msg = parser.get_message();
+            out.emplace_back(msg.payload);
+            auto unused = parser.get_unused_data();
+            parser.reset();
+            done = !unused.empty() && parser.push_data(unused);
+        }
+    }
+    return out;
+}
+
+static void test_correctness() {
+    std::mt19937 rnd(1);
+    std::vector<std::string> payloads;
+    std::string stream;
+    for (std::size_t sz: {0, 1, 3, 7, 8, 9, 15, 16, 17, 125, 126, 127, 1000, 65535, 65536, 70001}) {
+        payloads.push_back(make_payload(sz, rnd));
+        std::uint8_t mask[4] = {static_cast<std::uint8_t>(rnd()), static_cast<std::uint8_t>(rnd()),
+                                static_cast<std::uint8_t>(rnd()), static_cast<std::uint8_t>(rnd())};
+        stream.append(make_frame(ws::Message{payloads.back(), ws::Type::binary}, mask));
+    }
+    //unmasked frame
+    payloads.push_back("unmasked frame");
+    stream.append(make_frame(ws::Message{payloads.back(), ws::Type::text}, nullptr));
+
+    for (std::size_t piece: {std::size_t(1), std::size_t(2), std::size_t(5), std::size_t(13),
+                             std::size_t(64), std::size_t(1500), stream.size()}) {
+        FlatBuffer fb(1 << 17);
+        std::vector<char> vb;
+        auto fast = parse_stream(fb, stream, piece);
+        auto slow = parse_stream(vb, stream, piece);
+        CHECK_PRINT(fast == payloads, piece);
+        CHECK_PRINT(slow == payloads, piece);
+    }
+    //payload larger than buffer is truncated, not overflowed
+    FlatBuffer small(100);
+    auto r = parse_stream(small, make_frame(ws::Message{payloads[12], ws::Type::binary}, nullptr), 4096);
+    CHECK_EQUAL(r.size(), 1U);
+    CHECK_EQUAL(r[0], payloads[12].substr(0, 100));
+}
+
+template<typename Buffer>
+static double measure(Buffer &buffer, const std::string &stream, unsigned int repeat) {
+    ws::Parser<Buffer> parser(buffer);
+    std::size_t messages = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < repeat; ++i) {
+        std::string_view data = stream;
+        while (parser.push_data(data)) {
+            ++messages;
+            data = parser.get_unused_data();
+            parser.reset();
+            if (data.empty()) break;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double sec = std::chrono::duration<double>(end - start).count();
+    CHECK(messages > 0);
+    return static_cast<double>(stream.size()) * repeat / sec / 1e6;
+}
+
+static void benchmark(bool full) {
+    std::mt19937 rnd(2);
+    std::uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+    std::string control;
+    while (control.size() < 64*1024) {
+        control.append(make_frame(ws::Message{"ping", ws::Type::ping}, mask));
+    }
+    std::string large;
+    auto payload = make_payload(16384, rnd);
+    for (int i = 0; i < 4; ++i) {
+        large.append(make_frame(ws::Message{payload, ws::Type::binary}, mask));
+    }
+    unsigned int repeat = full?2000:50;
+
+    FlatBuffer fb(1 << 15);
+    std::vector<char> vb;
+    vb.reserve(1 << 15);
+    double control_fast = measure(fb, control, repeat);
+    double control_bytes = measure(vb, control, repeat);
+    double large_fast = measure(fb, large, repeat);
+    double large_bytes = measure(vb, large, repeat);
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "control frames (10 B): fast " << control_fast
+              << " MB/s, byte-wise " << control_bytes << " MB/s" << std::endl;
+    std::cout << "large payload (16 KB): fast " << large_fast
+              << " MB/s, byte-wise " << large_bytes << " MB/s" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    bool full = argc > 1 && std::strcmp(argv[1], "bench") == 0;
+    test_correctness();
+    benchmark(full);
+    return 0;
+}
@@ -21,6 +21,7 @@ const StatusOutWs = [
     ["uint8", "pump"],
     ["uint8", "feeder"],
     ["uint8", "fan"],
+    ["uint8", "storage_pending"],
 ];
 
 const ManualControlWs = [
@@ -71,6 +72,36 @@ const StatsOutWs = [
     ["uint32", "consumed_kg"],
     ["uint32", "consumed_kg_total"],
     ["uint32", "eeprom_errors"],
-    ["uint32", "uptime"]
+    ["uint32", "uptime"],
+    ["uint32", "flash_logical_writes"],
+    ["uint32", "flash_physical_writes"],
+    ["uint32", "flash_erases_0"],
+    ["uint32", "flash_erases_1"],
+    ["uint32", "flash_erases_2"],
+    ["uint32", "flash_erases_3"],
+    ["uint32", "flash_erases_4"],
+    ["uint32", "flash_erases_5"],
+    ["uint32", "flash_file_writes_0"],
+    ["uint32", "flash_file_writes_1"],
+    ["uint32", "flash_file_writes_2"],
+    ["uint32", "flash_file_writes_3"],
+    ["uint32", "flash_file_writes_4"],
+    ["uint32", "flash_file_writes_5"],
+    ["uint32", "flash_file_writes_6"],
+    ["uint32", "flash_file_writes_7"],
+    ["uint32", "flash_file_writes_8"],
+    ["uint32", "flash_file_writes_9"],
+    ["uint32", "flash_file_writes_10"]
 
 ];
+
+const EventRecordWs = [
+    ["uint32", "timestamp"],
+    ["uint8", "type"],
+    ["uint8", "mode"],
+    ["int16", "temp_output"],
+    ["int16", "temp_input"],
+    ["uint16", "arg"]
+];
+
+const EventRecordSize = 12;
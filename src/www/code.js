@@ -52,23 +52,38 @@ let Controller = {
             } else {
                 req.force_pump = 255;
             }
-            let data = await connection.send_request("c", encodeBinaryFrame(ManualControlWs, req));
-            let out = decodeBinaryFrame(StatusOutWs, data);
-            if (out.temp_output_value < -10000) delete out.temp_output_value;
-            else out.temp_output_value = out.temp_output_value * 0.1;
-            if (out.temp_input_value < -10000) delete out.temp_input_value;
-            else out.temp_input_value = out.temp_input_value * 0.1;
-            out.temp_output_amp_value = out.temp_output_amp_value * 0.1;
-            out.temp_input_amp_value = out.temp_input_amp_value * 0.1;
-            out.time = new Date(Number(out.timestamp)*1000);
-            this.status = out;
-            this.on_status_update(out);
+            //status is broadcasted by the server, ask only to send a command
+            if (!this.subscribed || Object.values(req).some(x => x != 255)) {
+                let data = await connection.send_request("c", encodeBinaryFrame(ManualControlWs, req));
+                this.process_status(data);
+            }
         } catch (e) {
             this.on_error("status", e);
         }
         this._status_timer = setTimeout(this.update_status_cycle.bind(this), 1000);
     },
 
+    subscribed: false,
+
+    process_status: function(data) {
+        let out = decodeBinaryFrame(StatusOutWs, data);
+        if (out.temp_output_value < -10000) delete out.temp_output_value;
+        else out.temp_output_value = out.temp_output_value * 0.1;
+        if (out.temp_input_value < -10000) delete out.temp_input_value;
+        else out.temp_input_value = out.temp_input_value * 0.1;
+        out.temp_output_amp_value = out.temp_output_amp_value * 0.1;
+        out.temp_input_amp_value = out.temp_input_amp_value * 0.1;
+        out.time = new Date(Number(out.timestamp)*1000);
+        this.status = out;
+        this.on_status_update(out);
+    },
+
+    subscribe_status: async function() {
+        this.subscribed = false;
+        let resp = new Uint8Array(await connection.send_request("s", [1]));
+        this.subscribed = resp.length > 0 && resp[0] == 0;
+    },
+
     update_stats_cycle: async function() {
         if (this._stat_timer) killTimer(this._stat_timer);
         try {
@@ -81,6 +96,28 @@ let Controller = {
         this._stats_timer = setTimeout(this.update_stats_cycle.bind(this), 30000);
     },
 
+    read_events: async function(since) {
+        const req = new ArrayBuffer(4);
+        new DataView(req).setUint32(0, since, true);
+        while (true) {
+            const resp = await connection.send_request("E", req);
+            //busy: the log is being sent to other client
+            if (new Uint8Array(resp)[0]) {
+                await delay(500);
+                continue;
+            }
+            let out = [];
+            for (let ofs = 1; ofs + EventRecordSize <= resp.byteLength; ofs += EventRecordSize) {
+                const rec = decodeBinaryFrame(EventRecordWs, resp.slice(ofs, ofs + EventRecordSize));
+                rec.temp_output = rec.temp_output * 0.1;
+                rec.temp_input = rec.temp_input * 0.1;
+                rec.time = new Date(rec.timestamp * 1000);
+                out.push(rec);
+            }
+            return out;
+        }
+    },
+
     read_config: async function() {
         while (true) {
             try {
@@ -224,12 +261,11 @@ async function nastav_teplomer(field) {
     btn[0].disabled = true;
     let list = win.getElementsByClassName("list")[0];
     list.innerHTML = "";
-    let resp = await fetch("/api/scan_temp", {
-        method: "post"
-    });
+    //the scan completes later, other requests are served meanwhile
+    let resp = await connection.send_request("D").catch(() => null);
     let selected = "";
-    if (resp.ok) {
-        resp = parse_response(await resp.text());
+    if (resp !== null) {
+        resp = parse_response(resp);
         Object.keys(resp).forEach(addr => {
             let temp = resp[addr];
             let sp = document.createElement("span");
@@ -812,6 +848,8 @@ async function main() {
         data["feeder_avg"] = data["feeder_time"]/data["feeder_start_count"];
         data["consumed_kg_avg"] = data["consumed_kg_total"]/(data["active_time"]/day_seconds);
         data["other_failure_count"] = data["stop_count"] - data["overheat_count"] - data["feeder_overheat_count"] -data["temp_read_failure_count"];        
+        data["flash_erases_max"] = Math.max(...Object.keys(data).filter(k=>k.startsWith("flash_erases_")).map(k=>data[k]));
+        data["flash_write_ampl"] = data["flash_physical_writes"]*100/data["flash_logical_writes"];
 
         Array.prototype.forEach.call(stattbl.getElementsByTagName("td"),(el)=>{
              if (el.dataset.name) {
@@ -839,7 +877,12 @@ async function main() {
     }
 
     
+    connection.onpush = function(selector, data) {
+        if (selector == 0x62) Controller.process_status(data);   //'b' - status broadcast
+    };
+
     connection.onconnect = async function() {
+        Controller.subscribe_status().catch(e => Controller.on_error("subscribe", e));
         Controller.read_config();
         let data = await connection.send_request(6, {});
         ids["ssid"].textContent = parseTextSector(data);
@@ -0,0 +1,72 @@
+#Builds web assets for embedding
+#
+# -DSRC=<source directory>
+# -DOUT=<output directory>
+# -DENTRY=<entry script, its directives refer the other sources>
+#
+#Sources are found by web_sources.cmake. Directives are removed from every
+#script and style, the rest is kept as is (whitespace can be part of
+#a string, indentation is cheap after compression). index.html is composed
+#from @head and @html fragments and it refers the other assets. References
+#carry hash of the content (?v=), so assets can be cached for long time.
+#Every asset is compressed to <name>.gz.base64
+
+include(${CMAKE_CURRENT_LIST_DIR}/web_sources.cmake)
+web_sources(${SRC} ${ENTRY} WEB)
+
+file(MAKE_DIRECTORY ${OUT})
+
+function(pack_file NAME PREFIX)
+    file(READ ${SRC}/${NAME} CONTENT)
+    #directives occupy whole lines
+    string(REGEX REPLACE "^//@[^\n]*\n" "" CONTENT "${CONTENT}")
+    string(REGEX REPLACE "\n//@[^\n]*" "" CONTENT "${CONTENT}")
+    file(WRITE ${OUT}/${NAME} "${PREFIX}${CONTENT}")
+endfunction()
+
+function(asset_ref NAME VAR)
+    file(SHA1 ${OUT}/${NAME} HASH)
+    string(SUBSTRING ${HASH} 0 8 HASH)
+    set(${VAR} "${NAME}?v=${HASH}" PARENT_SCOPE)
+endfunction()
+
+function(compress_file NAME)
+    execute_process(COMMAND gzip -cn --best ${OUT}/${NAME}
+                    COMMAND base64 -w 0
+                    OUTPUT_FILE ${OUT}/${NAME}.gz.base64
+                    RESULT_VARIABLE RES)
+    if(RES)
+        message(FATAL_ERROR "Failed to compress ${NAME}")
+    endif()
+endfunction()
+
+set(HEAD_REFS "")
+foreach(STYLE ${WEB_STYLES})
+    pack_file(${STYLE} "")
+    asset_ref(${STYLE} REF)
+    string(APPEND HEAD_REFS "<link rel=\"stylesheet\" type=\"text/css\" href=\"${REF}\" />\n")
+endforeach()
+
+set(BODY_REFS "")
+foreach(SCRIPT ${WEB_SCRIPTS})
+    pack_file(${SCRIPT} "\"use strict\";\n")
+    asset_ref(${SCRIPT} REF)
+    string(APPEND BODY_REFS "<script type=\"text/javascript\" src=\"${REF}\"></script>")
+endforeach()
+
+set(HEAD "")
+foreach(NAME ${WEB_HEAD})
+    file(READ ${SRC}/${NAME} CONTENT)
+    string(APPEND HEAD "${CONTENT}")
+endforeach()
+set(BODY "")
+foreach(NAME ${WEB_BODY})
+    file(READ ${SRC}/${NAME} CONTENT)
+    string(APPEND BODY "${CONTENT}")
+endforeach()
+file(WRITE ${OUT}/index.html
+    "<!DOCTYPE html><HTML><HEAD><META charset=\"UTF-8\" />${HEAD}${HEAD_REFS}</HEAD><BODY>${BODY}${BODY_REFS}</BODY></HTML>")
+
+foreach(NAME index.html ${WEB_STYLES} ${WEB_SCRIPTS})
+    compress_file(${NAME})
+endforeach()
@@ -0,0 +1,54 @@
+#Finds sources of the web page by directives of spamake
+#
+# //@require <script>   required script is loaded before the script
+# //@style <stylesheet>
+# //@head <fragment>     content of <HEAD>
+# //@html <fragment>     content of <BODY>
+#
+#web_sources(<dir> <entry> <prefix>) starts at the entry script and sets
+#<prefix>_SCRIPTS (in order of loading), <prefix>_STYLES, <prefix>_HEAD
+#and <prefix>_BODY. The order of scripts is the same as spamake uses,
+#required scripts first, every script once
+
+function(web_sources_visit DIR NAME)
+    get_property(VISITED GLOBAL PROPERTY WEB_SOURCES_VISITED)
+    list(FIND VISITED ${NAME} IDX)
+    if(NOT IDX EQUAL -1)
+        return()
+    endif()
+    set_property(GLOBAL APPEND PROPERTY WEB_SOURCES_VISITED ${NAME})
+    file(STRINGS ${DIR}/${NAME} LINES REGEX "^//@")
+    foreach(LINE ${LINES})
+        if(NOT LINE MATCHES "^//@([a-z]+)[ \t]+([^ \t\r]+)")
+            message(FATAL_ERROR "${NAME}: invalid directive: ${LINE}")
+        endif()
+        set(KIND ${CMAKE_MATCH_1})
+        set(FILE ${CMAKE_MATCH_2})
+        if(KIND STREQUAL "require")
+            web_sources_visit(${DIR} ${FILE})
+        elseif(KIND STREQUAL "style")
+            set_property(GLOBAL APPEND PROPERTY WEB_SOURCES_STYLES ${FILE})
+        elseif(KIND STREQUAL "head")
+            set_property(GLOBAL APPEND PROPERTY WEB_SOURCES_HEAD ${FILE})
+        elseif(KIND STREQUAL "html")
+            set_property(GLOBAL APPEND PROPERTY WEB_SOURCES_BODY ${FILE})
+        else()
+            message(FATAL_ERROR "${NAME}: unknown directive: ${LINE}")
+        endif()
+    endforeach()
+    set_property(GLOBAL APPEND PROPERTY WEB_SOURCES_SCRIPTS ${NAME})
+endfunction()
+
+function(web_sources DIR ENTRY PREFIX)
+    foreach(KIND VISITED SCRIPTS STYLES HEAD BODY)
+        set_property(GLOBAL PROPERTY WEB_SOURCES_${KIND} "")
+    endforeach()
+    web_sources_visit(${DIR} ${ENTRY})
+    foreach(KIND SCRIPTS STYLES HEAD BODY)
+        get_property(LIST GLOBAL PROPERTY WEB_SOURCES_${KIND})
+        if(LIST)
+            list(REMOVE_DUPLICATES LIST)
+        endif()
+        set(${PREFIX}_${KIND} ${LIST} PARENT_SCOPE)
+    endforeach()
+endfunction()
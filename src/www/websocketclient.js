@@ -3,14 +3,17 @@ class WebSocketExchange {
     #timeout=10000;
     #ws = null;
     #tosend = [];
-    #promises = {};
+    //pending requests by request id
+    #promises = new Map();
+    #next_id = 0;
+    #max_inflight = 4;
     #enc = new TextEncoder();
     #pingtm = -1;
     #token = "";
-    #ip = false;
     #opentm = null;
     onconnect = function() { };
     ontokenreq = function() {return "";};
+    onpush = function(selector, data) { };
 
     constructor() {
         this.#token = localStorage["token"];
@@ -37,23 +40,27 @@ class WebSocketExchange {
             } else {
                 content = new Uint8Array(content);
             }
-            let selector = cmd[0];
-            var mergedArray = new Uint8Array(cmd.length + content.length);
-            mergedArray.set(cmd, 0);
-            mergedArray.set(content, cmd.length);
-            if (!this.#promises[selector]) {
-                this.#promises[selector] = [];
-            }
-            this.#promises[selector].push([ok, err]);
-            this.#tosend.push(mergedArray);
+            //request id (1-127, valid in text frames) matches the reply,
+            //so replies can arrive in any order
+            do {
+                this.#next_id = (this.#next_id % 127) + 1;
+            } while (this.#promises.has(this.#next_id));
+            let id = this.#next_id;
+            var mergedArray = new Uint8Array(cmd.length + content.length + 2);
+            mergedArray.set([0x40, id], 0);
+            mergedArray.set(cmd, 2);
+            mergedArray.set(content, cmd.length + 2);
+            this.#promises.set(id, [ok, err, false]);
+            this.#tosend.push([id, mergedArray]);
             this.flush();
         });
     }
 
     reconnect(err) {
         if (this.#ws) {
-            Object.keys(this.#promises).forEach(x => this.#promises[x].forEach(z => z[1](err)));
-            this.#promises = {};
+            this.#promises.forEach(z => z[1](err));
+            this.#promises.clear();
+            this.#tosend = [];
             this.#ws.close();
             this.#ws = null;
             clearTimeout(this.#pingtm);
@@ -96,23 +103,26 @@ class WebSocketExchange {
             this.#ws.onmessage = (ev) => {
                 this.reset_timeout();
                 let data = ev.data;
-                let selector;
-                if (typeof data == "string") {
-                    selector = this.#enc.encode(data)[0];
-                    data = data.substr(1);
-                } else {
-                    data = new Uint8Array(data);
-                    selector = data[0];
-                    data = data.slice(1).buffer;
-
+                let id = 0;
+                let bytes = typeof data == "string"?this.#enc.encode(data.substr(0, 3)):new Uint8Array(data);
+                if (bytes[0] == 0x40 && bytes.length > 2) {
+                    //reply with request id
+                    id = bytes[1];
+                    bytes = bytes.subarray(2);
+                    if (typeof data == "string") data = data.substr(2);
                 }
-                let p = this.#promises[selector];
-                if (p && p.length) {
-                    let q = p.shift();
-                    q[0](data);
+                let selector = bytes[0];
+                if (typeof data == "string") data = data.substr(1);
+                else data = bytes.slice(1).buffer;
+                let p = id && this.#promises.get(id);
+                if (p) {
+                    this.#promises.delete(id);
+                    p[0](data);
+                    this.flush();
+                } else {
+                    //message pushed by the server (broadcast)
+                    this.onpush(selector, data);
                 }
-                this.#ip = false;
-                this.flush();
             };
             this.#opentm = setTimeout(()=>{
                 this.#ws.close();                
@@ -120,16 +130,21 @@ class WebSocketExchange {
             },this.#timeout);
             this.#ws.onopen = () => {
                 this.#clearopentm();
-                this.#ip = false;
                 this.onconnect();
                 this.flush();
             }
-        } else if (this.#ws.readyState == WebSocket.OPEN && !this.#ip) {
-            if (this.#tosend.length) {
-                let x = this.#tosend.shift();
+        } else if (this.#ws.readyState == WebSocket.OPEN) {
+            //limited count of requests in flight, the server has small buffers
+            let inflight = 0;
+            this.#promises.forEach(z => inflight += z[2]?1:0);
+            while (this.#tosend.length && inflight < this.#max_inflight) {
+                let [id, x] = this.#tosend.shift();
+                let p = this.#promises.get(id);
+                if (!p) continue;
+                p[2] = true;
                 this.#ws.send(x);
-                this.#ip = true;
-            }        
+                ++inflight;
+            }
         }
     }
 